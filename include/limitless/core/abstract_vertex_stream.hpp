@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limitless/util/bounding_box.hpp>
+
 namespace Limitless {
     enum class VertexStreamUsage {
         Static,
@@ -28,5 +30,8 @@ namespace Limitless {
 
         virtual void draw_instanced(std::size_t count) noexcept = 0;
         virtual void draw_instanced(VertexStreamDraw draw, std::size_t count) noexcept = 0;
+
+        // bounds of vertex positions in model space
+        [[nodiscard]] virtual BoundingBox calculateBounds() const { return {}; }
     };
 }
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <limitless/core/vertex_stream.hpp>
 
 namespace Limitless {
@@ -41,11 +43,42 @@ namespace Limitless {
             initialize();
         }
 
+        // copy of shared stream gets its own buffers
+        IndexedVertexStream(const IndexedVertexStream& rhs)
+            : VertexStream<Vertex>(rhs)
+            , indices {rhs.indices}
+            , indices_buffer {rhs.indices_buffer} {
+            if (rhs.shared) {
+                initialize();
+            }
+        }
+
+        IndexedVertexStream(IndexedVertexStream&&) noexcept = default;
+
+        void share(SharedStreamRange range) override {
+            VertexStream<Vertex>::share(std::move(range));
+            indices_buffer.reset();
+        }
+
+        void unshare() override {
+            if (!this->shared) {
+                return;
+            }
+
+            VertexStream<Vertex>::unshare();
+            initialize();
+        }
+
         void draw(VertexStreamDraw draw_mode) noexcept override {
             if (this->stream.empty()) {
                 return;
             }
 
+            if (this->shared) {
+                this->drawShared(draw_mode, 1);
+                return;
+            }
+
             this->vertex_array.bind();
 
             glDrawElements(static_cast<GLenum>(draw_mode), (GLsizei)indices.size(), GL_UNSIGNED_INT, nullptr);
@@ -61,6 +94,11 @@ namespace Limitless {
                 return;
             }
 
+            if (this->shared) {
+                this->drawShared(mode, count);
+                return;
+            }
+
             this->vertex_array.bind();
 
             glDrawElementsInstanced(static_cast<GLenum>(mode), (GLsizei)indices.size(), GL_UNSIGNED_INT, nullptr, (GLsizei)count);
@@ -70,6 +108,8 @@ namespace Limitless {
         }
 
         void map() {
+            this->unshare();
+
             const auto size = indices.size() * sizeof(index_type);
 
             if (size > indices_buffer->getSize()) {
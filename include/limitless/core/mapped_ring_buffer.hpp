@@ -0,0 +1,88 @@
+#pragma once
+
+#include <limitless/core/buffer_builder.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+
+namespace Limitless {
+    static constexpr auto MAPPED_RING_BUFFER_REGIONS = 3;
+
+    /*
+     * Triple buffered, persistently mapped storage that CPU writes once per frame
+     *
+     * data is written straight into mapped memory of current region;
+     * region is fenced when the next one is mapped, i.e. after every pass that reads it is submitted,
+     * and is written again two frames later, so CPU does not wait for GPU in steady state
+     */
+    template<typename T>
+    class MappedRingBuffer final {
+    private:
+        struct Region {
+            std::shared_ptr<Buffer> buffer;
+            T* data {};
+        };
+
+        std::array<Region, MAPPED_RING_BUFFER_REGIONS> regions;
+        Buffer::Type target;
+        size_t capacity {};
+        size_t current {};
+        // current region was written and should be fenced before moving on
+        bool written {};
+
+        void allocate(size_t _capacity) {
+            capacity = _capacity;
+
+            for (auto& region : regions) {
+                BufferBuilder builder;
+                region.buffer = builder.setTarget(target)
+                        .setUsage(Buffer::Storage::DynamicCoherentWrite)
+                        .setAccess(Buffer::ImmutableAccess::WriteCoherent)
+                        .setDataSize(sizeof(T) * capacity)
+                        .build();
+
+                // immutable coherent storage is mapped once on creation
+                region.data = static_cast<T*>(region.buffer->mapBufferRange(0, sizeof(T) * capacity));
+            }
+        }
+    public:
+        explicit MappedRingBuffer(Buffer::Type _target, size_t _capacity = 1)
+            : target {_target} {
+            allocate(std::max<size_t>(_capacity, 1));
+        }
+
+        MappedRingBuffer(const MappedRingBuffer&) = delete;
+        MappedRingBuffer& operator=(const MappedRingBuffer&) = delete;
+
+        /*
+         * returns memory of next region that fits count elements
+         *
+         * storage grows if needed, then buffers of all regions are replaced; pointer is valid until next call
+         */
+        T* map(size_t count) {
+            if (written) {
+                regions[current].buffer->fence();
+                current = (current + 1) % regions.size();
+            }
+            written = true;
+
+            if (count > capacity) {
+                allocate(std::max(count, capacity * 2));
+            }
+
+            auto& region = regions[current];
+            region.buffer->waitFence();
+
+            return region.data;
+        }
+
+        [[nodiscard]] size_t getCapacity() const noexcept { return capacity; }
+
+        // region returned by the last map
+        [[nodiscard]] size_t getRegion() const noexcept { return current; }
+
+        [[nodiscard]] const std::shared_ptr<Buffer>& getBuffer() const noexcept { return regions[current].buffer; }
+        [[nodiscard]] const std::shared_ptr<Buffer>& getBuffer(size_t region) const noexcept { return regions[region].buffer; }
+    };
+}
@@ -4,7 +4,17 @@
 #include <limitless/core/buffer_builder.hpp>
 #include <limitless/core/abstract_vertex_stream.hpp>
 
+#include <optional>
+
 namespace Limitless {
+    // range of index and vertex buffers shared between static streams, see StaticGeometry
+    struct SharedStreamRange {
+        std::shared_ptr<VertexArray> vertex_array;
+        uint32_t first_index {};
+        uint32_t index_count {};
+        int32_t base_vertex {};
+    };
+
     template <typename Vertex>
     class VertexStream : public AbstractVertexStream {
     protected:
@@ -13,6 +23,15 @@ namespace Limitless {
         std::vector<Vertex> stream;
         VertexStreamUsage usage;
         VertexStreamDraw mode;
+        // set while stream is drawn from shared buffers, own buffers are released then
+        std::optional<SharedStreamRange> shared;
+
+        void drawShared(VertexStreamDraw draw_mode, std::size_t count) const noexcept {
+            shared->vertex_array->bind();
+
+            const auto* offset = reinterpret_cast<const void*>(shared->first_index * sizeof(uint32_t));
+            glDrawElementsInstancedBaseVertex(static_cast<GLenum>(draw_mode), (GLsizei)shared->index_count, GL_UNSIGNED_INT, offset, (GLsizei)count, shared->base_vertex);
+        }
 
         void initialize(size_t count) {
             BufferBuilder builder;
@@ -58,12 +77,16 @@ namespace Limitless {
 
         ~VertexStream() override = default;
 
+        // copy of shared stream gets its own buffers
         VertexStream(const VertexStream& rhs)
-            : vertex_buffer {rhs.vertex_buffer->clone()}
+            : vertex_buffer {rhs.vertex_buffer ? rhs.vertex_buffer->clone() : nullptr}
             , vertex_array {rhs.vertex_array}
             , stream {rhs.stream}
             , usage {rhs.usage}
             , mode {rhs.mode} {
+            if (rhs.shared) {
+                initialize(stream.size());
+            }
         }
 
         VertexStream(VertexStream&&) noexcept = default;
@@ -75,8 +98,39 @@ namespace Limitless {
 
         auto& getVertices() noexcept { return stream; }
         const auto& getVertices() const noexcept { return stream; }
+        [[nodiscard]] auto getDrawMode() const noexcept { return mode; }
+        [[nodiscard]] auto getUsage() const noexcept { return usage; }
 
+        [[nodiscard]] BoundingBox calculateBounds() const override {
+            return Limitless::calculateBoundingBox(stream);
+        }
+
+        /*
+         * makes stream draw range of shared buffers and releases its own ones
+         *
+         * vertices are kept on CPU, so own buffers can be restored by unshare
+         */
+        virtual void share(SharedStreamRange range) {
+            shared = std::move(range);
+            vertex_buffer.reset();
+            vertex_array = VertexArray{};
+        }
+
+        virtual void unshare() {
+            if (!shared) {
+                return;
+            }
+
+            shared.reset();
+            initialize(stream.size());
+        }
+
+        [[nodiscard]] bool isShared() const noexcept { return shared.has_value(); }
+
+        // stream moved to shared buffers gets own ones back, so owner of shared buffers uploads it again
         void map() {
+            unshare();
+
             const auto size = stream.size() * sizeof(Vertex);
 
             if (size > vertex_buffer->getSize()) {
@@ -99,6 +153,11 @@ namespace Limitless {
                 return;
             }
 
+            if (shared) {
+                drawShared(draw_mode, 1);
+                return;
+            }
+
             vertex_array.bind();
 
             glDrawArrays(static_cast<GLenum>(draw_mode), 0, (GLsizei)stream.size());
@@ -111,6 +170,11 @@ namespace Limitless {
                 return;
             }
 
+            if (shared) {
+                drawShared(draw_mode, count);
+                return;
+            }
+
             vertex_array.bind();
 
             glDrawArraysInstanced(static_cast<GLenum>(draw_mode), 0, (GLsizei)stream.size(), (GLsizei)count);
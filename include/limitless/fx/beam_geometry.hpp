@@ -0,0 +1,52 @@
+#pragma once
+
+#include <limitless/util/random.hpp>
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/*
+ * CPU side geometry of beam particles
+ *
+ * beam is a lightning line from particle position to its target,
+ * expanded to camera facing strip of quads in screen space
+ */
+namespace Limitless::fx {
+    // line has at most 2^MAX_BEAM_LEVELS segments
+    static constexpr size_t MAX_BEAM_LEVELS = 10;
+
+    // camera dependent state; computed once per frame and shared by all beams
+    struct BeamFrame {
+        glm::mat4 view_projection;
+        glm::mat4 inverse_view_projection;
+        glm::vec2 resolution;
+
+        BeamFrame(const glm::mat4& projection, const glm::mat4& view, const glm::vec2& resolution) noexcept;
+    };
+
+    struct BeamVertex {
+        glm::vec4 position;
+        glm::vec2 uv;
+    };
+
+    /*
+     * generates line from source to target with iterative midpoint displacement
+     *
+     * every level displaces segment midpoints by up to displacement and halves it,
+     * subdivision stops once displacement drops below offset;
+     * points are produced in order and line is padded for miters as [last, points..., first]
+     */
+    void generateBeamLine(std::vector<glm::vec3>& line, const glm::vec3& source, const glm::vec3& target, float displacement, float offset, Xoshiro128& generator);
+
+    // vertex count of strip generated from padded line
+    [[nodiscard]] constexpr size_t getBeamVertexCount(size_t line_size) noexcept {
+        return line_size > 3 ? 6 * (line_size - 3) : 0;
+    }
+
+    /*
+     * expands padded line to strip of six vertices per segment
+     *
+     * every point is projected once; screen is scratch buffer, vertices should fit getBeamVertexCount(line.size())
+     */
+    void generateBeamVertices(const BeamFrame& frame, const std::vector<glm::vec3>& line, float size, std::vector<glm::vec4>& screen, BeamVertex* vertices);
+}
@@ -26,12 +26,12 @@ namespace Limitless::fx {
     private:
         std::map<UniqueEmitterRenderer, std::unique_ptr<AbstractEmitterRenderer>> renderers;
 
-        void updateRenderers(const Instances& instances) noexcept;
         static void visitEmitters(const Instances& instances, EmitterVisitor& visitor) noexcept;
     public:
         explicit EffectRenderer(Context& context) noexcept;
         ~EffectRenderer() = default;
 
+        // buckets emitters of effects in flat list (with attachments) by renderer and packs their particles to GPU
         void update(const Instances& instances);
         void draw(Context& ctx, const Assets& assets, ShaderPass shader, ms::Blending blending, const UniformSetter& setter);
     };
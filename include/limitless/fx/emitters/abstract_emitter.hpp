@@ -47,7 +47,8 @@ namespace Limitless::fx {
         virtual void ressurect() noexcept = 0;
 
         [[nodiscard]] virtual AbstractEmitter* clone() const = 0;
-        virtual void update(Context& ctx, const Camera& camera) = 0;
+        // advances emitter simulation by dt seconds
+        virtual void update(Context& ctx, const Camera& camera, float dt) = 0;
         virtual void accept(EmitterVisitor& visitor) noexcept = 0;
 
         virtual bool& getLocalSpace() noexcept = 0;
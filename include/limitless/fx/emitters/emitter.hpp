@@ -2,7 +2,7 @@
 
 #include <limitless/fx/emitters/abstract_emitter.hpp>
 #include <limitless/fx/emitters/emitter_spawn.hpp>
-#include <limitless/fx/particle.hpp>
+#include <limitless/fx/particle_storage.hpp>
 
 #include <glm/gtx/quaternion.hpp>
 
@@ -28,7 +28,9 @@ namespace Limitless::fx {
     protected:
         // emitter modules determine particles appearance and behavior
         EmitterModules<Particle> modules;
-        std::vector<Particle> particles;
+        ParticleStorage<Particle> particles;
+        // reused between updates to track particles moved by kill
+        ParticleRemap remap;
 
         // local position of emitter
         glm::vec3 local_position {0.0f};
@@ -47,8 +49,8 @@ namespace Limitless::fx {
         // emitter duration in seconds; 0 for infinity
         std::chrono::duration<float> duration {0.0f};
 
-        std::chrono::time_point<std::chrono::steady_clock> start_time {};
-        std::chrono::time_point<std::chrono::steady_clock> last_time {};
+        // simulation time since emitter started
+        std::chrono::duration<float> time {0.0f};
 
         bool done {false};
 
@@ -79,7 +81,7 @@ namespace Limitless::fx {
         [[nodiscard]] UniqueEmitterRenderer getUniqueRendererType() const noexcept override { return { type, std::nullopt, nullptr }; }
 
         [[nodiscard]] Emitter* clone() const override;
-        void update(Context& ctx, const Camera& camera) override;
+        void update(Context& ctx, const Camera& camera, float dt) override;
         void accept(EmitterVisitor& visitor) noexcept override;
 
         bool& getLocalSpace() noexcept override;
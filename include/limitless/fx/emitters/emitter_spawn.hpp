@@ -21,8 +21,8 @@ namespace Limitless::fx {
         // time in seconds between bursts for burst mode
         float spawn_rate {1.0f};
 
-        // last time emitted
-        std::chrono::time_point<std::chrono::steady_clock> last_spawn {};
+        // emitter simulation time of last emit; empty if nothing has been emitted yet
+        std::optional<std::chrono::duration<float>> last_spawn {};
 
         struct Burst {
             // particles count for 1 burst
@@ -39,7 +39,6 @@ namespace Limitless::fx {
 
         [[nodiscard]] MeshEmitter* clone() const override;
 
-        void update(Context& context, const Camera& camera) override;
         void accept(EmitterVisitor& visitor) noexcept override;
     };
 }
\ No newline at end of file
@@ -1,45 +1,50 @@
 #pragma once
 
 #include <limitless/fx/emitters/emitter_visitor.hpp>
+#include <limitless/fx/renderers/sprite_emitter_renderer.hpp>
+#include <limitless/fx/renderers/mesh_emitter_renderer.hpp>
+#include <limitless/fx/renderers/beam_emitter_renderer.hpp>
 #include <limitless/fx/emitters/sprite_emitter.hpp>
 #include <limitless/fx/emitters/mesh_emitter.hpp>
 #include <limitless/fx/emitters/beam_emitter.hpp>
 
+#include <map>
+
 namespace Limitless::fx {
-    template<typename Particle>
-    class ParticleCollector : public EmitterVisitor {
+    /*
+     * buckets emitters by renderer they are drawn with in one traversal
+     *
+     * renderer is created on first emitter that needs it
+     */
+    class EmitterCollector : public EmitterVisitor {
     private:
-        std::vector<Particle> particles;
-        const UniqueEmitterRenderer& emitter_type;
+        std::map<UniqueEmitterRenderer, std::unique_ptr<AbstractEmitterRenderer>>& renderers;
+
+        template<typename Particle, typename Emitter>
+        void collect(const Emitter& emitter) {
+            auto type = emitter.getUniqueRendererType();
+            auto it = renderers.find(type);
+            if (it == renderers.end()) {
+                type.material = std::make_shared<ms::Material>(*type.material);
+                it = renderers.emplace(type, new EmitterRenderer<Particle>(emitter)).first;
+            }
+            it->second->emitters.emplace_back(&emitter);
+        }
     public:
-        explicit ParticleCollector(const UniqueEmitterRenderer& _emitter_type) noexcept
-            : emitter_type {_emitter_type} {}
-        ~ParticleCollector() override = default;
+        explicit EmitterCollector(decltype(renderers) _renderers) noexcept
+            : renderers {_renderers} {}
+        ~EmitterCollector() override = default;
 
         void visit(const SpriteEmitter& emitter) noexcept override {
-            if constexpr (std::is_same_v<Particle, SpriteParticle>) {
-                if (emitter_type == emitter.getUniqueRendererType()) {
-                    particles.insert(particles.end(), emitter.getParticles().begin(), emitter.getParticles().end());
-                }
-            }
+            collect<SpriteParticle>(emitter);
         }
 
         void visit(const MeshEmitter& emitter) noexcept override {
-            if constexpr (std::is_same_v<Particle, MeshParticle>) {
-                if (emitter_type == emitter.getUniqueRendererType()) {
-                    particles.insert(particles.end(), emitter.getParticles().begin(), emitter.getParticles().end());
-                }
-            }
+            collect<MeshParticle>(emitter);
         }
 
         void visit(const BeamEmitter& emitter) noexcept override {
-            if constexpr (std::is_same_v<Particle, BeamParticleMapping>) {
-                if (emitter_type == emitter.getUniqueRendererType()) {
-                    particles.insert(particles.end(), emitter.getParticles().begin(), emitter.getParticles().end());
-                }
-            }
+            collect<BeamParticle>(emitter);
         }
-
-        [[nodiscard]] auto&& yield() { return std::move(particles); }
     };
-}
\ No newline at end of file
+}
@@ -1,133 +1,49 @@
 #pragma once
 
 #include <limitless/fx/modules/module.hpp>
+#include <limitless/fx/beam_geometry.hpp>
 
 #include <limitless/core/context.hpp>
 #include <limitless/camera.hpp>
 
-#include <algorithm>
-
 namespace Limitless::fx {
     template<typename Particle>
     class BeamBuilder : public Module<Particle> {
     private:
         std::vector<BeamParticleMapping> beam_particles;
-
-        void generate(BeamParticle& particle, Context& ctx, const Camera& camera) {
-            constexpr auto DOT_PRODUCT_RANGE = glm::vec2(0.2f, 0.8f);
-            const auto resolution = glm::vec2(ctx.getSize().x, ctx.getSize().y);
-            const auto& line = particle.derivative_line;
-
-            for (uint32_t i = 0; i < 6 * (line.size() - 2 - 1); ++i) {
-                int line_i = i / 6;
-                int tri_i = i % 6;
-
-                glm::vec4 va[4];
-                const auto VP = camera.getProjection() * camera.getView();
-                for (uint32_t k = 0; k < 4; ++k) {
-                    va[k] = VP * glm::vec4(line.at(line_i + k), 1.0f);
-                    va[k].x /= va[k].w;
-                    va[k].y /= va[k].w;
-                    va[k].z /= va[k].w;
-
-                    va[k].x = ((glm::vec2(va[k]) + 1.0f) * 0.5f * resolution).x;
-                    va[k].y = ((glm::vec2(va[k]) + 1.0f) * 0.5f * resolution).y;
-                }
-
-                glm::vec2 v_line = glm::normalize(glm::vec2(va[2]) - glm::vec2(va[1]));
-                glm::vec2 nv_line = glm::vec2(-v_line.y, v_line.x);
-
-                glm::vec4 pos;
-                if (tri_i == 0 || tri_i == 1 || tri_i == 3) {
-                    glm::vec2 v_pred = glm::normalize(glm::vec2(va[1]) - glm::vec2(va[0]));
-                    glm::vec2 v_miter = glm::normalize(nv_line + glm::vec2(-v_pred.y, v_pred.x));
-
-                    pos = va[1];
-                    auto dot = glm::dot(v_miter, nv_line);
-                    dot = glm::min(dot, DOT_PRODUCT_RANGE.y);
-                    dot = glm::max(dot, DOT_PRODUCT_RANGE.x);
-                    pos.x += (v_miter * particle.size / pos.w * (tri_i == 1 ? -0.5f : 0.5f) / dot).x;
-                    pos.y += (v_miter * particle.size / pos.w * (tri_i == 1 ? -0.5f : 0.5f) / dot).y;
-                } else {
-                    glm::vec2 v_succ = normalize(glm::vec2(va[3]) - glm::vec2(va[2]));
-                    glm::vec2 v_miter = normalize(nv_line + glm::vec2(-v_succ.y, v_succ.x));
-
-                    pos = va[2];
-                    auto dot = glm::dot(v_miter, nv_line);
-                    dot = glm::min(dot, DOT_PRODUCT_RANGE.y);
-                    dot = glm::max(dot, DOT_PRODUCT_RANGE.x);
-                    pos.x += (v_miter * particle.size / pos.w * (tri_i == 5 ? 0.5f : -0.5f) / dot).x;
-                    pos.y += (v_miter * particle.size / pos.w * (tri_i == 5 ? 0.5f : -0.5f) / dot).y;
-                }
-
-                pos.x = (glm::vec2(pos) / resolution * 2.0f - 1.0f).x;
-                pos.y = (glm::vec2(pos) / resolution * 2.0f - 1.0f).y;
-
-                pos.x *= pos.w;
-                pos.y *= pos.w;
-                pos.z *= pos.w;
-
-                pos = glm::inverse(camera.getProjection() * camera.getView()) * pos;
-
-                glm::vec2 uv;
-                switch (tri_i) {
-                    case 0:
-                        uv = {0.0f, 1.0f};
-                        break;
-                    case 1:
-                        uv = {0.0f, 0.0f};
-                        break;
-                    case 2:
-                        uv = {1.0f, 0.0f};
-                        break;
-                    case 3:
-                        uv = {0.0f, 1.0f};
-                        break;
-                    case 4:
-                        uv = {1.0f, 0.0f};
-                        break;
-                    case 5:
-                        uv = {0.0f, 1.0f};
-                        break;
-                }
-
-
-                BeamParticleMapping p;
-                p.position = pos;
-                p.size = particle.size;
-                p.color = particle.color;
-                p.subUV = particle.subUV;
-                p.properties = particle.properties;
-                p.acceleration = particle.acceleration;
-                p.lifetime = particle.lifetime;
-                p.rotation = particle.rotation;
-                p.time = particle.time;
-                p.velocity = particle.velocity;
-                p.uv = uv;
-                p.length = particle.length;
-                p.start = particle.position;
-                p.end = particle.target;
-
-                beam_particles.emplace_back(std::move(p));
-            }
-        }
-
-        void generate(std::vector<glm::vec3>& line, BeamParticle& particle, glm::vec3 source, glm::vec3 dest, float distance) {
-            std::random_device rd;
-            std::mt19937 generator(rd());
-            auto uni = std::uniform_real_distribution<float>(-distance, distance);
-
-            if (distance < particle.offset) {
-                line.emplace_back(source);
-                line.emplace_back(dest);
-            } else {
-                glm::vec3 center = (source + dest) * 0.5f;
-                glm::vec3 random = {uni(generator), uni(generator), uni(generator)};
-
-                center += random;
-
-                generate(line, particle, source, center, distance * 0.5f);
-                generate(line, particle, dest, center, distance * 0.5f);
+        // owned by module, so emitters can be updated in parallel
+        Xoshiro128 generator {nextRandomSeed()};
+
+        // scratch buffers reused between frames
+        std::vector<glm::vec4> screen;
+        std::vector<BeamVertex> vertices;
+
+        void generate(const ParticleStorage<Particle>& particles, size_t index, const BeamFrame& frame, BeamParticleMapping* mapping) {
+            const auto& extra = particles.extra[index];
+            const auto size = particles.size[index];
+            const auto count = getBeamVertexCount(extra.derivative_line.size());
+
+            vertices.resize(count);
+            generateBeamVertices(frame, extra.derivative_line, size, screen, vertices.data());
+
+            BeamParticleMapping p;
+            p.size = size;
+            p.color = particles.color[index];
+            p.subUV = particles.subUV[index];
+            p.properties = particles.properties[index];
+            p.acceleration = particles.acceleration[index];
+            p.lifetime = particles.lifetime[index];
+            p.rotation = particles.rotation[index];
+            p.time = particles.time[index];
+            p.velocity = particles.velocity[index];
+            p.length = extra.length;
+            p.start = particles.position[index];
+            p.end = extra.target;
+
+            for (size_t i = 0; i < count; ++i) {
+                p.position = vertices[i].position;
+                p.uv = vertices[i].uv;
+                mapping[i] = p;
             }
         }
     public:
@@ -143,33 +59,29 @@ namespace Limitless::fx {
             return beam_particles;
         }
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, [[maybe_unused]] float dt, Context& ctx, const Camera& camera) noexcept override {
-            beam_particles.clear();
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, Context& ctx, const Camera& camera) noexcept override {
+            size_t total = 0;
 
-            for (auto& particle : particles) {
-                const auto current = std::chrono::steady_clock::now();
-                const auto delta_time = std::chrono::duration_cast<std::chrono::duration<float>>(current - particle.last_rebuild);
+            for (size_t i = 0; i < particles.count(); ++i) {
+                auto& particle = particles.extra[i];
+                particle.since_rebuild += std::chrono::duration<float>(dt);
 
-                if (delta_time > particle.rebuild_delta) {
-                    auto& line = particle.derivative_line;
-                    line.clear();
-                    generate(particle.derivative_line, particle, particle.position, particle.target, particle.displacement);
-
-                    // shitty algorithm requirements
-                    {
-                        std::sort(line.begin(), line.end(), [&](const auto& a, const auto& b) {
-                            return glm::distance(particle.position, a) < glm::distance(particle.position, b);
-                        });
-                        line.erase(std::unique(line.begin(), line.end()), line.end());
+                if (particle.derivative_line.empty() || particle.since_rebuild > particle.rebuild_delta) {
+                    generateBeamLine(particle.derivative_line, particles.position[i], particle.target, particle.displacement, particle.offset, generator);
+                    particle.since_rebuild = std::chrono::duration<float>(0.0f);
+                }
 
-                        line.emplace_back(line[0]);
-                        line.insert(line.begin(), line[line.size() - 2]);
-                    }
+                total += getBeamVertexCount(particle.derivative_line.size());
+            }
 
-                    particle.last_rebuild = current;
-                }
+            // capacity is kept between frames, so steady state does not allocate
+            beam_particles.resize(total);
 
-                generate(particle, ctx, camera);
+            const BeamFrame frame {camera.getProjection(), camera.getView(), glm::vec2(ctx.getSize().x, ctx.getSize().y)};
+            size_t offset = 0;
+            for (size_t i = 0; i < particles.count(); ++i) {
+                generate(particles, i, frame, beam_particles.data() + offset);
+                offset += getBeamVertexCount(particles.extra[i].derivative_line.size());
             }
         }
 
@@ -177,4 +89,4 @@ namespace Limitless::fx {
             return new BeamBuilder(*this);
         }
     };
-}
\ No newline at end of file
+}
@@ -20,23 +20,24 @@ namespace Limitless::fx {
 
         BeamSpeed(const BeamSpeed& module) : Module<Particle>(module.type), distribution {module.distribution->clone()} {}
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.speed = distribution->get();
-            particle.length = 0.0f;
-            particle.speed_start = std::chrono::steady_clock::now();
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            for (size_t i = begin; i < begin + count; ++i) {
+                auto& particle = particles.extra[i];
+                particle.speed = distribution->get();
+                particle.length = 0.0f;
+                particle.speed_time = std::chrono::duration<float>(0.0f);
+            }
         }
 
         [[nodiscard]] BeamSpeed* clone() const override {
             return new BeamSpeed(*this);
         }
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, [[maybe_unused]] float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
-            using namespace std::chrono;
-            for (auto& particle : particles) {
-                const auto current_time = steady_clock::now();
-                std::chrono::duration<double> mil = current_time - particle.speed_start;
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+            for (auto& particle : particles.extra) {
+                particle.speed_time += std::chrono::duration<float>(dt);
 
-                //particle.length = mil.count() / particle.speed;
+                //particle.length = particle.speed_time.count() / particle.speed;
                 //particle.length = glm::clamp(particle.length, 0.0f, 1.0f);
             }
         }
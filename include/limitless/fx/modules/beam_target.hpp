@@ -18,8 +18,10 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.target = distribution->get();
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            for (size_t i = begin; i < begin + count; ++i) {
+                particles.extra[i].target = distribution->get();
+            }
         }
 
         [[nodiscard]] BeamTarget* clone() const override {
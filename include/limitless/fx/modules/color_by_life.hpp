@@ -8,6 +8,8 @@ namespace Limitless::fx {
     class ColorByLife : public Module<Particle> {
     private:
         std::unique_ptr<Distribution<glm::vec4>> distribution;
+        // sampled target colors for current update
+        ParticleStream<glm::vec4> targets;
     public:
         explicit ColorByLife(std::unique_ptr<Distribution<glm::vec4>> _distribution) noexcept
             : Module<Particle>(ModuleType::ColorByLife)
@@ -18,13 +20,12 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
-            for (auto& particle : particles) {
-                const auto tick = particle.lifetime / dt;
-                const auto tick_color = (distribution->get() - particle.color) / tick;
-                particle.color += tick_color;
-                particle.color = glm::clamp(particle.color, glm::vec4(0.0f), glm::vec4(std::numeric_limits<float>::max()));
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+            if (!evaluate(*distribution, particles, particles.color.data())) {
+                const auto uniform = sample(*distribution, targets, particles.count());
+                kernels::approach(particles.color.data(), targets.data(), uniform, particles.lifetime.data(), particles.count(), dt);
             }
+            kernels::clamp(particles.color.data(), particles.count(), 0.0f, std::numeric_limits<float>::max());
         }
 
         [[nodiscard]] ColorByLife* clone() const override {
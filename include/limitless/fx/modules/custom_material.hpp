@@ -9,6 +9,8 @@ namespace Limitless::fx
     {
     private:
         std::array<std::unique_ptr<Distribution<float>>, 4> properties;
+        // samples of one property for emitted batch
+        ParticleStream<float> samples;
     public:
         CustomMaterial(std::unique_ptr<Distribution<float>> prop1,
                        std::unique_ptr<Distribution<float>> prop2,
@@ -31,13 +33,18 @@ namespace Limitless::fx
         auto& getProperties() noexcept { return properties; }
         const auto& getProperties() const noexcept { return properties; }
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override 
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override 
         {
+            samples.resize(count);
             for (size_t i = 0; i < properties.size(); ++i)
             {
                 if (properties[i])
                 {
-                    particle.properties[i] = properties[i]->get();
+                    properties[i]->fill(samples.data(), count);
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        particles.properties[begin + j][i] = samples[j];
+                    }
                 }
             }
         }
@@ -10,6 +10,8 @@ namespace Limitless::fx
 	{
 	private:
 		std::array<std::unique_ptr<Distribution<float>>, 4> properties;
+		// sampled target values of one property for current update
+		ParticleStream<float> targets;
 	public:
 		CustomMaterialByLife(std::unique_ptr<Distribution<float>> prop1,
 			std::unique_ptr<Distribution<float>> prop2,
@@ -34,16 +36,26 @@ namespace Limitless::fx
 		auto& getProperties() noexcept { return properties; }
 		const auto& getProperties() const noexcept { return properties; }
 
-		void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override 
+		void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override 
 		{
-			for (auto& particle : particles)
+			for (size_t i = 0; i < properties.size(); ++i) 
 			{
-				for (size_t i = 0; i < properties.size(); ++i) 
+				if (properties[i] && properties[i]->getType() == DistributionType::Curve)
 				{
-					if (properties[i])
+					targets.resize(particles.count());
+					evaluate(*properties[i], particles, targets.data());
+					for (size_t j = 0; j < particles.count(); ++j)
 					{
-						const auto tick = particle.lifetime / dt;
-						particle.properties[i] += (properties[i]->get() - particle.properties[i]) / tick;
+						particles.properties[j][i] = targets[j];
+					}
+				}
+				else if (properties[i])
+				{
+					const auto uniform = sample(*properties[i], targets, particles.count());
+					for (size_t j = 0; j < particles.count(); ++j)
+					{
+						auto& property = particles.properties[j][i];
+						property += ((uniform ? targets[0] : targets[j]) - property) * (dt / particles.lifetime[j]);
 					}
 				}
 			}
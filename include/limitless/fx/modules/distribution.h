@@ -1,77 +1,45 @@
 #pragma once
 
+#include <limitless/util/random.hpp>
 #include <glm/glm.hpp>
-#include <random>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+#include <atomic>
+#include <vector>
+#include <array>
 //#include <WinUser.h>
 #include <windows.h>
 #undef max
 #undef min
 
-namespace std 
+namespace Limitless
 {
-    template<> struct is_floating_point<glm::vec2> : public true_type {};
-    template<> struct is_floating_point<glm::vec3> : public true_type {};
-    template<> struct is_floating_point<glm::vec4> : public true_type {};
+    enum class DistributionType { Const, Range, Curve };
 
-    template<>
-    class uniform_real_distribution<glm::vec2> 
-    {
-    private:
-        glm::vec2 min, max;
-    public:
-        uniform_real_distribution(const glm::vec2& _min, const glm::vec2& _max) noexcept
-                : min(_min), max(_max) {}
-
-        template<typename _UniformRandomNumberGenerator>
-        glm::vec2 operator()(_UniformRandomNumberGenerator& __urng) {
-            //__detail::_Adaptor<_UniformRandomNumberGenerator, float> __aurng(__urng);
-            return { __urng() * (max.x - min.x) + min.x,
-                     __urng() * (max.y - min.y) + min.y };
-        }
-    };
+    inline std::atomic<uint32_t> random_seed_source {5489u};
 
-    template<>
-    class uniform_real_distribution<glm::vec3> 
+    /*
+     * thread-safe source of distinct seeds
+     *
+     * every distribution and module gets its own generator on creation and on copy,
+     * so clones can be updated from different threads
+     */
+    inline uint32_t nextRandomSeed() noexcept
     {
-    private:
-        glm::vec3 min, max;
-    public:
-        uniform_real_distribution(const glm::vec3& min, const glm::vec3& max) noexcept
-                : min(min), max(max) {}
+        return random_seed_source.fetch_add(0x9E3779B9u, std::memory_order_relaxed);
+    }
 
-        template<typename _UniformRandomNumberGenerator>
-        glm::vec3 operator()(_UniformRandomNumberGenerator& __urng)
-        {
-            //std::__detail::_Adaptor<_UniformRandomNumberGenerator, float> __aurng(__urng);
-            return { __urng() * (max.x - min.x) + min.x,
-                     __urng() * (max.y - min.y) + min.y,
-                     __urng() * (max.z - min.z) + min.z };
-        }
-    };
-
-    template<>
-    class uniform_real_distribution<glm::vec4>
+    /*
+     * restarts seed sequence
+     *
+     * effects loaded and instantiated in the same order after the call
+     * get the same generator states, so simulation is reproducible
+     */
+    inline void setRandomSeed(uint32_t seed) noexcept
     {
-    private:
-        glm::vec4 min, max;
-    public:
-        uniform_real_distribution(const glm::vec4& min, const glm::vec4& max)
-                : min(min), max(max) {}
-
-        template<typename _UniformRandomNumberGenerator>
-        glm::vec4 operator()(_UniformRandomNumberGenerator& __urng) {
-            //__detail::_Adaptor<_UniformRandomNumberGenerator, float> __aurng(__urng);
-            return { __urng() * (max.x - min.x) + min.x,
-                     __urng() * (max.y - min.y) + min.y,
-                     __urng() * (max.z - min.z) + min.z,
-                     __urng() * (max.w - min.w) + min.w };
-        }
-    };
-}
-
-namespace Limitless
-{
-    enum class DistributionType { Const, Range, Curve };
+        random_seed_source.store(seed, std::memory_order_relaxed);
+    }
 
     template<typename T>
     class Distribution 
@@ -85,6 +53,18 @@ namespace Limitless
         [[nodiscard]] virtual T get() = 0;
         [[nodiscard]] virtual T get() const = 0;
         [[nodiscard]] virtual Distribution<T>* clone() = 0;
+
+        // writes count samples to values with one virtual call for the whole batch
+        virtual void fill(T* values, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = get();
+            }
+        }
+
+        // restarts random sequence; does nothing for deterministic distributions
+        virtual void seed([[maybe_unused]] uint64_t seed) noexcept {}
+
         [[nodiscard]] const auto& getType() const noexcept { return type; }
     };
 
@@ -100,7 +80,9 @@ namespace Limitless
         T get() override { return value; }
         T get() const override { return value; }
 
-        T& getValue() const noexcept { return value; }
+        void fill(T* values, size_t count) override { std::fill_n(values, count, value); }
+
+        const T& getValue() const noexcept { return value; }
         T& getValue() noexcept { return value; }
 
         [[nodiscard]] Distribution<T>* clone() override {
@@ -108,114 +90,80 @@ namespace Limitless
         }
     };
 
-	template<typename T, typename E = void>
-	class uniform_distribution 
-    { 
-        static_assert("kek i shrek bratya na vek");
-		//std::uniform_int_distribution<T> distribution;
-	public:
-		uniform_distribution(T min, T mmax) 
-        {
-            static_assert("kek i shrek bratya na vek");
-            //OutputDebugString("111");
-            //count << "error" << endl;
-        }
-    };
-
-	template<typename T>
-	class uniform_distribution<T, typename std::enable_if_t<std::is_integral_v<T>>>
-	{
-		std::uniform_int_distribution<T> distribution;
-	public:
-		uniform_distribution(T min, T max) : distribution{ min, max } {}
-		void set(const T& min, const T& max) { distribution = std::uniform_int_distribution{ min, max }; }
-		template<typename Gen> 
-        auto operator()(Gen&& gen) { return distribution(std::forward<Gen>(gen)); }
-        template<typename Gen> 
-        auto operator()(Gen& gen) { return distribution(gen); }
-	};
-
-	template<typename T>
-	class uniform_distribution<T, typename std::enable_if_t<std::is_floating_point_v<T>>>
-	{
-		std::uniform_real_distribution<T> distribution;
-	public:
-		uniform_distribution(T min, T max) : distribution{ min, max }
-        {
-            OutputDebugString("222");
-            //count << "222" << endl;
-        }
-		void set(const T& min, const T& max) { distribution = std::uniform_real_distribution{ min, max }; }
-		template<typename Gen> 
-        auto operator()(Gen&& gen) { return distribution(std::forward<Gen>(gen)); }
-        template<typename Gen> 
-        auto operator()(Gen& gen) { return distribution(gen); }
-	};
-
-	template<typename T, typename E = void>
-	struct is_glm_type : public std::false_type {};
-	template<typename T>
-	struct is_glm_type<T, std::enable_if_t<
-        std::is_same_v<glm::vec2, T> ||
-		std::is_same_v<glm::vec3, T> ||
-		std::is_same_v<glm::vec4, T>>> : public std::true_type {};
-	//	std::is_same_v<glm::mat2, T> ||
-	//	std::is_same_v::mat3, T> ||
-	//	std::is_same_v<glm::mat4, T>> > : public std::true_type {};
-
-	template<typename T>
-	//class uniform_distribution<T, typename std::enable_if_t<std::is_same_v<glm::vec3,T>>>
-    class uniform_distribution<T, typename std::enable_if_t<is_glm_type<T>::value>>
-	{
-		std::uniform_real_distribution<T> distribution;
-	public:
-		uniform_distribution(T min, T max) : distribution{ min, max }
-		{
-			OutputDebugString("222");
-			//count << "222" << endl;`
-		}
-		void set(const T& min, const T& max) { distribution = std::uniform_real_distribution{ min, max }; }
-		template<typename Gen>
-		auto operator()(Gen&& gen) { return T(distribution(std::forward<Gen>(gen))); }
-		template<typename Gen>
-		auto operator()(Gen& gen) { return T(distribution(gen)); }
-	};
-
     template<typename T>
     class RangeDistribution : public Distribution<T> 
     {
     private:
         T min, max;
 
-        mutable std::default_random_engine generator;
-        mutable uniform_distribution<T> distribution;
+        mutable Xoshiro128 generator;
+
+        // uniform value in [min, max) for floating types, [min, max] for integral ones
+        T next() const noexcept
+        {
+            if constexpr (std::is_integral_v<T>) {
+                const auto range = static_cast<uint64_t>(max - min) + 1;
+                return static_cast<T>(min + generator.nextBelow(range));
+            } else if constexpr (std::is_floating_point_v<T>) {
+                return min + (max - min) * generator.nextFloat();
+            } else {
+                T value;
+                for (int i = 0; i < T::length(); ++i) {
+                    value[i] = min[i] + (max[i] - min[i]) * generator.nextFloat();
+                }
+                return value;
+            }
+        }
     public:
         RangeDistribution(const T& _min, const T& _max) noexcept
             : Distribution<T>(DistributionType::Range)
             , min(_min)
             , max(_max)
-            , distribution(min, max) {}
+            , generator(nextRandomSeed()) {}
         ~RangeDistribution() override = default;
 
+        // generator state is not shared with copy
+        RangeDistribution(const RangeDistribution& other)
+            : Distribution<T>(other)
+            , min(other.min)
+            , max(other.max)
+            , generator(nextRandomSeed()) {}
+
         [[nodiscard]] const T& getMin() const noexcept { return min; }
         [[nodiscard]] T& getMin() noexcept { return min; }
         [[nodiscard]] const T& getMax() const noexcept { return max; }
         [[nodiscard]] T& getMax() noexcept { return max; }
 
-        void setMin(const T& _min) noexcept
-        {
-            min = _min;
-            distribution.set(min, max);
-        }
+        void setMin(const T& _min) noexcept { min = _min; }
+        void setMax(const T& _max) noexcept { max = _max; }
 
-        void setMax(const T& _max) noexcept 
+        T get() override { return next(); }
+        T get() const override { return next(); }
+
+        void fill(T* values, size_t count) override
         {
-            max = _max;
-            distribution.set(min, max);
+            if constexpr (std::is_integral_v<T> || std::is_same_v<T, double>) {
+                for (size_t i = 0; i < count; ++i) {
+                    values[i] = next();
+                }
+            } else {
+                // float and glm float vectors; uniform [0, 1) floats are generated in place and scaled per component
+                constexpr size_t components = sizeof(T) / sizeof(float);
+                auto* data = reinterpret_cast<float*>(values);
+                generator.fill(data, count * components);
+
+                const auto* lo = reinterpret_cast<const float*>(&min);
+                const auto* hi = reinterpret_cast<const float*>(&max);
+                for (size_t i = 0; i < count; ++i) {
+                    for (size_t c = 0; c < components; ++c) {
+                        auto& value = data[i * components + c];
+                        value = lo[c] + (hi[c] - lo[c]) * value;
+                    }
+                }
+            }
         }
 
-        T get() override { return distribution(generator); }
-        T get() const override { return distribution(generator); }
+        void seed(uint64_t seed) noexcept override { generator.seed(seed); }
 
         [[nodiscard]] Distribution<T>* clone() override
         {
@@ -223,13 +171,112 @@ namespace Limitless
         }
     };
 
-    //TODO:
+    /*
+     * value changing over normalized time [0, 1]
+     *
+     * keyframes are baked into fixed-size lookup table on construction,
+     * so evaluation is two loads and lerp without searching for keys;
+     * used by *ByLife modules with normalized particle age
+     */
     template<typename T>
     class CurveDistribution : public Distribution<T> 
     {
+    public:
+        enum class Interpolation : uint8_t { Linear, Hermite };
+
+        struct Key {
+            // normalized time in [0, 1]
+            float time;
+            T value;
+        };
+
+        static constexpr size_t LUT_SIZE = 64;
     private:
+        std::vector<Key> keys;
+        Interpolation interpolation;
+        std::array<T, LUT_SIZE> lut;
+
+        // tangent at key for cubic hermite; finite difference of neighbour keys
+        T tangent(size_t i) const noexcept
+        {
+            const auto& prev = keys[i == 0 ? 0 : i - 1];
+            const auto& next = keys[std::min(i + 1, keys.size() - 1)];
+            const auto dt = next.time - prev.time;
+            return dt > 0.0f ? (next.value - prev.value) / dt : T(0.0f);
+        }
+
+        T interpolate(float t) const noexcept
+        {
+            if (t <= keys.front().time) {
+                return keys.front().value;
+            }
+            if (t >= keys.back().time) {
+                return keys.back().value;
+            }
+
+            const auto it = std::upper_bound(keys.begin(), keys.end(), t, [] (float time, const Key& key) { return time < key.time; });
+            const auto i = static_cast<size_t>(it - keys.begin()) - 1;
+            const auto& a = keys[i];
+            const auto& b = keys[i + 1];
+            const auto length = b.time - a.time;
+            const auto x = (t - a.time) / length;
+
+            if (interpolation == Interpolation::Linear) {
+                return a.value + (b.value - a.value) * x;
+            }
 
+            const auto x2 = x * x;
+            const auto x3 = x2 * x;
+            const auto h00 = 2.0f * x3 - 3.0f * x2 + 1.0f;
+            const auto h10 = x3 - 2.0f * x2 + x;
+            const auto h01 = -2.0f * x3 + 3.0f * x2;
+            const auto h11 = x3 - x2;
+
+            return a.value * h00 + tangent(i) * (h10 * length) + b.value * h01 + tangent(i + 1) * (h11 * length);
+        }
+
+        void bake() noexcept
+        {
+            for (size_t i = 0; i < LUT_SIZE; ++i) {
+                lut[i] = interpolate(static_cast<float>(i) / static_cast<float>(LUT_SIZE - 1));
+            }
+        }
     public:
+        explicit CurveDistribution(std::vector<Key> _keys, Interpolation _interpolation = Interpolation::Linear)
+            : Distribution<T>(DistributionType::Curve)
+            , keys {std::move(_keys)}
+            , interpolation {_interpolation}
+        {
+            static_assert(!std::is_integral_v<T>, "CurveDistribution requires floating type");
+
+            if (keys.empty()) {
+                throw std::invalid_argument("CurveDistribution requires at least one key");
+            }
+
+            std::sort(keys.begin(), keys.end(), [] (const Key& a, const Key& b) { return a.time < b.time; });
+            bake();
+        }
+        ~CurveDistribution() override = default;
 
+        [[nodiscard]] const auto& getKeys() const noexcept { return keys; }
+        [[nodiscard]] auto getInterpolation() const noexcept { return interpolation; }
+
+        // value at normalized time t; t is clamped to [0, 1]
+        [[nodiscard]] T evaluate(float t) const noexcept
+        {
+            const auto x = glm::clamp(t, 0.0f, 1.0f) * static_cast<float>(LUT_SIZE - 1);
+            const auto i = std::min(static_cast<size_t>(x), LUT_SIZE - 2);
+            const auto f = x - static_cast<float>(i);
+            return lut[i] + (lut[i + 1] - lut[i]) * f;
+        }
+
+        // without time curve gives its starting value
+        T get() override { return lut[0]; }
+        T get() const override { return lut[0]; }
+
+        [[nodiscard]] Distribution<T>* clone() override
+        {
+            return new CurveDistribution<T>(*this);
+        }
     };
-}
+}
\ No newline at end of file
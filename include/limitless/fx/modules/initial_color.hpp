@@ -18,8 +18,8 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution{module.distribution->clone()} {}
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.color = distribution->get();
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            distribution->fill(particles.color.data() + begin, count);
         }
 
         [[nodiscard]] InitialColor* clone() const override {
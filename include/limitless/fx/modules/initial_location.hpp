@@ -8,6 +8,8 @@ namespace Limitless::fx {
     class InitialLocation : public Module<Particle> {
     private:
         std::unique_ptr<Distribution<glm::vec3>> distribution;
+        // samples for emitted batch
+        ParticleStream<glm::vec3> samples;
     public:
         explicit InitialLocation(std::unique_ptr<Distribution<glm::vec3>> _distribution) noexcept
             : Module<Particle>(ModuleType::InitialLocation)
@@ -19,8 +21,10 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.position += distribution->get();
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            samples.resize(count);
+            distribution->fill(samples.data(), count);
+            kernels::addScaled(particles.position.data() + begin, samples.data(), count, 1.0f);
         }
 
         [[nodiscard]] InitialLocation* clone() const override {
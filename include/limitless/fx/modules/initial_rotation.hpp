@@ -8,6 +8,8 @@ namespace Limitless::fx {
     class InitialRotation : public Module<Particle> {
     private:
         std::unique_ptr<Distribution<glm::vec3>> distribution;
+        // samples for emitted batch
+        ParticleStream<glm::vec3> samples;
     public:
         explicit InitialRotation(std::unique_ptr<Distribution<glm::vec3>> _distribution) noexcept
             : Module<Particle>(ModuleType::InitialRotation)
@@ -19,9 +21,13 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void initialize(AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
+        void initialize(AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
             const auto rot = emitter.getRotation() * emitter.getLocalRotation();
-            particle.rotation += distribution->get() * rot;
+            samples.resize(count);
+            distribution->fill(samples.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                particles.rotation[begin + i] += samples[i] * rot;
+            }
         }
 
         [[nodiscard]] InitialRotation* clone() const override {
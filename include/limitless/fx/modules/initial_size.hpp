@@ -17,8 +17,8 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.size = distribution->get();
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            distribution->fill(particles.size.data() + begin, count);
         }
 
         [[nodiscard]] InitialSize* clone() const override {
@@ -43,8 +43,8 @@ namespace Limitless::fx {
                 : Module<MeshParticle>(module.type)
                 , distribution {module.distribution->clone()} {}
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, MeshParticle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.size = distribution->get();
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<MeshParticle>& particles, size_t begin, size_t count) noexcept override {
+            distribution->fill(particles.size.data() + begin, count);
         }
 
         [[nodiscard]] InitialSize* clone() const override {
@@ -17,9 +17,13 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void initialize(AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
+        void initialize(AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
             const auto rot = emitter.getRotation() * emitter.getLocalRotation();
-            particle.velocity = distribution->get() * rot;
+            auto* values = particles.velocity.data() + begin;
+            distribution->fill(values, count);
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = values[i] * rot;
+            }
         }
 
         [[nodiscard]] InitialVelocity* clone() const override {
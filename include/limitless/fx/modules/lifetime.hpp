@@ -18,14 +18,12 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.lifetime = distribution->get();
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            distribution->fill(particles.lifetime.data() + begin, count);
         }
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
-            for (auto& particle : particles) {
-                particle.lifetime -= dt;
-            }
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+            kernels::add(particles.lifetime.data(), particles.count(), -dt);
         }
 
         [[nodiscard]] Lifetime* clone() const override {
@@ -2,8 +2,11 @@
 
 #include <limitless/fx/modules/module.hpp>
 #include <limitless/core/indexed_stream.hpp>
+#include <limitless/core/skeletal_stream.hpp>
 #include <limitless/instances/skeletal_instance.hpp>
+#include <limitless/util/alias_table.hpp>
 #include <variant>
+#include <algorithm>
 #include <limitless/models/mesh.hpp>
 
 namespace Limitless::fx {
@@ -12,13 +15,49 @@ namespace Limitless::fx {
     template<typename Particle>
     class InitialMeshLocation : public Module<Particle> {
     protected:
+        /*
+         * surface sampling data of one mesh
+         *
+         * streams are resolved once, so no casts are done per particle;
+         * triangles are picked by area with alias table, so samples are uniform over the surface
+         */
+        struct MeshSampler {
+            const AbstractMesh* source {};
+            const IndexedVertexStream<VertexNormalTangent>* stream {};
+            // set if mesh can be skinned by skeletal instance
+            const SkinnedVertexStream<VertexNormalTangent>* skinned {};
+            // stream state table was built from
+            const void* vertices {};
+            size_t vertex_count {};
+            size_t index_count {};
+            AliasTable triangles;
+        };
+
+        struct SurfaceSample {
+            uint32_t mesh {};
+            uint32_t triangle {};
+            // barycentric randoms, r1 is already square rooted
+            float r1 {};
+            float r2 {};
+        };
+
         std::variant<std::shared_ptr<AbstractMesh>, std::shared_ptr<AbstractModel>> mesh;
-        std::default_random_engine generator;
+        Xoshiro128 generator;
 
         ModelInstance* instance {};
         glm::vec3 scale {1.0f};
         glm::vec3 rotation {0.0f};
 
+        std::vector<MeshSampler> samplers;
+        // picks mesh of model by its surface area
+        AliasTable mesh_table;
+
+        // scratch buffers reused between batches
+        std::vector<SurfaceSample> samples;
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> vertex_indices;
+        std::vector<glm::vec3> skinned_positions;
+
         glm::mat4 constructModelMatrix() {
             auto rotation_matrix = glm::rotate(glm::mat4(1.0f), rotation.x, glm::vec3(1.0f, 0.f, 0.f));
             rotation_matrix = glm::rotate(rotation_matrix, rotation.y, glm::vec3(0.0f, 1.f, 0.f));
@@ -27,107 +66,213 @@ namespace Limitless::fx {
             return rotation_matrix * scale_matrix;
         }
 
-        glm::vec3 getPositionOnTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float r1, float r2) noexcept {
-            r1 = glm::sqrt(r1);
-            const auto m1 = 1.0f - r1;
-            const auto m2 = r1 * (1.0f - r2);
-            const auto m3 = r2 * r1;
+        static glm::vec3 getPositionOnTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const SurfaceSample& sample) noexcept {
+            const auto m1 = 1.0f - sample.r1;
+            const auto m2 = sample.r1 * (1.0f - sample.r2);
+            const auto m3 = sample.r2 * sample.r1;
 
             return (m1 * a) + (m2 * b) + (m3 * c);
         }
 
-        glm::vec3 getPositionOnMesh(const std::shared_ptr<AbstractMesh>& _mesh, size_t vertex_index, float r1, float r2) {
-            const auto& indexed_mesh = dynamic_cast<IndexedVertexStream<VertexNormalTangent>&>(dynamic_cast<Mesh&>(*_mesh).getVertexStream());
-            const auto& vertices = indexed_mesh.getVertices();
-            const auto& indices = indexed_mesh.getIndices();
+        std::vector<const AbstractMesh*> getSourceMeshes() const {
+            if (std::holds_alternative<std::shared_ptr<AbstractMesh>>(mesh)) {
+                return { std::get<std::shared_ptr<AbstractMesh>>(mesh).get() };
+            }
 
-            const auto v_index1 = indices[vertex_index];
-            const auto v_index2 = indices[vertex_index + 1];
-            const auto v_index3 = indices[vertex_index + 2];
+            std::vector<const AbstractMesh*> meshes;
+            for (const auto& model_mesh : std::get<std::shared_ptr<AbstractModel>>(mesh)->getMeshes()) {
+                meshes.emplace_back(model_mesh.get());
+            }
+            return meshes;
+        }
 
-            if (instance) {
-                if (instance->getShaderType() == ModelShader::Skeletal) {
-                    const auto& skeletal_instance = static_cast<SkeletalInstance&>(*instance);
-                    const auto pos1 = skeletal_instance.getSkinnedVertexPosition(_mesh, v_index1);
-                    const auto pos2 = skeletal_instance.getSkinnedVertexPosition(_mesh, v_index2);
-                    const auto pos3 = skeletal_instance.getSkinnedVertexPosition(_mesh, v_index3);
+        static bool isValid(const MeshSampler& sampler, const AbstractMesh* source) noexcept {
+            if (sampler.source != source) {
+                return false;
+            }
 
-                    return constructModelMatrix() * glm::vec4(getPositionOnTriangle(pos1, pos2, pos3, r1, r2), 1.0f);
-                }
+            if (!sampler.stream) {
+                return true;
+            }
+
+            return sampler.vertices == sampler.stream->getVertices().data() &&
+                   sampler.vertex_count == sampler.stream->getVertices().size() &&
+                   sampler.index_count == sampler.stream->getIndices().size();
+        }
+
+        static MeshSampler buildSampler(const AbstractMesh* source) {
+            MeshSampler sampler;
+            sampler.source = source;
+
+            // only indexed triangle meshes are supported
+            const auto* source_mesh = dynamic_cast<const Mesh*>(source);
+            if (!source_mesh) {
+                return sampler;
+            }
 
-                return constructModelMatrix() * instance->getModelMatrix() * glm::vec4(getPositionOnTriangle(vertices[v_index1].position,
-                                                                                    vertices[v_index2].position,
-                                                                                    vertices[v_index3].position,
-                                                                                    r1, r2), 1.0f);
+            sampler.stream = dynamic_cast<const IndexedVertexStream<VertexNormalTangent>*>(&source_mesh->getVertexStream());
+            if (!sampler.stream) {
+                return sampler;
             }
+            sampler.skinned = dynamic_cast<const SkinnedVertexStream<VertexNormalTangent>*>(sampler.stream);
 
-            return constructModelMatrix() * glm::vec4(getPositionOnTriangle(vertices[v_index1].position,
-                                         vertices[v_index2].position,
-                                         vertices[v_index3].position,
-                                         r1, r2), 1.0f);
+            const auto& vertices = sampler.stream->getVertices();
+            const auto& indices = sampler.stream->getIndices();
+            sampler.vertices = vertices.data();
+            sampler.vertex_count = vertices.size();
+            sampler.index_count = indices.size();
+
+            // skinned meshes are weighted by bind pose
+            std::vector<float> areas(indices.size() / 3);
+            for (size_t i = 0; i < areas.size(); ++i) {
+                const auto& a = vertices[indices[i * 3]].position;
+                const auto& b = vertices[indices[i * 3 + 1]].position;
+                const auto& c = vertices[indices[i * 3 + 2]].position;
+                areas[i] = 0.5f * glm::length(glm::cross(b - a, c - a));
+            }
+            sampler.triangles.build(areas.data(), areas.size());
+
+            return sampler;
         }
 
-        InitialMeshLocation(ModuleType type, std::shared_ptr<AbstractMesh> _mesh) noexcept
-            : Module<Particle>(type)
-            , mesh {std::move(_mesh)}
-            , generator {std::random_device()()} {
+        // rebuilds tables if mesh has changed; returns true if they were rebuilt
+        bool updateSamplers() {
+            const auto sources = getSourceMeshes();
+
+            auto valid = samplers.size() == sources.size();
+            for (size_t i = 0; valid && i < sources.size(); ++i) {
+                valid = isValid(samplers[i], sources[i]);
+            }
+
+            if (valid) {
+                return false;
+            }
+
+            samplers.clear();
+            for (const auto* source : sources) {
+                samplers.emplace_back(buildSampler(source));
+            }
+
+            std::vector<float> weights;
+            for (const auto& sampler : samplers) {
+                weights.emplace_back(static_cast<float>(sampler.triangles.getTotal()));
+            }
+            // degenerate meshes are picked uniformly among the ones that have triangles
+            if (std::all_of(weights.begin(), weights.end(), [] (float weight) { return weight <= 0.0f; })) {
+                for (size_t i = 0; i < samplers.size(); ++i) {
+                    weights[i] = samplers[i].triangles.empty() ? 0.0f : 1.0f;
+                }
+            }
+            mesh_table.build(weights.data(), weights.size());
+
+            return true;
         }
 
-        InitialMeshLocation(ModuleType type, std::shared_ptr<AbstractModel> _mesh) noexcept
-            : Module<Particle>(type)
-            , mesh {std::move(_mesh)}
-            , generator {std::random_device()()} {
+        [[nodiscard]] bool hasSurface() const noexcept {
+            return std::any_of(samplers.begin(), samplers.end(), [] (const auto& sampler) { return !sampler.triangles.empty(); });
         }
 
-        auto getSelectedMesh() {
-            std::shared_ptr<AbstractMesh> selected_mesh;
-            if (std::holds_alternative<std::shared_ptr<AbstractMesh>>(mesh)) {
-                selected_mesh = std::get<std::shared_ptr<AbstractMesh>>(mesh);
-            } else {
-                const auto& model = std::get<std::shared_ptr<AbstractModel>>(mesh);
-                const auto& meshes = model->getMeshes();
+        // fills samples with count random points on the surface; requires hasSurface()
+        void sampleSurface(size_t count) {
+            samples.resize(count);
 
-                using vector_size_type = typename std::remove_reference_t<decltype(meshes)>::size_type;
-                auto int_distribution = std::uniform_int_distribution(static_cast<vector_size_type>(0), meshes.size() - 1);
-                const auto mesh_index = int_distribution(generator);
+            for (auto& sample : samples) {
+                sample.mesh = samplers.size() == 1 ? 0 : mesh_table.sample(generator);
+                sample.triangle = samplers[sample.mesh].triangles.sample(generator);
+                sample.r1 = glm::sqrt(generator.nextFloat());
+                sample.r2 = generator.nextFloat();
+            }
+        }
+
+        /*
+         * computes current positions of surface samples
+         *
+         * for skeletal instance vertices of every mesh are skinned in one batch
+         */
+        void getPositions(const SurfaceSample* surface, size_t count, glm::vec3* out) {
+            const auto matrix = constructModelMatrix();
 
-                selected_mesh = meshes[mesh_index];
+            const SkeletalInstance* skeletal = nullptr;
+            auto static_matrix = matrix;
+            if (instance) {
+                if (instance->getShaderType() == ModelShader::Skeletal) {
+                    skeletal = static_cast<const SkeletalInstance*>(instance);
+                }
+                static_matrix = matrix * instance->getModelMatrix();
             }
 
-            return selected_mesh;
+            for (uint32_t m = 0; m < samplers.size(); ++m) {
+                const auto& sampler = samplers[m];
+                if (sampler.triangles.empty()) {
+                    continue;
+                }
+
+                const auto& indices = sampler.stream->getIndices();
+
+                if (skeletal && sampler.skinned) {
+                    vertex_indices.clear();
+                    for (size_t i = 0; i < count; ++i) {
+                        if (surface[i].mesh == m) {
+                            const auto first = surface[i].triangle * 3;
+                            vertex_indices.insert(vertex_indices.end(), {indices[first], indices[first + 1], indices[first + 2]});
+                        }
+                    }
+
+                    skinned_positions.resize(vertex_indices.size());
+                    skeletal->getSkinnedVertexPositions(*sampler.skinned, vertex_indices.data(), vertex_indices.size(), skinned_positions.data());
+
+                    const auto* triangle = skinned_positions.data();
+                    for (size_t i = 0; i < count; ++i) {
+                        if (surface[i].mesh == m) {
+                            out[i] = matrix * glm::vec4(getPositionOnTriangle(triangle[0], triangle[1], triangle[2], surface[i]), 1.0f);
+                            triangle += 3;
+                        }
+                    }
+                    continue;
+                }
+
+                const auto& vertices = sampler.stream->getVertices();
+                for (size_t i = 0; i < count; ++i) {
+                    if (surface[i].mesh == m) {
+                        const auto first = surface[i].triangle * 3;
+                        const auto position = getPositionOnTriangle(vertices[indices[first]].position,
+                                                                    vertices[indices[first + 1]].position,
+                                                                    vertices[indices[first + 2]].position,
+                                                                    surface[i]);
+                        out[i] = static_matrix * glm::vec4(position, 1.0f);
+                    }
+                }
+            }
         }
 
-        auto getVertexIndex(const std::shared_ptr<AbstractMesh>& selected_mesh) {
-            const auto& indexed_mesh = dynamic_cast<IndexedVertexStream<VertexNormalTangent>&>(dynamic_cast<Mesh&>(*selected_mesh).getVertexStream());
-            const auto& indices = indexed_mesh.getIndices();
-            using vector_size_type = typename std::remove_reference_t<decltype(indices)>::size_type;
-            auto int_distribution = std::uniform_int_distribution(static_cast<vector_size_type>(0), indices.size() - 4);
-            return int_distribution(generator);
+        InitialMeshLocation(ModuleType type, std::shared_ptr<AbstractMesh> _mesh) noexcept
+            : Module<Particle>(type)
+            , mesh {std::move(_mesh)}
+            , generator {nextRandomSeed()} {
         }
 
-        auto getTrianglePosition() {
-            auto triangle_distribution = std::uniform_real_distribution<float>(0.0f, 1.0f);
-            const auto r1 = glm::sqrt(triangle_distribution(generator));
-            const auto r2 = triangle_distribution(generator);
-            return std::pair{r1, r2};
+        InitialMeshLocation(ModuleType type, std::shared_ptr<AbstractModel> _mesh) noexcept
+            : Module<Particle>(type)
+            , mesh {std::move(_mesh)}
+            , generator {nextRandomSeed()} {
         }
     public:
         explicit InitialMeshLocation(std::shared_ptr<AbstractMesh> _mesh) noexcept
                 : Module<Particle>(ModuleType::InitialMeshLocation)
                 , mesh {std::move(_mesh)}
-                , generator {std::random_device()()} {
+                , generator {nextRandomSeed()} {
         }
 
         explicit InitialMeshLocation(std::shared_ptr<AbstractModel> _mesh) noexcept
                 : Module<Particle>(ModuleType::InitialMeshLocation)
                 , mesh {std::move(_mesh)}
-                , generator {std::random_device()()}{
+                , generator {nextRandomSeed()}{
         }
 
         explicit InitialMeshLocation(std::shared_ptr<AbstractMesh> _mesh, const glm::vec3& _scale, const glm::vec3& _rotation) noexcept
             : Module<Particle>(ModuleType::InitialMeshLocation)
             , mesh {std::move(_mesh)}
-            , generator {std::random_device()()}
+            , generator {nextRandomSeed()}
             , scale {_scale}
             , rotation {_rotation} {
         }
@@ -135,15 +280,26 @@ namespace Limitless::fx {
         explicit InitialMeshLocation(std::shared_ptr<AbstractModel> _mesh, const glm::vec3& _scale, const glm::vec3& _rotation) noexcept
             : Module<Particle>(ModuleType::InitialMeshLocation)
             , mesh {std::move(_mesh)}
-            , generator {std::random_device()()}
+            , generator {nextRandomSeed()}
             , scale {_scale}
             , rotation {_rotation} {
         }
 
         ~InitialMeshLocation() override = default;
 
-        InitialMeshLocation(const InitialMeshLocation&) = default;
-        InitialMeshLocation& operator=(const InitialMeshLocation&) noexcept = default;
+        // generator state is not shared with copy, scratch buffers are not copied
+        InitialMeshLocation(const InitialMeshLocation& other)
+            : Module<Particle>(other)
+            , mesh {other.mesh}
+            , generator {nextRandomSeed()}
+            , instance {other.instance}
+            , scale {other.scale}
+            , rotation {other.rotation}
+            , samplers {other.samplers}
+            , mesh_table {other.mesh_table} {
+        }
+
+        InitialMeshLocation& operator=(const InitialMeshLocation&) = delete;
 
         void attachModelInstance(ModelInstance* _instance) noexcept {
             instance = _instance;
@@ -156,11 +312,25 @@ namespace Limitless::fx {
         auto& getRotation() noexcept { return rotation; }
         const auto& getRotation() const noexcept { return rotation; }
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            const auto selected_mesh = getSelectedMesh();
-            const auto vertex_index = getVertexIndex(selected_mesh);
-            const auto triangle_pos = getTrianglePosition();
-            particle.position += getPositionOnMesh(selected_mesh, vertex_index, triangle_pos.first, triangle_pos.second);
+        // forces tables to be rebuilt, e.g. after vertex positions are changed in place
+        void invalidate() noexcept {
+            samplers.clear();
+        }
+
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            updateSamplers();
+
+            if (!hasSurface()) {
+                return;
+            }
+
+            sampleSurface(count);
+            positions.resize(count);
+            getPositions(samples.data(), count, positions.data());
+
+            for (size_t i = 0; i < count; ++i) {
+                particles.position[begin + i] += positions[i];
+            }
         }
 
         [[nodiscard]] InitialMeshLocation* clone() const noexcept override {
@@ -7,13 +7,18 @@ namespace Limitless::fx {
     template<typename Particle>
     class MeshLocationAttachment final : public InitialMeshLocation<Particle> {
     private:
-        struct LocationCache {
-            std::shared_ptr<AbstractMesh> selected_mesh;
-            size_t vertex_index;
-            std::pair<float, float> triangle_position;
-            glm::vec3 last_position;
-        };
-        std::map<size_t, LocationCache> cache;
+        using SurfaceSample = typename InitialMeshLocation<Particle>::SurfaceSample;
+
+        // indexed by particle
+        std::vector<SurfaceSample> cache;
+        std::vector<glm::vec3> last_position;
+
+        // places cached particles on new surface when mesh has changed
+        void resample() {
+            this->sampleSurface(cache.size());
+            std::copy(this->samples.begin(), this->samples.end(), cache.begin());
+            this->getPositions(cache.data(), cache.size(), last_position.data());
+        }
     public:
         explicit MeshLocationAttachment(std::shared_ptr<AbstractMesh> mesh) noexcept
             : InitialMeshLocation<Particle>(ModuleType::MeshLocationAttachment, std::move(mesh)) {
@@ -28,41 +33,52 @@ namespace Limitless::fx {
         MeshLocationAttachment(const MeshLocationAttachment&) = default;
         MeshLocationAttachment& operator=(const MeshLocationAttachment&) noexcept = default;
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, size_t index) noexcept override {
-            const auto selected_mesh = this->getSelectedMesh();
-            const auto vertex_index = this->getVertexIndex(selected_mesh);
-            const auto triangle_pos = this->getTrianglePosition();
-            const auto mesh_position = this->getPositionOnMesh(selected_mesh, vertex_index, triangle_pos.first, triangle_pos.second);
-            particle.position += mesh_position;
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            if (this->updateSamplers() && this->hasSurface()) {
+                resample();
+            }
 
-            cache[index] = { selected_mesh, vertex_index, triangle_pos, mesh_position };
-        }
+            cache.resize(begin + count);
+            last_position.resize(begin + count);
 
-        void deinitialize(const std::vector<size_t>& indices) override {
-            for (const auto& index : indices) {
-                cache.erase(index);
+            if (!this->hasSurface()) {
+                return;
             }
 
-            decltype(cache) new_cache;
+            this->sampleSurface(count);
+            std::copy(this->samples.begin(), this->samples.end(), cache.begin() + begin);
+            this->getPositions(cache.data() + begin, count, last_position.data() + begin);
 
-            size_t i {};
-            for (const auto& [_, c] : cache) {
-                new_cache.emplace(i++, c);
+            for (size_t i = begin; i < begin + count; ++i) {
+                particles.position[i] += last_position[i];
             }
+        }
 
-            cache = std::move(new_cache);
+        void deinitialize(const ParticleRemap& remap) override {
+            remap.apply(cache);
+            remap.apply(last_position);
         }
 
         MeshLocationAttachment* clone() const noexcept override {
             return new MeshLocationAttachment<Particle>(*this);
         }
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, [[maybe_unused]] float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
-            for (size_t i = 0; i < particles.size(); ++i) {
-                auto& [selected_mesh, vertex_index, triangle, last_position] = cache[i];
-                const auto mesh_position = this->getPositionOnMesh(selected_mesh, vertex_index, triangle.first, triangle.second);
-                particles[i].position += mesh_position - last_position;
-                last_position = mesh_position;
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, [[maybe_unused]] float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+            if (this->updateSamplers() && this->hasSurface()) {
+                resample();
+            }
+
+            if (!this->hasSurface()) {
+                return;
+            }
+
+            auto& positions = this->positions;
+            positions.resize(particles.count());
+            this->getPositions(cache.data(), particles.count(), positions.data());
+
+            for (size_t i = 0; i < particles.count(); ++i) {
+                particles.position[i] += positions[i] - last_position[i];
+                last_position[i] = positions[i];
             }
         }
     };
@@ -2,6 +2,9 @@
 
 #include <vector>
 #include <limitless/fx/emitters/abstract_emitter.hpp>
+#include <limitless/fx/particle_storage.hpp>
+#include <limitless/fx/particle_kernels.hpp>
+#include <limitless/fx/modules/distribution.h>
 
 namespace Limitless {
     class Context;
@@ -57,14 +60,57 @@ namespace Limitless::fx {
 
         [[nodiscard]] const auto& getType() const noexcept { return type; }
 
-        virtual void initialize([[maybe_unused]] AbstractEmitter& e, [[maybe_unused]] Particle& p, [[maybe_unused]] size_t index) noexcept {}
+        /*
+         * initializes just emitted particles [begin, begin + count)
+         *
+         * called once per emitted batch, so modules fill whole stream ranges
+         */
+        virtual void initialize([[maybe_unused]] AbstractEmitter& emitter,
+                                [[maybe_unused]] ParticleStorage<Particle>& particles,
+                                [[maybe_unused]] size_t begin,
+                                [[maybe_unused]] size_t count) noexcept {}
 
-        virtual void deinitialize([[maybe_unused]] const std::vector<size_t>& indices) {}
+        // called after dead particles are removed; modules with per-particle state should follow the moves
+        virtual void deinitialize([[maybe_unused]] const ParticleRemap& remap) {}
 
         virtual void update([[maybe_unused]] AbstractEmitter& emitter,
-                            [[maybe_unused]] std::vector<Particle>& particles,
+                            [[maybe_unused]] ParticleStorage<Particle>& particles,
                             [[maybe_unused]] float dt,
                             [[maybe_unused]] Context& ctx,
                             [[maybe_unused]] const Camera& camera) noexcept {}
     };
+
+    /*
+     * samples distribution to stream for count particles
+     *
+     * constant distribution is sampled once and true is returned, so kernels can treat it as uniform value
+     */
+    template<typename T>
+    bool sample(Distribution<T>& distribution, ParticleStream<T>& samples, size_t count) {
+        const auto uniform = distribution.getType() == DistributionType::Const;
+
+        samples.resize(uniform ? 1 : count);
+        distribution.fill(samples.data(), samples.size());
+
+        return uniform;
+    }
+
+    /*
+     * writes curve value at normalized particle age to values
+     *
+     * returns false if distribution is not a curve
+     */
+    template<typename T, typename Particle>
+    bool evaluate(const Distribution<T>& distribution, const ParticleStorage<Particle>& particles, T* values) noexcept {
+        if (distribution.getType() != DistributionType::Curve) {
+            return false;
+        }
+
+        const auto& curve = static_cast<const CurveDistribution<T>&>(distribution);
+        for (size_t i = 0; i < particles.count(); ++i) {
+            values[i] = curve.evaluate(particles.age(i));
+        }
+
+        return true;
+    }
 }
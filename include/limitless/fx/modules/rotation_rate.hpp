@@ -7,6 +7,8 @@ namespace Limitless::fx {
     class RotationRate : public Module<Particle> {
     private:
         std::unique_ptr<Distribution<glm::vec3>> distribution;
+        // sampled rates for current update
+        ParticleStream<glm::vec3> rates;
     public:
         explicit RotationRate(std::unique_ptr<Distribution<glm::vec3>> _distribution) noexcept
             : Module<Particle>(ModuleType::RotationRate)
@@ -18,10 +20,15 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void update(AbstractEmitter& emitter, std::vector<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+        void update(AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
             const auto rot = emitter.getRotation() * emitter.getLocalRotation();
-            for (auto& particle : particles) {
-                particle.rotation += (distribution->get() * rot) * dt;
+            if (sample(*distribution, rates, particles.count())) {
+                kernels::addScaled(particles.rotation.data(), rates[0] * rot, particles.count(), dt);
+            } else {
+                for (auto& rate : rates) {
+                    rate = rate * rot;
+                }
+                kernels::addScaled(particles.rotation.data(), rates.data(), particles.count(), dt);
             }
         }
 
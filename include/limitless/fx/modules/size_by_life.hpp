@@ -7,6 +7,8 @@ namespace Limitless::fx {
     class SizeByLife : public Module<Particle> {
     private:
         std::unique_ptr<Distribution<float>> distribution;
+        // sampled target sizes for current update
+        ParticleStream<float> targets;
     public:
         explicit SizeByLife(std::unique_ptr<Distribution<float>> _distribution) noexcept
             : Module<Particle>(ModuleType::SizeByLife)
@@ -18,12 +20,13 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
-            for (auto& particle : particles) {
-                const auto tick = particle.lifetime / dt;
-                const auto tick_size = (distribution->get() - particle.size) / tick;
-                particle.size += tick_size;
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+            if (evaluate(*distribution, particles, particles.size.data())) {
+                return;
             }
+
+            const auto uniform = sample(*distribution, targets, particles.count());
+            kernels::approach(particles.size.data(), targets.data(), uniform, particles.lifetime.data(), particles.count(), dt);
         }
 
         [[nodiscard]] SizeByLife* clone() const override {
@@ -38,6 +41,8 @@ namespace Limitless::fx {
     class SizeByLife<MeshParticle> : public Module<MeshParticle> {
     private:
         std::unique_ptr<Distribution<glm::vec3>> distribution;
+        // sampled target sizes for current update
+        ParticleStream<glm::vec3> targets;
     public:
         explicit SizeByLife(std::unique_ptr<Distribution<glm::vec3>> _distribution) noexcept
             : Module<MeshParticle>(ModuleType::SizeByLife)
@@ -49,12 +54,13 @@ namespace Limitless::fx {
             : Module<MeshParticle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<MeshParticle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
-            for (auto& particle : particles) {
-                const auto tick = particle.lifetime / dt;
-                const auto tick_size = (distribution->get() - particle.size) / tick;
-                particle.size += tick_size;
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<MeshParticle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+            if (evaluate(*distribution, particles, particles.size.data())) {
+                return;
             }
+
+            const auto uniform = sample(*distribution, targets, particles.count());
+            kernels::approach(particles.size.data(), targets.data(), uniform, particles.lifetime.data(), particles.count(), dt);
         }
 
         [[nodiscard]] SizeByLife* clone() const override {
@@ -14,9 +14,8 @@ namespace Limitless::fx
         float fps;
         // scaling factor to frame-sprite space
         glm::vec2 subUV_factor;
-        // last time updated
-        std::chrono::time_point<std::chrono::steady_clock> last_time;
-        bool first_update {false};
+        // simulation time since last frame switch
+        float frame_time {};
         // texture size
         glm::vec2 texture_size;
         // frame count
@@ -55,34 +54,27 @@ namespace Limitless::fx
             return new SubUV(*this);
         }
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.subUV.x = subUV_factor.x;
-            particle.subUV.y = subUV_factor.y;
-            particle.subUV.z = frames[0].x;
-            particle.subUV.w = frames[0].y;
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            const auto first = glm::vec4{subUV_factor.x, subUV_factor.y, frames[0].x, frames[0].y};
+            std::fill_n(particles.subUV.begin() + begin, count, first);
         }
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, [[maybe_unused]] float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
-            if (first_update) {
-                last_time = std::chrono::steady_clock::now();
-                first_update = false;
-            }
-
-            auto current_time = std::chrono::steady_clock::now();
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+            frame_time += dt;
 
-            if (std::chrono::duration_cast<std::chrono::duration<float>>(current_time - last_time).count() >= (1.0f / fps)) {
-                for (auto& p : particles) {
+            if (frame_time >= (1.0f / fps)) {
+                for (auto& subUV : particles.subUV) {
 
-                    auto current_frame = glm::vec2{p.subUV.z, p.subUV.w};
+                    auto current_frame = glm::vec2{subUV.z, subUV.w};
                     auto it = std::find(frames.begin(), frames.end(), current_frame);
 
                     auto next_frame = (*it == frames.back()) ? frames[0] : *(++it);
 
-                    p.subUV.z = next_frame.x;
-                    p.subUV.w = next_frame.y;
+                    subUV.z = next_frame.x;
+                    subUV.w = next_frame.y;
                 }
 
-                last_time = current_time;
+                frame_time = 0.0f;
             }
         }
 
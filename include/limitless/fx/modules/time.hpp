@@ -13,14 +13,12 @@ namespace Limitless::fx {
 
         Time(const Time& module) = default;
 
-        void initialize([[maybe_unused]] AbstractEmitter& emitter, Particle& particle, [[maybe_unused]] size_t index) noexcept override {
-            particle.time = 0.0f;
+        void initialize([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, size_t begin, size_t count) noexcept override {
+            std::fill_n(particles.time.begin() + begin, count, 0.0f);
         }
 
-        void update([[maybe_unused]] AbstractEmitter& emitter, std::vector<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
-            for (auto& particle : particles) {
-                particle.time += dt;
-            }
+        void update([[maybe_unused]] AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+            kernels::add(particles.time.data(), particles.count(), dt);
         }
 
         [[nodiscard]] Time* clone() const override {
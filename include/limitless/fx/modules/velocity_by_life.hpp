@@ -7,6 +7,8 @@ namespace Limitless::fx {
     class VelocityByLife : public Module<Particle> {
     private:
         std::unique_ptr<Distribution<glm::vec3>> distribution;
+        // sampled target velocities for current update
+        ParticleStream<glm::vec3> targets;
     public:
         explicit VelocityByLife(std::unique_ptr<Distribution<glm::vec3>> _distribution) noexcept
             : Module<Particle>(ModuleType::VelocityByLife)
@@ -18,13 +20,21 @@ namespace Limitless::fx {
             : Module<Particle>(module.type)
             , distribution {module.distribution->clone()} {}
 
-        void update(AbstractEmitter& emitter, std::vector<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
+        void update(AbstractEmitter& emitter, ParticleStorage<Particle>& particles, float dt, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) noexcept override {
             const auto rot = emitter.getRotation() * emitter.getLocalRotation();
-            for (auto& particle : particles) {
-                const auto tick = particle.lifetime / dt;
-                const auto tick_vel = (rot * distribution->get() - particle.velocity) / tick;
-                particle.velocity += tick_vel;
+
+            if (evaluate(*distribution, particles, particles.velocity.data())) {
+                for (auto& velocity : particles.velocity) {
+                    velocity = rot * velocity;
+                }
+                return;
+            }
+
+            const auto uniform = sample(*distribution, targets, particles.count());
+            for (auto& target : targets) {
+                target = rot * target;
             }
+            kernels::approach(particles.velocity.data(), targets.data(), uniform, particles.lifetime.data(), particles.count(), dt);
         }
 
         [[nodiscard]] VelocityByLife* clone() const override {
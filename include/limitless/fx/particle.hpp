@@ -90,11 +90,12 @@ namespace Limitless::fx
 
         bool build {};
 
-        std::chrono::time_point<std::chrono::steady_clock> speed_start {};
+        // simulation time since speed started
+        std::chrono::duration<float> speed_time {};
 
         std::chrono::duration<float> rebuild_delta {1.0f};
         std::vector<glm::vec3> derivative_line;
-        std::chrono::time_point<std::chrono::steady_clock> last_rebuild {};
+        std::chrono::duration<float> since_rebuild {};
     };
 
     // beam particle representation on GPU for mapping
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+/*
+ * Vectorized update kernels over particle streams
+ *
+ * AVX is used when the engine is compiled with it, SSE2 otherwise on x86;
+ * every kernel has scalar fallback for the tail and other platforms
+ */
+namespace Limitless::fx::kernels {
+    // values[i] += delta
+    void add(float* values, size_t count, float delta) noexcept;
+
+    // values[i] += rates[i] * scale
+    void addScaled(float* values, const float* rates, size_t count, float scale) noexcept;
+    void addScaled(glm::vec3* values, const glm::vec3* rates, size_t count, float scale) noexcept;
+
+    // values[i] += rate * scale
+    void addScaled(glm::vec3* values, const glm::vec3& rate, size_t count, float scale) noexcept;
+
+    // values[i] = clamp(values[i], min, max)
+    void clamp(glm::vec4* values, size_t count, float min, float max) noexcept;
+
+    /*
+     * moves values towards targets so that they are reached at the end of particle lifetime
+     *
+     * values[i] += (target - values[i]) * dt / lifetime[i]
+     *
+     * if uniform is set, targets points to single value for all particles
+     */
+    void approach(float* values, const float* targets, bool uniform, const float* lifetime, size_t count, float dt) noexcept;
+    void approach(glm::vec3* values, const glm::vec3* targets, bool uniform, const float* lifetime, size_t count, float dt) noexcept;
+    void approach(glm::vec4* values, const glm::vec4* targets, bool uniform, const float* lifetime, size_t count, float dt) noexcept;
+}
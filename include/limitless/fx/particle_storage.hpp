@@ -0,0 +1,131 @@
+#pragma once
+
+#include <limitless/fx/particle.hpp>
+#include <limitless/util/aligned_allocator.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace Limitless::fx {
+    // aligned to AVX register width
+    static constexpr auto PARTICLE_STREAM_ALIGNMENT = 32;
+
+    template<typename T>
+    using ParticleStream = std::vector<T, AlignedAllocator<T, PARTICLE_STREAM_ALIGNMENT>>;
+
+    /*
+     * particle state that is specific to particle type and is not processed by simd kernels
+     */
+    template<typename Particle>
+    struct ParticleExtra {};
+
+    template<>
+    struct ParticleExtra<BeamParticle> {
+        float displacement {0.5f};
+        glm::vec3 target {2.0f};
+        float offset {0.1f};
+        float speed {};
+        float length {};
+
+        bool build {};
+
+        std::chrono::duration<float> speed_time {};
+
+        std::chrono::duration<float> rebuild_delta {1.0f};
+        std::vector<glm::vec3> derivative_line;
+        std::chrono::duration<float> since_rebuild {};
+    };
+
+    /*
+     * describes particle relocation after dead particles are removed
+     *
+     * moves should be applied in order, after that per-particle state is truncated to count
+     */
+    struct ParticleRemap {
+        // {from, to} indices
+        std::vector<std::pair<size_t, size_t>> moves;
+        // particles count after removal
+        size_t count {};
+
+        // applies remap to module side state that is indexed by particle
+        template<typename Container>
+        void apply(Container& container) const {
+            for (const auto& [from, to] : moves) {
+                container[to] = std::move(container[from]);
+            }
+            container.resize(count);
+        }
+    };
+
+    /*
+     * Structure-of-arrays particle storage
+     *
+     * every particle attribute lives in its own aligned stream,
+     * so modules touch only the memory they need and can be processed with simd kernels;
+     *
+     * AoS particle layout is produced only by pack() for GPU upload
+     */
+    template<typename Particle>
+    class ParticleStorage {
+    public:
+        using SizeType = decltype(Particle::size);
+
+        ParticleStream<glm::vec4> color;
+        ParticleStream<glm::vec4> subUV;
+        ParticleStream<glm::vec4> properties;
+        ParticleStream<glm::vec3> acceleration;
+        ParticleStream<float> lifetime;
+        ParticleStream<glm::vec3> position;
+        ParticleStream<SizeType> size;
+        ParticleStream<glm::vec3> rotation;
+        ParticleStream<float> time;
+        ParticleStream<glm::vec3> velocity;
+        // lifetime particle was spawned with; stays on CPU
+        ParticleStream<float> lifespan;
+        std::vector<ParticleExtra<Particle>> extra;
+
+        ParticleStorage() = default;
+        ~ParticleStorage() = default;
+
+        ParticleStorage(const ParticleStorage&) = default;
+        ParticleStorage& operator=(const ParticleStorage&) = default;
+
+        ParticleStorage(ParticleStorage&&) noexcept = default;
+        ParticleStorage& operator=(ParticleStorage&&) noexcept = default;
+
+        [[nodiscard]] size_t count() const noexcept { return lifetime.size(); }
+        [[nodiscard]] bool empty() const noexcept { return lifetime.empty(); }
+
+        // normalized age in [0, 1]
+        [[nodiscard]] float age(size_t index) const noexcept {
+            return glm::clamp(1.0f - lifetime[index] / lifespan[index], 0.0f, 1.0f);
+        }
+
+        void reserve(size_t count);
+        void clear() noexcept;
+
+        // scatters particle to streams
+        void push(const Particle& particle);
+
+        // appends count copies of prototype growing every stream once
+        void append(const Particle& prototype, size_t count);
+
+        // stores current lifetime of particles [begin, count()) as their lifespan; called once emitted particles are initialized
+        void captureLifespan(size_t begin) noexcept;
+
+        // gathers particle from streams
+        [[nodiscard]] Particle get(size_t index) const;
+        void set(size_t index, const Particle& particle);
+
+        /*
+         * removes particles with non-positive lifetime in one pass
+         *
+         * dead particles are replaced by alive ones from the end, so the order is not preserved;
+         * returns true if anything was removed and remap is filled
+         */
+        bool kill(ParticleRemap& remap);
+
+        // writes AoS representation of all particles to dst, that should fit count() particles
+        void pack(Particle* dst) const noexcept;
+    };
+}
@@ -2,22 +2,32 @@
 
 #include <limitless/fx/emitters/abstract_emitter.hpp>
 #include <limitless/fx/emitters/beam_emitter.hpp>
+#include <limitless/fx/renderers/particle_staging.hpp>
 
 namespace Limitless::fx {
     template<>
     class EmitterRenderer<BeamParticle> : public AbstractEmitterRenderer {
     private:
-        VertexStream<BeamParticleMapping> stream;
+        ParticleStaging<BeamParticleMapping> staging;
 
         const UniqueEmitterShader unique_type;
     public:
         EmitterRenderer(const BeamEmitter& emitter)
-            : stream {emitter.getSpawn().max_count * EMITTER_STORAGE_INSTANCE_COUNT, VertexStreamUsage::Dynamic, VertexStreamDraw::Triangles}
+            : staging {Buffer::Type::Array, emitter.getSpawn().max_count * EMITTER_STORAGE_INSTANCE_COUNT}
             , unique_type {emitter.getUniqueShaderType()} {
         }
 
-        void update(ParticleCollector<BeamParticleMapping>& collector) {
-            stream.update(collector.yield());
+        void update() {
+            size_t count = 0;
+            for (const auto* emitter : emitters) {
+                count += static_cast<const BeamEmitter&>(*emitter).getParticles().size();
+            }
+
+            auto* particles = staging.map(count);
+            for (const auto* emitter : emitters) {
+                const auto& vertices = static_cast<const BeamEmitter&>(*emitter).getParticles();
+                particles = std::copy(vertices.begin(), vertices.end(), particles);
+            }
         }
 
         void draw(Context& ctx,
@@ -47,7 +57,7 @@ namespace Limitless::fx {
 
             shader.use();
 
-            stream.draw();
+            staging.draw(VertexStreamDraw::Triangles);
         }
     };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include <vector>
 
 namespace Limitless::fx {
     class AbstractEmitter;
@@ -8,7 +9,11 @@ namespace Limitless::fx {
     static constexpr auto EMITTER_STORAGE_INSTANCE_COUNT = 3;
 
     class AbstractEmitterRenderer {
+    public:
+        // emitters drawn by renderer in current frame; filled by EmitterCollector
+        std::vector<const AbstractEmitter*> emitters;
 
+        virtual ~AbstractEmitterRenderer() = default;
     };
 
     template<typename Particle>
@@ -1,48 +1,36 @@
 #pragma once
 
 #include <limitless/fx/renderers/emitter_renderer.hpp>
+#include <limitless/fx/renderers/particle_staging.hpp>
+#include <limitless/fx/emitters/mesh_emitter.hpp>
 
 namespace Limitless::fx {
     template<>
     class EmitterRenderer<MeshParticle> : public AbstractEmitterRenderer {
     private:
-        std::shared_ptr<Buffer> buffer;
-        uint64_t max_particle_count {};
-
-        uint64_t current_particle_count {};
+        ParticleStaging<MeshParticle> staging;
 
         const UniqueEmitterShader unique_type;
 
-        void checkStorageSize(uint64_t count) {
-            if (count > max_particle_count) {
-                max_particle_count = count;
-                BufferBuilder builder;
-                buffer = builder.setTarget(Buffer::Type::ShaderStorage)
-                        .setUsage(Buffer::Usage::DynamicDraw)
-                        .setAccess(Buffer::MutableAccess::WriteOrphaning)
-                        .setDataSize(sizeof(MeshParticle) * max_particle_count)
-                        .build();
-            }
-        }
-
         static constexpr auto SHADER_MESH_BUFFER_NAME = "mesh_emitter_particles";
     public:
         explicit EmitterRenderer(const MeshEmitter& emitter)
-            : max_particle_count {emitter.getSpawn().max_count * EMITTER_STORAGE_INSTANCE_COUNT}
+            : staging {Buffer::Type::ShaderStorage, emitter.getSpawn().max_count * EMITTER_STORAGE_INSTANCE_COUNT}
             , unique_type {emitter.getUniqueShaderType()} {
-            BufferBuilder builder;
-            buffer = builder .setTarget(Buffer::Type::ShaderStorage)
-                    .setUsage(Buffer::Usage::DynamicDraw)
-                    .setAccess(Buffer::MutableAccess::WriteOrphaning)
-                    .setDataSize(sizeof(MeshParticle) * max_particle_count)
-                    .build();
         }
 
-        void update(ParticleCollector<MeshParticle>& collector) {
-            const auto& particles = collector.yield();
-            checkStorageSize(particles.size());
-            current_particle_count = particles.size();
-            buffer->mapData(particles.data(), sizeof(MeshParticle) * current_particle_count);
+        void update() {
+            size_t count = 0;
+            for (const auto* emitter : emitters) {
+                count += static_cast<const MeshEmitter&>(*emitter).getParticles().count();
+            }
+
+            auto* particles = staging.map(count);
+            for (const auto* emitter : emitters) {
+                const auto& storage = static_cast<const MeshEmitter&>(*emitter).getParticles();
+                storage.pack(particles);
+                particles += storage.count();
+            }
         }
 
         void draw(Context& ctx,
@@ -52,7 +40,7 @@ namespace Limitless::fx {
                   const ms::Material& material,
                   ms::Blending blending,
                   const UniformSetter& setter) const {
-            if (current_particle_count == 0 || material.getBlending() != blending) {
+            if (staging.getCount() == 0 || material.getBlending() != blending) {
                 return;
             }
 
@@ -69,11 +57,11 @@ namespace Limitless::fx {
 
             setter(shader);
 
-            buffer->bindBase(ContextState::getState(glfwGetCurrentContext())->getIndexedBuffers().getBindingPoint(IndexedBuffer::Type::ShaderStorage, SHADER_MESH_BUFFER_NAME));
+            staging.getBuffer().bindBase(ContextState::getState(glfwGetCurrentContext())->getIndexedBuffers().getBindingPoint(IndexedBuffer::Type::ShaderStorage, SHADER_MESH_BUFFER_NAME));
 
             shader.use();
 
-            mesh->draw_instanced(current_particle_count);
+            mesh->draw_instanced(staging.getCount());
         }
     };
 }
\ No newline at end of file
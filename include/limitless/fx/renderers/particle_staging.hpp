@@ -0,0 +1,73 @@
+#pragma once
+
+#include <limitless/fx/particle.hpp>
+#include <limitless/core/mapped_ring_buffer.hpp>
+#include <limitless/core/vertex_array.hpp>
+#include <limitless/core/abstract_vertex_stream.hpp>
+
+#include <array>
+#include <optional>
+#include <type_traits>
+
+namespace Limitless::fx {
+    /*
+     * Particle storage in mapped ring buffer
+     *
+     * particles are packed by CPU straight into mapped memory of current region,
+     * which is drawn as vertices or read from shader storage
+     */
+    template<typename Particle>
+    class ParticleStaging {
+    private:
+        MappedRingBuffer<Particle> storage;
+        // layout of every region for particles that are drawn as vertices
+        std::array<std::optional<VertexArray>, MAPPED_RING_BUFFER_REGIONS> vertex_arrays;
+        size_t count {};
+
+        void setLayout() {
+            // mesh particles are read from shader storage by instance
+            if constexpr (!std::is_same_v<Particle, MeshParticle>) {
+                for (size_t i = 0; i < vertex_arrays.size(); ++i) {
+                    vertex_arrays[i].emplace();
+                    *vertex_arrays[i] << std::pair<Particle, const std::shared_ptr<Buffer>&>(Particle{}, storage.getBuffer(i));
+                }
+            }
+        }
+    public:
+        ParticleStaging(Buffer::Type target, size_t capacity)
+            : storage {target, capacity} {
+            setLayout();
+        }
+
+        /*
+         * returns memory of next region that fits _count particles
+         *
+         * storage grows if needed; pointer is valid until next call
+         */
+        Particle* map(size_t _count) {
+            const auto capacity = storage.getCapacity();
+            auto* data = storage.map(_count);
+
+            // buffers were replaced
+            if (storage.getCapacity() != capacity) {
+                setLayout();
+            }
+
+            count = _count;
+            return data;
+        }
+
+        [[nodiscard]] size_t getCount() const noexcept { return count; }
+        [[nodiscard]] const Buffer& getBuffer() const noexcept { return *storage.getBuffer(); }
+
+        void draw(VertexStreamDraw mode) const noexcept {
+            if (count == 0) {
+                return;
+            }
+
+            vertex_arrays[storage.getRegion()]->bind();
+
+            glDrawArrays(static_cast<GLenum>(mode), 0, static_cast<GLsizei>(count));
+        }
+    };
+}
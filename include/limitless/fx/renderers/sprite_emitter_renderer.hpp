@@ -1,7 +1,7 @@
 #pragma once
 
 #include <limitless/fx/renderers/emitter_renderer.hpp>
-#include <limitless/fx/emitters/visitor_collector.hpp>
+#include <limitless/fx/renderers/particle_staging.hpp>
 #include <limitless/fx/emitters/sprite_emitter.hpp>
 
 #include <limitless/core/shader_program.hpp>
@@ -12,17 +12,28 @@ namespace Limitless::fx {
     template<>
     class EmitterRenderer<SpriteParticle> : public AbstractEmitterRenderer {
     private:
-        VertexStream<SpriteParticle> stream;
+        ParticleStaging<SpriteParticle> staging;
 
         const UniqueEmitterShader unique_shader;
     public:
         explicit EmitterRenderer(const SpriteEmitter& emitter)
-            : stream {emitter.getSpawn().max_count * EMITTER_STORAGE_INSTANCE_COUNT, VertexStreamUsage::Dynamic, VertexStreamDraw::Points}
+            : staging {Buffer::Type::Array, emitter.getSpawn().max_count * EMITTER_STORAGE_INSTANCE_COUNT}
             , unique_shader {emitter.getUniqueShaderType()} {
         }
 
-        void update(ParticleCollector<SpriteParticle>& collector) {
-            stream.update(collector.yield());
+        void update() {
+            size_t count = 0;
+            for (const auto* emitter : emitters) {
+                count += static_cast<const SpriteEmitter&>(*emitter).getParticles().count();
+            }
+
+            // AoS layout is produced only here, straight into GPU memory
+            auto* particles = staging.map(count);
+            for (const auto* emitter : emitters) {
+                const auto& storage = static_cast<const SpriteEmitter&>(*emitter).getParticles();
+                storage.pack(particles);
+                particles += storage.count();
+            }
         }
 
         void draw(Context& ctx,
@@ -52,7 +63,7 @@ namespace Limitless::fx {
 
             shader.use();
 
-            stream.draw();
+            staging.draw(VertexStreamDraw::Points);
         }
     };
 }
@@ -3,6 +3,8 @@
 #include <limitless/util/bounding_box.hpp>
 #include <limitless/instances/instance_attachment.hpp>
 #include <limitless/util/matrix_stack.hpp>
+#include <optional>
+#include <utility>
 
 namespace Limitless {
     enum class ShaderPass;
@@ -12,11 +14,26 @@ namespace Limitless {
     class Assets;
     class Context;
     class Camera;
+    class RenderQueue;
 
 	namespace ms {
 		enum class Blending;
 	}
 
+    class AbstractInstance;
+    class AbstractMesh;
+
+    struct RayHit {
+        AbstractInstance* instance {};
+        std::shared_ptr<AbstractMesh> mesh;
+        // index of triangle in mesh index list
+        uint32_t triangle {};
+        // weights of second and third vertex of triangle, first one is 1 - x - y
+        glm::vec2 barycentric {};
+        // distance along ray in units of its direction
+        float distance {};
+    };
+
 	class AbstractInstance : public InstanceAttachment {
     private:
         static inline uint64_t next_id {1};
@@ -35,6 +52,13 @@ namespace Limitless {
 
 		BoundingBox bounding_box {};
 
+		// model matrix is rebuilt only after position, rotation or scale change
+		bool model_dirty {true};
+		// final matrix and bounding box are recomputed only after model, transformation or parent matrix change
+		bool final_dirty {true};
+		// bounding box was recomputed since it was last taken by spatial index
+		bool bounds_changed {true};
+
 		bool shadow_cast {true};
 		bool outlined {};
 		bool hidden {};
@@ -62,7 +86,16 @@ namespace Limitless {
         [[nodiscard]] const auto& getModelMatrix() const noexcept { return model_matrix; }
         [[nodiscard]] const auto& getTransformationMatrix() const noexcept { return transformation_matrix; }
         [[nodiscard]] const auto& getFinalMatrix() const noexcept { return final_matrix; }
-        [[nodiscard]] const auto& getBoundingBox() noexcept { updateBoundingBox(); return bounding_box; }
+        [[nodiscard]] const auto& getBoundingBox() const noexcept { return bounding_box; }
+
+        // whether bounding box encloses drawn geometry; instances without one are never culled
+        [[nodiscard]] virtual bool hasBoundingBox() const noexcept { return false; }
+
+        // returns whether bounding box changed since previous call; used by scene to refit only moved instances
+        bool takeBoundsChange() noexcept { return std::exchange(bounds_changed, false); }
+
+        // closest hit of world space ray with drawn triangles within max_distance
+        [[nodiscard]] virtual std::optional<RayHit> raycast([[maybe_unused]] const glm::vec3& origin, [[maybe_unused]] const glm::vec3& direction, [[maybe_unused]] float max_distance) { return std::nullopt; }
 
 		void removeOutline() noexcept;
 		void removeShadow() noexcept;
@@ -84,12 +117,30 @@ namespace Limitless {
         virtual AbstractInstance& setTransformation(const glm::mat4& transformation);
         virtual AbstractInstance& setParent(const glm::mat4& parent);
 
-		virtual void updateAttachments(Context& context, const Camera& camera);
-		virtual void update(Context& context, const Camera& camera);
+        /*
+         * recomputes matrices and bounding box if transform changed since previous call
+         *
+         * returns whether final matrix changed, so attachments need new parent matrix;
+         * touches only this instance, so instances of different branches can be updated concurrently
+         */
+        bool updateTransform() noexcept;
+
+		/*
+		 * updates attachments and their attachments after this instance
+		 *
+		 * only for instances updated outside of scene; scene updates every node of its flattened hierarchy by itself
+		 */
+		virtual void updateAttachments(Context& context, const Camera& camera, float dt);
+
+		// updates this instance only; dt is simulation time in seconds passed since previous update
+		virtual void update(Context& context, const Camera& camera, float dt);
 
         // draws instance with no extra uniform setting
         void draw(Context& ctx, const Assets& assets, ShaderPass shader_type, ms::Blending blending);
 
         virtual void draw(Context& ctx, const Assets& assets, ShaderPass shader_type, ms::Blending blending, const UniformSetter& uniform_set) = 0;
+
+        // puts draw calls of instance into queue; by default instance is drawn as a whole by draw()
+        virtual void enqueue(RenderQueue& queue);
     };
 }
@@ -20,11 +20,13 @@ namespace Limitless {
         std::unordered_map<std::string, std::unique_ptr<fx::AbstractEmitter>> emitters;
         std::string name;
 
+        // updateEmitters() was called since previous update(), so update() does not simulate them again
+        bool emitters_updated {};
+
         friend void swap(EffectInstance&, EffectInstance&) noexcept;
         bool isDone() const noexcept;
 
         void updateBoundingBox() noexcept override;
-        void updateEmitters(Context& context, const Camera& camera) const noexcept;
 
         friend class fx::EffectBuilder;
         friend class EffectSerializer;
@@ -61,7 +63,15 @@ namespace Limitless {
         const auto& getEmitters() const noexcept { return emitters; }
         auto& getEmitters() noexcept { return emitters; }
 
-        void update(Context& context, const Camera& camera) override;
+        void update(Context& context, const Camera& camera, float dt) override;
+
+        /*
+         * simulates emitters and updates done state
+         *
+         * touches only emitters of this instance, so different effect instances
+         * can be updated from different threads after their transforms are updated
+         */
+        void updateEmitters(Context& context, const Camera& camera, float dt) noexcept;
 
         void draw(Context& ctx, const Assets& assets, ShaderPass shader_type, ms::Blending blending, const UniformSetter& uniform_set) override;
     };
@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <string>
+#include <atomic>
 
 namespace Limitless {
 	class AbstractInstance;
@@ -14,6 +15,12 @@ namespace Limitless {
 	class InstanceAttachment {
 	private:
 		std::unordered_map<uint64_t, std::unique_ptr<AbstractInstance>> attachments;
+
+		// structure version of the hierarchy this instance is flattened into, changed on attach and detach;
+		// not copied, copy belongs to no hierarchy until it is added
+		std::atomic<uint64_t>* structure_version {};
+
+		void notifyStructureChange() noexcept;
 	protected:
 		InstanceAttachment& setParent(const glm::mat4& parent) noexcept;
 	public:
@@ -21,9 +28,10 @@ namespace Limitless {
 		virtual ~InstanceAttachment() = default;
 
 		InstanceAttachment(const InstanceAttachment&);
-		InstanceAttachment(InstanceAttachment&&) = default;
+		InstanceAttachment(InstanceAttachment&& attachment) noexcept
+			: attachments {std::move(attachment.attachments)} {}
 
-		void updateAttachments(Context& context, const Camera& camera);
+		void updateAttachments(Context& context, const Camera& camera, float dt);
 
 		void attach(std::unique_ptr<AbstractInstance> attachment);
 		void detach(uint64_t id);
@@ -34,10 +42,14 @@ namespace Limitless {
 		auto& getAttachments() noexcept { return attachments; }
 		const auto& getAttachments() const noexcept { return attachments; }
 
+		// set by TransformHierarchy on build
+		void setStructureVersion(std::atomic<uint64_t>* version) noexcept { structure_version = version; }
+
 		template<typename Instance, typename... Args>
 		auto& attach(Args&&... args) {
 			auto instance = std::make_unique<Instance>(std::forward<Args>(args)...);
 			const auto [it, success] = attachments.emplace(instance->getId(), std::move(instance));
+			notifyStructureChange();
 			return it->second;
 		}
 	};
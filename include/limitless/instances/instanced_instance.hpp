@@ -39,7 +39,7 @@ namespace Limitless {
             assert("RIP");
         }
 
-        void updateBuffer(Context& context, const Camera& camera) {
+        void updateBuffer(Context& context, const Camera& camera, float dt) {
             checkSize();
 
             std::vector<glm::mat4> data;
@@ -51,7 +51,9 @@ namespace Limitless {
 //                    continue;
 //                }
 
-                instance->update(context, camera);
+                // copies are not part of scene hierarchy
+                instance->update(context, camera, dt);
+                instance->updateAttachments(context, camera, dt);
 
                 data.emplace_back(instance->getModelMatrix());
             }
@@ -101,14 +103,14 @@ namespace Limitless {
         ModelInstance& at(size_t index) { return *instances.at(index); }
         [[nodiscard]] const ModelInstance& at(size_t index) const { return *instances.at(index); }
 
-        void update(Context& context, const Camera& camera) override {
+        void update(Context& context, const Camera& camera, float dt) override {
             if (instances.empty()) {
                 return;
             }
 
-            AbstractInstance::update(context, camera);
+            AbstractInstance::update(context, camera, dt);
 
-            updateBuffer(context, camera);
+            updateBuffer(context, camera, dt);
         }
 
         void draw(Context& ctx, const Assets& assets, ShaderPass pass, ms::Blending blending, const UniformSetter& uniform_set) override {
@@ -4,6 +4,7 @@
 #include <limitless/models/abstract_mesh.hpp>
 #include <limitless/ms/blending.hpp>
 #include <limitless/core/uniform_setter.hpp>
+#include <vector>
 
 namespace Limitless {
     class Assets;
@@ -15,6 +16,13 @@ namespace Limitless {
         std::shared_ptr<AbstractMesh> mesh;
         MaterialInstance material;
         bool hidden {};
+
+        // meshes of coarser levels of detail, lods[i] is level i + 1
+        std::vector<std::shared_ptr<AbstractMesh>> lods;
+        uint32_t lod {};
+        uint32_t shadow_lod {};
+
+        [[nodiscard]] const std::shared_ptr<AbstractMesh>& getMesh(ShaderPass pass) const noexcept;
     public:
         MeshInstance(std::shared_ptr<AbstractMesh> mesh, const std::shared_ptr<ms::Material>& material) noexcept;
         ~MeshInstance() = default;
@@ -24,6 +32,16 @@ namespace Limitless {
 
         void update();
 
+        // mesh of selected level of detail
+        [[nodiscard]] const auto& getMesh() const noexcept { return getLevelMesh(lod); }
+        // mesh of level, the coarsest one for levels past it
+        [[nodiscard]] const std::shared_ptr<AbstractMesh>& getLevelMesh(uint32_t level) const noexcept;
+        [[nodiscard]] auto getLevelOfDetail() const noexcept { return lod; }
+        [[nodiscard]] auto getLevelCount() const noexcept { return static_cast<uint32_t>(lods.size()) + 1; }
+
+        void addLevelOfDetail(std::shared_ptr<AbstractMesh> mesh);
+        // shadow level is used by shadow passes and can be coarser; levels are clamped to available ones
+        void setLevelOfDetail(uint32_t level, uint32_t shadow_level) noexcept;
         [[nodiscard]] const auto& getMaterial() const noexcept { return material; }
         [[nodiscard]] auto& getMaterial() noexcept { return material; }
         [[nodiscard]] bool isHidden() const noexcept { return hidden; }
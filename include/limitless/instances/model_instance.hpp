@@ -2,17 +2,34 @@
 
 #include <limitless/instances/abstract_instance.hpp>
 #include <limitless/instances/mesh_instance.hpp>
+#include <limitless/models/model.hpp>
 
 namespace Limitless {
     class AbstractModel;
+    struct TriangleHit;
 
     class ModelInstance : public AbstractInstance {
     protected:
         std::unordered_map<std::string, MeshInstance> meshes;
         std::shared_ptr<AbstractModel> model;
 
+        // fraction of level screen size by which projected size should pass it to switch level
+        static constexpr auto LOD_HYSTERESIS = 0.1f;
+
+        // levels of model, null if it has none
+        const std::vector<Model::LevelOfDetail>* lod_levels {};
+        uint32_t lod {};
+        // shadow passes draw this many levels coarser
+        uint32_t shadow_lod_bias {1};
+
         void updateBoundingBox() noexcept override;
+        // selects level by projected size of bounding box
+        void updateLevelOfDetail(const Camera& camera) noexcept;
+        void applyLevelOfDetail() noexcept;
         ModelInstance(ModelShader shader, decltype(model) model, const glm::vec3& position);
+
+        // hit of mesh in bind pose with model space ray
+        static std::optional<TriangleHit> raycastMesh(const MeshInstance& mesh, const glm::vec3& origin, const glm::vec3& direction, float max_distance);
     public:
         // model constructor
         ModelInstance(decltype(model) model, const glm::vec3& position = glm::vec3{0.0f});
@@ -25,12 +42,19 @@ namespace Limitless {
         ModelInstance(const ModelInstance&) = default;
         ModelInstance(ModelInstance&&) noexcept = default;
 
-        void update(Context &context, const Camera &camera) override;
+        void update(Context &context, const Camera &camera, float dt) override;
 
         ModelInstance* clone() noexcept override;
 
         const auto& getAbstractModel() const noexcept { return *model; }
 
+        [[nodiscard]] auto getLevelOfDetail() const noexcept { return lod; }
+        void setShadowLodBias(uint32_t bias) noexcept;
+
+        [[nodiscard]] bool hasBoundingBox() const noexcept override { return true; }
+
+        std::optional<RayHit> raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) override;
+
         MeshInstance& operator[](const std::string& mesh);
 
         const auto& getMeshes() const noexcept { return meshes; }
@@ -38,5 +62,7 @@ namespace Limitless {
 
         using AbstractInstance::draw;
         void draw(Context& ctx, const Assets& assets, ShaderPass shader_type, ms::Blending blending, const UniformSetter& uniform_setter) override;
+
+        void enqueue(RenderQueue& queue) override;
     };
 }
\ No newline at end of file
@@ -7,24 +7,84 @@
 
 namespace Limitless {
 	class Buffer;
+    struct VertexNormalTangent;
+    template <typename Vertex> class SkinnedVertexStream;
+
+    // how animation layer is applied over base pose
+    enum class LayerBlending {
+        // layer pose replaces base pose by its weight
+        Override,
+        // difference between layer pose and first frame of its animation is added to base pose
+        Additive
+    };
 
     class SkeletalInstance final : public ModelInstance, public SocketAttachment<> {
     private:
+        struct AnimationTrack {
+            const Animation* animation {};
+            // positions of playback in keyframes of every animation node
+            std::vector<KeyCursor> cursors;
+            // simulation time since animation started
+            std::chrono::duration<double> duration {0.0};
+            float weight {1.0f};
+            // weight change per second while track fades in
+            float fade_speed {};
+        };
+
+        struct AnimationLayer {
+            AnimationTrack track;
+            // empty mask applies layer to all bones
+            BoneMask mask;
+            LayerBlending blending {};
+        };
+
+        // storage that shader reads bone transforms of instance from; not copied, so clones get their own
+        struct BoneBinding {
+            // shared storage of current frame, set by writeBones and released by update
+            std::shared_ptr<Buffer> storage;
+            uint32_t offset {};
+            // storage of instance drawn without shared one, created on first such draw
+            std::shared_ptr<Buffer> own;
+            // own storage has transforms of current frame
+            bool own_uploaded {};
+
+            BoneBinding() = default;
+            BoneBinding(const BoneBinding&) noexcept {}
+            BoneBinding& operator=(const BoneBinding&) noexcept { return *this = BoneBinding{}; }
+            BoneBinding(BoneBinding&&) noexcept = default;
+            BoneBinding& operator=(BoneBinding&&) noexcept = default;
+        };
+
         std::vector<glm::mat4> bone_transform;
-        std::shared_ptr<Buffer> bone_buffer;
+        BoneBinding bones;
 
-        const Animation* animation {};
+        // base pose, the newest track is last and fades in over older ones
+        std::vector<AnimationTrack> tracks;
+        // applied over base pose in order
+        std::vector<AnimationLayer> layers;
         bool paused {};
 
-        std::chrono::time_point<std::chrono::steady_clock> last_time;
-        std::chrono::duration<double> animation_duration;
+        // animate() was called since previous update(), so update() does not animate again
+        bool animated {};
+
+        // world space vertices of skinned mesh, reused between raycasts
+        std::vector<glm::vec3> skinned_positions;
 
         void updateBoundingBox() noexcept override;
-        void initializeBuffer();
 
-        void updateAnimationFrame();
-        const AnimationNode* findAnimationNode(const Bone& bone) const noexcept;
+        [[nodiscard]] glm::vec3 skinVertex(const VertexBoneWeight& bone_weight, const glm::vec3& position) const noexcept;
+
+        // shared storage if instance was written this frame, otherwise own storage with uploaded transforms
+        Buffer& getBoneBuffer(uint32_t& offset);
+
+        [[nodiscard]] AnimationTrack makeTrack(const std::string& name) const;
+        void advanceTracks(float dt) noexcept;
+        void updateAnimationFrame(float dt);
     public:
+        // shader storage block of bone transforms and index of the first bone of instance in it
+        static constexpr auto BONE_BUFFER_NAME = "bone_buffer";
+        static constexpr auto BONE_OFFSET_NAME = "_bone_offset";
+
         SkeletalInstance(std::shared_ptr<AbstractModel> m, const glm::vec3& position);
         ~SkeletalInstance() override = default;
 
@@ -38,20 +98,62 @@ namespace Limitless {
 
         SkeletalInstance* clone() noexcept override;
 
-	    void updateAttachments(Context& context, const Camera& camera) override;
-	    void update(Context& context, const Camera& camera) override;
+        /*
+         * advances animation, computes bone transforms and sets socket attachment transformations
+         *
+         * does not issue GL calls and touches only this instance and its attachments,
+         * so different instances are animated concurrently; bones are written to storage by writeBones()
+         */
+        void animate(float dt);
+
+        // animates if animate() was not called since previous update
+	    void update(Context& context, const Camera& camera, float dt) override;
 
+        /*
+         * copies bone transforms to palette at offset, palette is mapped memory of storage
+         *
+         * called by Scene for every skeletal instance each frame after update; instances that are
+         * not written after their update are drawn with own storage
+         */
+        void writeBones(glm::mat4* palette, const std::shared_ptr<Buffer>& storage, uint32_t offset) noexcept;
+
+        // cuts to animation
         SkeletalInstance& play(const std::string& name);
+        // fades animation in over playing ones during duration in seconds
+        SkeletalInstance& crossFade(const std::string& name, float duration);
         SkeletalInstance& pause() noexcept;
         SkeletalInstance& resume() noexcept;
+        // stops base animation and all layers
         SkeletalInstance& stop() noexcept;
 
+        /*
+         * plays animation in layer over base animation
+         *
+         * mask comes from SkeletalModel::makeBoneMask, layers are evaluated only while base animation plays;
+         * all poses are blended in local space and skinning matrices are computed once
+         */
+        SkeletalInstance& playLayer(size_t layer, const std::string& name, float weight = 1.0f, BoneMask mask = {}, LayerBlending blending = LayerBlending::Override);
+        SkeletalInstance& setLayerWeight(size_t layer, float weight);
+        SkeletalInstance& stopLayer(size_t layer) noexcept;
+
         const auto& getBoneTransform() const noexcept { return bone_transform; }
 
         // supports only IndexedMeshes for now
         glm::vec3 getSkinnedVertexPosition(const std::shared_ptr<AbstractMesh>& mesh, size_t vertex_index) const;
 
+        // skins vertices [indices, indices + count) of stream to positions; indices are not checked
+        void getSkinnedVertexPositions(const SkinnedVertexStream<VertexNormalTangent>& stream, const uint32_t* indices, size_t count, glm::vec3* positions) const noexcept;
+
+        // skins every vertex of stream to positions, that should fit them
+        void getSkinnedVertexPositions(const SkinnedVertexStream<VertexNormalTangent>& stream, glm::vec3* positions) const noexcept;
+
+        // skinned meshes are tested in current pose
+        std::optional<RayHit> raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) override;
+
         using AbstractInstance::draw;
         void draw(Context& ctx, const Assets& assets, ShaderPass shader_type, ms::Blending blending, const UniformSetter& uniform_setter) override;
+
+        // meshes are queued with bone buffer, which queue binds and fences
+        void enqueue(RenderQueue& queue) override;
     };
 }
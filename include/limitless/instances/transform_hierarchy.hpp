@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Limitless {
+    class AbstractInstance;
+    class ThreadPool;
+
+    /*
+     * Instances and their attachments flattened into array sorted by depth
+     *
+     * parents always precede children and nodes of one depth are contiguous,
+     * so matrices are propagated by single linear pass over levels;
+     * only changed instances and attachments of changed ones recompute their matrices
+     */
+    class TransformHierarchy final {
+    private:
+        static constexpr auto NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+        // levels with less nodes are updated on calling thread only
+        static constexpr size_t PARALLEL_THRESHOLD = 1024;
+        static constexpr size_t PARALLEL_CHUNK = 256;
+
+        struct Node {
+            AbstractInstance* instance;
+            uint32_t parent;
+        };
+
+        std::vector<Node> nodes;
+        // whether final matrix of node changed during current update, read by its children
+        std::vector<uint8_t> changed;
+        // nodes of depth i are in [levels[i], levels[i + 1])
+        std::vector<size_t> levels;
+
+        // incremented by nodes on attach and detach
+        std::atomic<uint64_t> structure_version {};
+        // structure version of the last build
+        uint64_t version {};
+        bool valid {};
+        // parent matrices of all nodes are set after build, so new attachments get them
+        bool propagate_all {};
+
+        void updateNode(size_t index) noexcept;
+    public:
+        TransformHierarchy() = default;
+        ~TransformHierarchy() = default;
+
+        // nodes point to structure version of this hierarchy
+        TransformHierarchy(const TransformHierarchy&) = delete;
+        TransformHierarchy(TransformHierarchy&&) = delete;
+
+        // roots are not owned and should be alive until next build or invalidate
+        void build(const std::vector<AbstractInstance*>& roots);
+
+        // should be called when roots are added or removed; attachments of built nodes are tracked by hierarchy itself
+        void invalidate() noexcept { valid = false; }
+        [[nodiscard]] bool isOutdated() const noexcept;
+
+        /*
+         * updates matrices and bounding boxes of all nodes
+         *
+         * big levels are split between pool workers, so updateBoundingBox of instances
+         * should not issue GL calls
+         */
+        void update(ThreadPool* pool = nullptr);
+
+        // instances in update order, parents first
+        [[nodiscard]] AbstractInstance& operator[](size_t index) const noexcept { return *nodes[index].instance; }
+        [[nodiscard]] size_t size() const noexcept { return nodes.size(); }
+        [[nodiscard]] size_t getDepth() const noexcept { return levels.empty() ? 0 : levels.size() - 1; }
+    };
+}
@@ -42,6 +42,9 @@ namespace Limitless {
         std::shared_ptr<Buffer> light_buffer;
         std::vector<glm::mat4> light_space;
 
+        // instances inside of currently drawn cascade
+        Instances casters;
+
         void initBuffers(Context& context);
         void updateFrustums(Context& ctx, const Camera& camera);
         void updateLightMatrices(const DirectionalLight& light);
@@ -51,7 +54,7 @@ namespace Limitless {
 
         void update(Context& ctx, const RenderSettings& settings);
 
-        void draw(Instances& instances,
+        void draw(const Scene& scene,
                   const DirectionalLight& light,
                   Context& ctx, const
                   Assets& assets,
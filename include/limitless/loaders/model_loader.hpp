@@ -16,8 +16,13 @@ namespace Limitless::ms {
     class Material;
 }
 
+namespace Assimp {
+    class Importer;
+}
+
 namespace Limitless {
     class AbstractModel;
+    class Model;
     class SkeletalModel;
     class AbstractMesh;
     class Assets;
@@ -44,6 +49,10 @@ namespace Limitless {
     public:
 	    std::set<ModelLoaderOption> options;
 	    float scale_factor {1.0f};
+	    // screen size of the first level loaded from <name>_lod1 file, each next level gets half of previous one
+	    float lod_screen_size {0.5f};
+	    // largest error per component that dropping animation keys may introduce, in model units for positions and scales
+	    float animation_tolerance {1e-4f};
 
 	    auto isPresent(ModelLoaderOption option) const { return options.count(option) != 0; }
     };
@@ -54,8 +63,15 @@ namespace Limitless {
         template<typename T, typename T1>
         static std::shared_ptr<AbstractMesh> loadMesh(Assets& assets, aiMesh *mesh, const fs::path& path, std::vector<Bone>& bones, std::unordered_map<std::string, uint32_t>& bone_map, const ModelLoaderFlags& flags);
     protected:
+        static const aiScene* readScene(Assimp::Importer& importer, const fs::path& path, const ModelLoaderFlags& flags);
+        // <name>_lod<level> file next to model file
+        static fs::path getLevelOfDetailPath(const fs::path& path, uint32_t level);
+        // throws if level of detail has other mesh count or bones than model
+        static void checkLevelOfDetail(const aiScene* scene, size_t mesh_count, size_t bone_count, const std::unordered_map<std::string, uint32_t>& level_bone_map);
+        // adds levels from <name>_lod1, <name>_lod2, ... files while they exist
+        static void loadLevelsOfDetail(Assets& assets, Model& model, const fs::path& path, const ModelLoaderFlags& flags);
         static std::vector<VertexBoneWeight> loadBoneWeights(aiMesh* mesh, std::vector<Bone>& bones, std::unordered_map<std::string, uint32_t>& bone_map);
-        static std::vector<Animation> loadAnimations(const aiScene* scene, std::vector<Bone>& bones, std::unordered_map<std::string, uint32_t>& bone_map);
+        static std::vector<Animation> loadAnimations(const aiScene* scene, std::vector<Bone>& bones, std::unordered_map<std::string, uint32_t>& bone_map, const ModelLoaderFlags& flags);
         static Tree<uint32_t> loadAnimationTree(const aiScene* scene, std::vector<Bone>& bones, std::unordered_map<std::string, uint32_t>& bone_map);
         static std::shared_ptr<ms::Material> loadMaterial(Assets& assets, aiMaterial* mat, const fs::path& path, const ModelShaders& model_shaders);
         static std::vector<std::shared_ptr<ms::Material>> loadMaterials(Assets& assets, const aiScene* scene, const fs::path& path, ModelShader model_shader);
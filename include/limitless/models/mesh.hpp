@@ -3,6 +3,7 @@
 #include <limitless/models/abstract_mesh.hpp>
 #include <limitless/core/vertex_stream.hpp>
 #include <limitless/core/abstract_vertex_stream.hpp>
+#include <limitless/util/triangle_bvh.hpp>
 
 namespace Limitless {
     class Mesh : public AbstractMesh {
@@ -10,9 +11,10 @@ namespace Limitless {
         std::unique_ptr<AbstractVertexStream> stream;
         std::string name;
         BoundingBox bounding_box {};
+        std::unique_ptr<TriangleBVH> triangle_bvh;
 
         void calculateBoundingBox() {
-//            bounding_box = Limitless::calculateBoundingBox(stream.getVertices());
+            bounding_box = stream->calculateBounds();
         }
     public:
 //        Mesh(std::vector<Vertex>&& vertices, VertexStreamUsage usage, VertexStreamDraw draw, std::string _name)
@@ -45,6 +47,13 @@ namespace Limitless {
         [[nodiscard]] const std::string& getName() const noexcept override { return name; }
         [[nodiscard]] std::string& getName() noexcept override { return name; }
 
+        /*
+         * hierarchy of mesh triangles for ray casts in model space
+         *
+         * built on first call from CPU side vertices; empty for streams that are not triangle lists
+         */
+        const TriangleBVH& getTriangleBVH();
+
         auto& getVertexStream() noexcept { return *stream; }
         [[nodiscard]] const auto& getVertexStream() const noexcept { return *stream; }
 
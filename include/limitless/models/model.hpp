@@ -10,8 +10,21 @@ namespace Limitless
 {
     class Model : public AbstractModel 
     {
+    public:
+        /*
+         * Coarser version of model meshes
+         *
+         * mesh with index i replaces model mesh i and is drawn with its material
+         */
+        struct LevelOfDetail {
+            std::vector<std::shared_ptr<AbstractMesh>> meshes;
+            // level is used while projected bounding sphere diameter is less than this fraction of screen height
+            float screen_size {};
+        };
     protected:
         std::vector<std::shared_ptr<ms::Material>> materials;
+        // levels after the full one, each one is coarser and used at smaller screen size than previous
+        std::vector<LevelOfDetail> levels;
     public:
         Model(decltype(meshes)&& mesh, decltype(materials)&& materials, std::string name);
         ~Model() override = default;
@@ -24,5 +37,9 @@ namespace Limitless
 
         [[nodiscard]] const auto& getMaterials() const noexcept { return materials; }
         [[nodiscard]] auto& getMaterials() noexcept { return materials; }
+
+        // throws std::invalid_argument if mesh count differs or screen size is not less than previous one
+        void addLevelOfDetail(LevelOfDetail level);
+        [[nodiscard]] const auto& getLevelsOfDetail() const noexcept { return levels; }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace Limitless {
+    /*
+     * Local transforms of skeleton nodes in flattened order, positions, rotations and scales in separate arrays
+     *
+     * view into PoseArena, valid until arena is reset
+     */
+    struct Pose {
+        glm::vec3* positions;
+        glm::fquat* rotations;
+        glm::vec3* scales;
+    };
+
+    // weight of every flattened skeleton node, from 0 to 1
+    using BoneMask = std::vector<float>;
+
+    /*
+     * Storage for poses that are blended during one evaluation
+     *
+     * reset keeps capacity, so once arena has grown to the largest request blending does not allocate
+     */
+    class PoseArena final {
+    private:
+        std::vector<glm::vec3> positions;
+        std::vector<glm::fquat> rotations;
+        std::vector<glm::vec3> scales;
+
+        size_t pose_size {};
+        size_t capacity {};
+        size_t used {};
+    public:
+        // invalidates all poses and prepares storage for count poses of pose_size nodes
+        void reset(size_t pose_size, size_t count);
+
+        // throws std::out_of_range if more poses are allocated than requested in reset
+        [[nodiscard]] Pose allocate();
+
+        [[nodiscard]] size_t getPoseSize() const noexcept { return pose_size; }
+    };
+
+    /*
+     * Pose blending, size is number of nodes in poses
+     *
+     * mask, if not null, scales weight of every node; rotations are normalized lerped along shortest path
+     */
+
+    // target = mix(target, source, weight)
+    void blendPoses(Pose target, Pose source, float weight, const float* mask, size_t size) noexcept;
+
+    // target += weight * (additive - reference)
+    void addPoses(Pose target, Pose additive, Pose reference, float weight, const float* mask, size_t size) noexcept;
+}
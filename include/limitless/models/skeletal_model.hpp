@@ -3,8 +3,11 @@
 #include <limitless/models/model.hpp>
 #include <limitless/util/tree.hpp>
 #include <limitless/models/bones.hpp>
+#include <limitless/models/pose.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <unordered_map>
+#include <limits>
+#include <array>
 
 namespace Limitless 
 {
@@ -19,38 +22,111 @@ namespace Limitless
             , time(time) {}
     };
 
+    // key value quantized to three 16 bit integers
+    using PackedKey = std::array<uint16_t, 3>;
+
+    /*
+     * Compressed keyframes of one animated property
+     *
+     * times are in ticks and sorted; rotations are packed as three smallest components of quaternion
+     * with index of the largest one in their low bits, positions and scales as 16 bit fractions of track range;
+     * keys are decompressed on sampling
+     */
+    template <typename T>
+    struct KeyTrack
+    {
+        std::vector<float> times;
+        std::vector<PackedKey> keys;
+        // range of position and scale keys, not used by rotations
+        glm::vec3 min {};
+        glm::vec3 extent {};
+
+        KeyTrack() = default;
+
+        // drops keys that interpolation of remaining neighbours reproduces within tolerance per component and packs the rest
+        explicit KeyTrack(const std::vector<KeyFrame<T>>& frames, float tolerance = 0.0f);
+
+        [[nodiscard]] auto size() const noexcept { return times.size(); }
+        [[nodiscard]] auto empty() const noexcept { return times.empty(); }
+
+        [[nodiscard]] T value(size_t index) const noexcept;
+
+        /*
+         * index i of key starting segment [times[i], times[i + 1]) that contains time, clamped to first and last segments
+         *
+         * cursor is the index found by previous sample; forward playback moves it by few keys in O(1),
+         * seeks and loops fall back to binary search. track should contain at least two keys
+         */
+        [[nodiscard]] size_t find(float time, uint32_t& cursor) const noexcept;
+    };
+
+    // indices of keys sampled last time in every track of animation node, kept by each playing instance
+    struct KeyCursor
+    {
+        uint32_t position {};
+        uint32_t rotation {};
+        uint32_t scale {};
+    };
+
     struct AnimationNode
     {
-        std::vector<KeyFrame<glm::fquat>> rotations;
-        std::vector<KeyFrame<glm::vec3>> positions;
-        std::vector<KeyFrame<glm::vec3>> scales;
-        Bone &bone;
-
-        AnimationNode(decltype(positions) positions, decltype(rotations) rotations, decltype(scales) scales, Bone &bone) noexcept;
-
-        [[nodiscard]] size_t findPositionKeyframe(double anim_time) const;
-        [[nodiscard]] size_t findRotationKeyframe(double anim_time) const;
-        [[nodiscard]] size_t findScalingKeyframe(double anim_time) const;
-        [[nodiscard]] glm::vec3 positionLerp(double anim_time) const;
-        [[nodiscard]] glm::fquat rotationLerp(double anim_time) const;
-        [[nodiscard]] glm::vec3 scalingLerp(double anim_time) const;
+        KeyTrack<glm::fquat> rotations;
+        KeyTrack<glm::vec3> positions;
+        KeyTrack<glm::vec3> scales;
+        // index of animated bone in model bones
+        uint32_t bone;
+
+        // compresses keyframes, see KeyTrack
+        AnimationNode(const std::vector<KeyFrame<glm::vec3>>& positions, const std::vector<KeyFrame<glm::fquat>>& rotations, const std::vector<KeyFrame<glm::vec3>>& scales, uint32_t bone, float tolerance = 0.0f);
+        AnimationNode(KeyTrack<glm::vec3> positions, KeyTrack<glm::fquat> rotations, KeyTrack<glm::vec3> scales, uint32_t bone) noexcept;
+
+        // samples with cursors, see KeyTrack::find
+        [[nodiscard]] glm::vec3 positionLerp(float anim_time, uint32_t& cursor) const noexcept;
+        [[nodiscard]] glm::fquat rotationLerp(float anim_time, uint32_t& cursor) const noexcept;
+        [[nodiscard]] glm::vec3 scalingLerp(float anim_time, uint32_t& cursor) const noexcept;
+
+        [[nodiscard]] glm::vec3 positionLerp(double anim_time) const noexcept;
+        [[nodiscard]] glm::fquat rotationLerp(double anim_time) const noexcept;
+        [[nodiscard]] glm::vec3 scalingLerp(double anim_time) const noexcept;
     };
 
     struct Animation 
     {
+        static constexpr auto NO_CHANNEL = std::numeric_limits<uint32_t>::max();
+
         std::vector<AnimationNode> nodes;
+        // index of node animating bone i, NO_CHANNEL for bones it does not animate
+        std::vector<uint32_t> channels;
         std::string name;
         double duration;
         double tps;
 
-        Animation(std::string name, double duration, double tps, decltype(nodes) nodes) noexcept
-            : nodes(std::move(nodes))
-            , name(std::move(name))
-            , duration(duration)
-            , tps(tps) {
+        Animation(std::string name, double duration, double tps, decltype(nodes) nodes) noexcept;
+
+        [[nodiscard]] const AnimationNode* findChannel(uint32_t bone) const noexcept {
+            return bone < channels.size() && channels[bone] != NO_CHANNEL ? &nodes[channels[bone]] : nullptr;
         }
     };
 
+    /*
+     * Bone of skeleton flattened in topological order
+     *
+     * parent always precedes its children, so global transforms are computed by one linear pass
+     */
+    struct SkeletonNode {
+        static constexpr auto NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+        uint32_t bone;
+        // position of parent in flattened skeleton
+        uint32_t parent;
+        // transform relative to parent for bones that animation does not animate
+        glm::mat4 local_transform;
+        // local_transform decomposed for pose blending
+        glm::vec3 position;
+        glm::fquat rotation;
+        glm::vec3 scale;
+    };
+
     class SkeletalModel : public Model
     {
     protected:
@@ -59,6 +135,10 @@ namespace Limitless
         std::vector<Bone> bones;
         glm::mat4 global_inverse;
         Tree<uint32_t> skeleton;
+        // skeleton tree flattened on construction
+        std::vector<SkeletonNode> flat_skeleton;
+
+        void flattenSkeleton();
     public:
         SkeletalModel(decltype(meshes)&& meshes, decltype(materials)&& materials, decltype(bones)&& bones, decltype(bone_map)&& bone_map, decltype(skeleton)&& skeleton, decltype(animations)&& a, const glm::mat4& global_matrix, std::string name) noexcept;
         ~SkeletalModel() override = default;
@@ -70,6 +150,28 @@ namespace Limitless
         [[nodiscard]] const auto& getAnimations() const noexcept { return animations; }
         [[nodiscard]] const auto& getSkeletonTree() const noexcept { return skeleton; }
         [[nodiscard]] const auto& getBones() const noexcept { return bones; }
+        [[nodiscard]] const auto& getFlatSkeleton() const noexcept { return flat_skeleton; }
+
+        /*
+         * computes skinning matrices of bones in pose of animation at time in ticks
+         *
+         * bone_transform should have element for every bone; bones outside of skeleton tree are not touched;
+         * cursors, if not null, have element for every animation node and are advanced by sampling
+         */
+        void samplePose(const Animation& animation, double time, std::vector<glm::mat4>& bone_transform, KeyCursor* cursors = nullptr) const;
+
+        /*
+         * writes local transforms of flattened skeleton nodes in pose of animation at time in ticks
+         *
+         * nodes that animation does not animate get their bind transforms; cursors are the same as in samplePose
+         */
+        void sampleLocalPose(const Animation& animation, double time, Pose pose, KeyCursor* cursors = nullptr) const noexcept;
+
+        // computes skinning matrices of bones from local pose by one pass over flattened skeleton
+        void applyPose(Pose pose, std::vector<glm::mat4>& bone_transform) const;
+
+        // mask selecting bone with its descendants; throws std::runtime_error if there is no such bone
+        [[nodiscard]] BoneMask makeBoneMask(const std::string& bone, float weight = 1.0f) const;
 
         auto& getGlobalInverseMatrix() noexcept { return global_inverse; }
         auto& getSkeletonTree() noexcept { return skeleton; }
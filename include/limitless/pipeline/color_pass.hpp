@@ -1,7 +1,7 @@
 #pragma once
 
 #include <limitless/pipeline/render_pass.hpp>
-#include <algorithm>
+#include <limitless/pipeline/render_queue.hpp>
 namespace Limitless::ms {
     enum class Blending;
 }
@@ -10,6 +10,7 @@ namespace Limitless {
     class ColorPass final : public RenderPass {
     private:
         ms::Blending blending;
+        RenderQueue queue;
     public:
         explicit ColorPass(Pipeline& pipeline, ms::Blending blending);
         ~ColorPass() override = default;
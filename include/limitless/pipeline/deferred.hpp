@@ -2,6 +2,7 @@
 
 #include <limitless/pipeline/pipeline.hpp>
 #include <limitless/core/framebuffer.hpp>
+#include <limitless/pipeline/static_geometry.hpp>
 
 namespace Limitless {
     class ContextEventObserver;
@@ -9,6 +10,9 @@ namespace Limitless {
 
     class Deferred final : public Pipeline {
     private:
+        // shared by passes that draw opaque geometry, kept between rebuilds
+        StaticGeometry static_geometry;
+
         void build(ContextEventObserver& ctx, const RenderSettings& settings);
     public:
         Deferred(ContextEventObserver& ctx, glm::uvec2 size, const RenderSettings& settings, RenderTarget& target = default_framebuffer);
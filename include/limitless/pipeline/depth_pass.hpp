@@ -1,6 +1,7 @@
 #pragma once
 
 #include <limitless/pipeline/render_pass.hpp>
+#include <limitless/pipeline/render_queue.hpp>
 
 namespace Limitless::fx {
     class EffectRenderer;
@@ -10,8 +11,9 @@ namespace Limitless {
     class DepthPass final : public RenderPass {
     private:
         fx::EffectRenderer& renderer;
+        RenderQueue queue;
     public:
-        DepthPass(Pipeline& pipeline, fx::EffectRenderer& renderer);
+        DepthPass(Pipeline& pipeline, fx::EffectRenderer& renderer, StaticGeometry* static_geometry = nullptr);
         ~DepthPass() override = default;
 
         void draw(Instances& instances, Context& ctx, const Assets& assets, const Camera& camera, UniformSetter& setter) override;
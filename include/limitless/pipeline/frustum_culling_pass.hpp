@@ -0,0 +1,18 @@
+#pragma once
+
+#include <limitless/pipeline/render_pass.hpp>
+
+namespace Limitless {
+    /*
+     * replaces instance list seen by next passes with instances inside of camera frustum
+     *
+     * visible instances are queried from scene spatial index
+     */
+    class FrustumCullingPass final : public RenderPass {
+    public:
+        explicit FrustumCullingPass(Pipeline& pipeline);
+        ~FrustumCullingPass() override = default;
+
+        void update(Scene& scene, Instances& instances, Context& ctx, const Camera& camera) override;
+    };
+}
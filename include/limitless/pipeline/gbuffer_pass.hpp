@@ -1,6 +1,7 @@
 #pragma once
 
 #include <limitless/pipeline/render_pass.hpp>
+#include <limitless/pipeline/render_queue.hpp>
 #include <limitless/core/framebuffer.hpp>
 
 namespace Limitless::fx {
@@ -11,8 +12,9 @@ namespace Limitless {
     class GBufferPass final : public RenderPass {
     private:
         fx::EffectRenderer& renderer;
+        RenderQueue queue;
     public:
-        GBufferPass(Pipeline& pipeline, fx::EffectRenderer& renderer);
+        GBufferPass(Pipeline& pipeline, fx::EffectRenderer& renderer, StaticGeometry* static_geometry = nullptr);
         ~GBufferPass() override = default;
 
         void draw(Instances& instances, Context& ctx, const Assets& assets, const Camera& camera, UniformSetter& setter) override;
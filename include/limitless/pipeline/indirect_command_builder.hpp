@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Limitless {
+    // layout of glMultiDrawElementsIndirect command
+    struct DrawElementsIndirectCommand {
+        uint32_t count;
+        uint32_t instance_count;
+        uint32_t first_index;
+        int32_t base_vertex;
+        uint32_t base_instance;
+    };
+
+    static_assert(sizeof(DrawElementsIndirectCommand) == 5 * sizeof(uint32_t));
+
+    // part of shared index and vertex buffers that belongs to one mesh
+    struct GeometryRange {
+        uint32_t first_index {};
+        uint32_t index_count {};
+        int32_t base_vertex {};
+    };
+
+    /*
+     * Fills indirect draw commands on CPU
+     *
+     * base instance of command is index of its first transform in model buffer;
+     * draws of the same range with consecutive transforms become instances of one command
+     */
+    class IndirectCommandBuilder final {
+    private:
+        std::vector<DrawElementsIndirectCommand> commands;
+        // commands before it belong to already finished multi draw
+        size_t first_open {};
+    public:
+        void add(const GeometryRange& range, uint32_t transform_index) {
+            if (commands.size() > first_open) {
+                auto& last = commands.back();
+                if (last.first_index == range.first_index
+                    && last.base_vertex == range.base_vertex
+                    && last.count == range.index_count
+                    && last.base_instance + last.instance_count == transform_index) {
+                    ++last.instance_count;
+                    return;
+                }
+            }
+
+            commands.push_back({range.index_count, 1, range.first_index, range.base_vertex, transform_index});
+        }
+
+        // starts commands of next multi draw, so they are not merged with previous ones
+        void split() noexcept { first_open = commands.size(); }
+
+        void clear() noexcept {
+            commands.clear();
+            first_open = 0;
+        }
+
+        [[nodiscard]] const auto& getCommands() const noexcept { return commands; }
+        [[nodiscard]] size_t size() const noexcept { return commands.size(); }
+        [[nodiscard]] bool empty() const noexcept { return commands.empty(); }
+    };
+}
@@ -21,6 +21,9 @@ namespace Limitless {
         std::vector<std::unique_ptr<RenderPass>> passes;
         RenderTarget* target {};
         glm::uvec2 size;
+
+        // instances passed between passes, kept to reuse its storage every frame
+        Instances instances;
     public:
         explicit Pipeline(glm::uvec2 size, RenderTarget& target) noexcept;
         virtual ~Pipeline() = default;
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <limitless/pipeline/shader_pass_types.hpp>
+#include <limitless/pipeline/indirect_command_builder.hpp>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <map>
+#include <cstdint>
+#include <vector>
+
+namespace Limitless::ms {
+    class Material;
+    enum class Blending;
+}
+
+namespace Limitless {
+    class AbstractInstance;
+    using Instances = std::vector<std::reference_wrapper<AbstractInstance>>;
+    class MaterialInstance;
+    class UniformSetter;
+    class MeshInstance;
+    class ShaderProgram;
+    class StaticGeometry;
+    class Context;
+    class Camera;
+    class Assets;
+    class Buffer;
+
+    /*
+     * Draw calls of one pass ordered by 64-bit sort key
+     *
+     * instances put their meshes into queue as separate items with shader resolved once;
+     * key packs pass, blending, shader, material, mesh and quantized camera distance, so after
+     * radix sort consecutive items share program, material buffer and vertex array
+     * and state is set only when it changes
+     *
+     * opaque:       pass 3 | blending 3 | shader 12 | material 14 | mesh 14 | depth 18
+     * transparent:  pass 3 | blending 3 | inverted depth 18 | shader 12 | material 14 | mesh 14
+     *
+     * opaque model meshes with equal material values end up next to each other and are merged
+     * into one instanced draw: their transforms go to shared storage read by INSTANCED_MODEL shader
+     * variant from _instance_offset, so copies of props cost one draw call per mesh;
+     * with static geometry such runs may also span different meshes
+     */
+    class RenderQueue final {
+    public:
+        // called when drawn item belongs to another instance than previous one
+        using InstanceCallback = std::function<void(AbstractInstance&)>;
+        // fewer copies are drawn one by one
+        static constexpr uint32_t MIN_INSTANCES = 2;
+    private:
+        struct Item {
+            uint64_t key {};
+            AbstractInstance* instance {};
+            // null for instances that draw themselves
+            ShaderProgram* shader {};
+            const ms::Material* material {};
+            MaterialInstance* material_instance {};
+            uint64_t layer {};
+            MeshInstance* mesh {};
+            const glm::mat4* transform {};
+            // bone storage of skeletal models and index of the first bone of instance in it
+            Buffer* bones {};
+            uint32_t bone_offset {};
+            // equal for materials with equal values if item can be instanced
+            uint64_t material_id {};
+            bool instanceable {};
+            // mesh in static geometry buffers
+            const GeometryRange* range {};
+            // range of instance transforms of merged item, count is 0 for single draw
+            uint32_t instance_offset {};
+            uint32_t instance_count {};
+            // range of indirect commands of merged static item
+            uint32_t command_offset {};
+            uint32_t command_count {};
+        };
+
+        struct MaterialValueLess {
+            bool operator()(const ms::Material* lhs, const ms::Material* rhs) const noexcept;
+        };
+
+        std::vector<Item> items;
+        std::vector<Item> sort_buffer;
+
+        std::vector<glm::mat4> instance_transforms;
+        std::shared_ptr<Buffer> instance_buffer;
+
+        StaticGeometry* static_geometry {};
+        IndirectCommandBuilder commands;
+        std::shared_ptr<Buffer> command_buffer;
+
+        // dense ids of shaders, materials and meshes for current build
+        std::unordered_map<const void*, uint64_t> shader_ids;
+        std::unordered_map<const void*, uint64_t> material_ids;
+        std::map<const ms::Material*, uint64_t, MaterialValueLess> material_values;
+        std::unordered_map<const void*, uint64_t> mesh_ids;
+        // model type and material shader index to program
+        std::unordered_map<uint64_t, ShaderProgram*> programs;
+
+        const Assets* assets {};
+        ShaderPass pass {};
+        ms::Blending blending {};
+        glm::vec3 camera_position {};
+
+        ShaderProgram& getShader(ModelShader model, uint64_t shader_index);
+        uint64_t getMaterialId(const ms::Material& material, bool by_value);
+        uint64_t makeKey(uint64_t shader_id, uint64_t material_id, uint64_t mesh_id, float distance) const noexcept;
+
+        // merges runs of instanceable items into instanced draws
+        void merge();
+        void uploadInstances();
+        void uploadCommands();
+        void drawStatic(const Item& item, ShaderProgram& shader, Context& ctx);
+    public:
+        RenderQueue() = default;
+        ~RenderQueue() = default;
+
+        /*
+         * collects and sorts draw items of instances for pass
+         *
+         * transparent blending is ordered back to front, everything else front to back inside of state groups
+         */
+        void build(Instances& instances, const Assets& assets, ShaderPass pass, ms::Blending blending, const Camera& camera);
+
+        /*
+         * adds every material layer of mesh that has blending of queue
+         *
+         * bones are bound only when storage differs from previous draw, so skeletal instances
+         * that share one storage (see Scene::uploadBones) differ only in offset uniform
+         */
+        void add(AbstractInstance& instance, MeshInstance& mesh, ModelShader model, const glm::mat4& transform, Buffer* bones = nullptr, uint32_t bone_offset = 0);
+
+        // adds instance that sets its own state in AbstractInstance::draw
+        void add(AbstractInstance& instance);
+
+        void draw(Context& ctx, const UniformSetter& setter, const InstanceCallback& callback = {});
+
+        void clear() noexcept;
+
+        /*
+         * enables drawing of static meshes from shared buffers
+         *
+         * meshes with the same shader and material values are then drawn by single multi draw indirect,
+         * or by one draw per command if multi draw or shader draw parameters are not supported;
+         * only meshes uploaded by StaticGeometry::update before build are drawn from it
+         */
+        void setStaticGeometry(StaticGeometry* geometry) noexcept { static_geometry = geometry; }
+
+        [[nodiscard]] size_t size() const noexcept { return items.size(); }
+        [[nodiscard]] bool empty() const noexcept { return items.empty(); }
+    };
+}
@@ -27,6 +27,9 @@ namespace Limitless {
 
         bool micro_shadowing = false;
 
+        // draws static meshes from shared buffers by multi draw indirect in depth and gbuffer passes
+        bool static_geometry_batching = false;
+
         // debug
         bool light_radius = true;
         bool coordinate_system_axes = false;
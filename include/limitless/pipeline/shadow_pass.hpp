@@ -12,6 +12,8 @@ namespace Limitless {
     private:
         CascadeShadows shadows;
         DirectionalLight* light {};
+        // cascades query their casters from scene
+        Scene* scene {};
 
         fx::EffectRenderer* effect_renderer {};
     public:
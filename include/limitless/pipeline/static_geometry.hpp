@@ -0,0 +1,109 @@
+#pragma once
+
+#include <limitless/pipeline/indirect_command_builder.hpp>
+#include <limitless/core/vertex_stream.hpp>
+#include <limitless/core/vertex_array.hpp>
+#include <limitless/core/vertex.hpp>
+
+#include <unordered_map>
+#include <optional>
+#include <memory>
+#include <vector>
+
+namespace Limitless {
+    class AbstractMesh;
+    class Buffer;
+
+    /*
+     * Shared vertex and index buffers of static meshes with single vertex array
+     *
+     * static triangle meshes are registered up front (see StaticGeometryPass) and their ranges
+     * are drawn by indirect commands without switching vertex arrays between meshes.
+     * uploaded meshes draw their ranges by themselves too and release their own buffers,
+     * so geometry is not duplicated on GPU.
+     *
+     * new meshes are appended in update(), buffers grow geometrically keeping ranges in place;
+     * space of destroyed meshes is reclaimed only once it takes more than half of buffers
+     */
+    class StaticGeometry final {
+    private:
+        struct Allocation {
+            std::weak_ptr<AbstractMesh> mesh;
+            // valid while mesh is alive
+            VertexStream<VertexNormalTangent>* stream {};
+            // empty until mesh is uploaded
+            std::optional<GeometryRange> range;
+            uint32_t vertex_count {};
+        };
+
+        // only meshes that can be shared
+        std::unordered_map<const AbstractMesh*, Allocation> allocations;
+
+        std::shared_ptr<Buffer> vertex_buffer;
+        std::shared_ptr<Buffer> index_buffer;
+        // shared with uploaded meshes, buffers are rebound to it on growth
+        std::shared_ptr<VertexArray> vertex_array;
+        size_t vertex_capacity {};
+        size_t index_capacity {};
+        // end of used space, including ranges of destroyed meshes
+        size_t vertex_end {};
+        size_t index_end {};
+        // of uploaded alive meshes
+        size_t vertex_count {};
+        size_t index_count {};
+
+        // reused for meshes without indices
+        std::vector<uint32_t> sequential_indices;
+
+        static VertexStream<VertexNormalTangent>* getShareableStream(AbstractMesh& mesh) noexcept;
+        static size_t getIndexCount(const VertexStream<VertexNormalTangent>& stream) noexcept;
+
+        void release(Allocation& allocation) noexcept;
+        void reserve(size_t vertices, size_t indices);
+        void place(Allocation& allocation);
+        void write(const Allocation& allocation);
+        void append();
+        void pack();
+    public:
+        StaticGeometry() = default;
+        ~StaticGeometry() = default;
+
+        StaticGeometry(const StaticGeometry&) = delete;
+        StaticGeometry& operator=(const StaticGeometry&) = delete;
+
+        /*
+         * registers mesh for next update
+         *
+         * ignores meshes that cannot be shared: not static, not triangle lists or of other vertex type
+         */
+        void add(const std::shared_ptr<AbstractMesh>& mesh);
+
+        // drops destroyed meshes and appends new ones, meshes changed in place are uploaded again
+        void update();
+
+        // range of uploaded mesh in shared buffers, null if mesh was not registered or update did not run since
+        [[nodiscard]] const GeometryRange* find(const AbstractMesh* mesh) const noexcept;
+
+        // binds shared vertex array, never uploads
+        void bind();
+
+        // whether commands can be drawn by one multi draw indirect call with base instance visible to shaders
+        [[nodiscard]] static bool isMultiDrawSupported();
+
+        // draws count commands from indirect buffer bound to draw indirect target, offset is in commands
+        void drawIndirect(uint32_t offset, uint32_t count);
+
+        // draws one command by itself; base instance is not visible to shaders, so caller offsets transforms
+        void draw(const DrawElementsIndirectCommand& command);
+
+        // meshes get their own buffers back
+        void clear();
+
+        // of uploaded meshes
+        [[nodiscard]] size_t getVertexCount() const noexcept { return vertex_count; }
+        [[nodiscard]] size_t getIndexCount() const noexcept { return index_count; }
+
+        [[nodiscard]] size_t getVertexCapacity() const noexcept { return vertex_capacity; }
+        [[nodiscard]] size_t getIndexCapacity() const noexcept { return index_capacity; }
+    };
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <limitless/pipeline/render_pass.hpp>
+#include <cstdint>
+
+namespace Limitless {
+    class StaticGeometry;
+
+    /*
+     * registers meshes of scene models in static geometry and uploads them before queues are built
+     *
+     * scene is scanned only when its instances or attachments change, so meshes are not
+     * looked up or uploaded while passes draw
+     */
+    class StaticGeometryPass final : public RenderPass {
+    private:
+        StaticGeometry& geometry;
+
+        const Scene* last_scene {};
+        uint64_t last_version {};
+    public:
+        StaticGeometryPass(Pipeline& pipeline, StaticGeometry& geometry);
+        ~StaticGeometryPass() override = default;
+
+        void update(Scene& scene, Instances& instances, Context& ctx, const Camera& camera) override;
+    };
+}
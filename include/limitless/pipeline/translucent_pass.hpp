@@ -1,6 +1,7 @@
 #pragma once
 
 #include <limitless/pipeline/render_pass.hpp>
+#include <limitless/pipeline/render_queue.hpp>
 #include <limitless/ms/blending.hpp>
 #include <limitless/core/framebuffer.hpp>
 
@@ -13,7 +14,7 @@ namespace Limitless {
     private:
         Framebuffer framebuffer;
         fx::EffectRenderer& renderer;
-        void sort(Instances& instances, const Camera& camera, ms::Blending blending);
+        RenderQueue queue;
     public:
         explicit TranslucentPass(Pipeline& pipeline, fx::EffectRenderer& renderer, glm::uvec2 frame_size, std::shared_ptr<Texture> depth);
 
@@ -1,12 +1,22 @@
 #pragma once
 
 #include <limitless/lighting/lighting.hpp>
+#include <limitless/util/thread_pool.hpp>
+#include <limitless/util/bounding_volume_tree.hpp>
+#include <limitless/instances/transform_hierarchy.hpp>
+#include <limitless/core/mapped_ring_buffer.hpp>
+#include <limitless/pipeline/shader_pass_types.hpp>
 #include <stdexcept>
 #include <unordered_map>
+#include <optional>
+#include <array>
 #include <memory>
+#include <chrono>
 
 namespace Limitless {
     class AbstractInstance;
+    class EffectInstance;
+    struct RayHit;
     class Camera;
     class Skybox;
 
@@ -19,7 +29,63 @@ namespace Limitless {
         std::unordered_map<uint64_t, std::unique_ptr<AbstractInstance>> instances;
         std::shared_ptr<Skybox> skybox;
 
+        // skeletal and effect instances are simulated on workers in chunks of these sizes
+        static constexpr size_t SKELETAL_UPDATE_CHUNK = 4;
+        static constexpr size_t EFFECT_UPDATE_CHUNK = 8;
+        ThreadPool update_pool;
+
+        // matrices of instances and attachments are propagated over it before instance updates
+        TransformHierarchy hierarchy;
+
+        /*
+         * bone transforms of all skeletal instances, written once per advance after simulation
+         *
+         * every instance writes its palette at own offset and shader reads bone i of instance at _bone_offset + i,
+         * so storage is bound once per pass
+         */
+        MappedRingBuffer<glm::mat4> bone_storage {Buffer::Type::ShaderStorage};
+        // offsets of skeletal instances in bone storage
+        std::vector<uint32_t> bone_offsets;
+
+        // flat lists of instances and attachments, parents first; rebuilt with hierarchy only after add, remove, attach or detach
+        Instances wrappers;
+        std::array<Instances, static_cast<size_t>(ModelShader::Effect) + 1> shader_wrappers;
+        // incremented every time wrapper lists are rebuilt
+        uint64_t structure_version {};
+
+        // upper bound of fixed steps simulated in one advance, the rest of accumulated time is dropped
+        static constexpr uint32_t MAX_FIXED_STEPS = 8;
+        std::optional<float> fixed_timestep;
+        float accumulator {};
+
+        // real time of previous update
+        std::optional<std::chrono::time_point<std::chrono::steady_clock>> last_update;
+
+        using SpatialIndex = BoundingVolumeTree<AbstractInstance*>;
+
+        struct IndexEntry {
+            SpatialIndex::Proxy proxy;
+            // generation of last synchronization that found instance
+            uint64_t generation;
+        };
+
+        // instances and attachments with bounding boxes; synchronized at the end of every advance
+        SpatialIndex spatial_index;
+        std::unordered_map<const AbstractInstance*, IndexEntry> indexed;
+        uint64_t index_generation {};
+        // structure version index was synchronized with; while it is current only moved instances are refitted
+        uint64_t indexed_structure_version {};
+
+        // instances without bounds are reported by every volume query
+        Instances unbounded;
+
         void removeDeadInstances() noexcept;
+        void updateStructure();
+        void simulate(Context& context, const Camera& camera, float dt);
+        void uploadBones();
+
+        void updateIndex();
+        void removeFromIndex(AbstractInstance& instance) noexcept;
     public:
         explicit Scene(Context& context);
         virtual ~Scene() = default;
@@ -32,6 +98,7 @@ namespace Limitless {
             static_assert(std::is_base_of_v<AbstractInstance, T>, "Typename type must be base of AbstractInstance");
 
             instances.emplace(instance->getId(), instance);
+            hierarchy.invalidate();
             return *instance;
         }
 
@@ -41,6 +108,7 @@ namespace Limitless {
 
             T* instance = new T(std::forward<Args>(args)...);
             instances.emplace(instance->getId(), instance);
+            hierarchy.invalidate();
             return *instance;
         }
 
@@ -55,8 +123,21 @@ namespace Limitless {
         const auto& getSkybox() const noexcept { return skybox; }
         void setSkybox(std::shared_ptr<Skybox> skybox);
 
+        // advances scene by real time passed since previous update
         virtual void update(Context& context, const Camera& camera);
 
+        /*
+         * advances scene by dt seconds of simulation time
+         *
+         * does not read any clock, so the same inputs give the same state;
+         * with fixed timestep set, dt is accumulated and simulated in whole steps
+         */
+        void advance(Context& context, const Camera& camera, float dt);
+
+        // empty value makes simulation step equal to advanced time
+        void setFixedTimestep(std::optional<float> step);
+        [[nodiscard]] const auto& getFixedTimestep() const noexcept { return fixed_timestep; }
+
         auto begin() noexcept { return instances.begin(); }
         auto begin() const noexcept { return instances.begin(); }
 
@@ -64,7 +145,44 @@ namespace Limitless {
         auto end() const noexcept { return instances.end(); }
 
         auto& getInstances() noexcept { return instances; }
-        Instances getWrappers() noexcept;
+        // all instances and attachments; reference is valid until next add, remove, attach or detach
+        const Instances& getWrappers();
+        // instances and attachments of one type (models, skeletal, instanced, effects)
+        const Instances& getWrappers(ModelShader type);
+        // changes when instances or attachments were added or removed since it was read
+        uint64_t getStructureVersion();
+
+        /*
+         * spatial queries append instances whose bounding boxes intersect volume to result
+         *
+         * instances without bounds (effects, lights) are always appended;
+         * index reflects state after the last update/advance
+         */
+        void query(const Frustum& frustum, Instances& result) const;
+        void query(const BoundingBox& box, Instances& result) const;
+        void query(const glm::vec3& center, float radius, Instances& result) const;
+
+        /*
+         * casts ray against bounding boxes, nearer instances first
+         *
+         * callback(AbstractInstance&, float box_distance) returns new max distance of ray
+         */
+        template<typename F>
+        void raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, F&& callback) const {
+            spatial_index.raycast(origin, direction, max_distance, [&] (AbstractInstance* instance, float distance) {
+                return callback(*instance, distance);
+            });
+        }
+
+        /*
+         * closest instance triangle hit by ray
+         *
+         * bounding boxes are tested by spatial index, triangles by per mesh hierarchies;
+         * distance of hit is in world units along direction
+         */
+        [[nodiscard]] std::optional<RayHit> pick(const glm::vec3& origin, const glm::vec3& direction, float max_distance = std::numeric_limits<float>::max()) const;
+
+        [[nodiscard]] const auto& getSpatialIndex() const noexcept { return spatial_index; }
 
         auto size() const noexcept { return instances.size(); }
 
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Limitless {
+    class ByteBuffer;
+    struct Animation;
+
+    /*
+     * Writes compressed animations as they are stored in memory
+     *
+     * keys are not decompressed or reduced again, so deserialization only copies track arrays
+     */
+    class AnimationSerializer {
+    private:
+        static constexpr uint8_t VERSION = 0x1;
+    public:
+        ByteBuffer serialize(const Animation& animation);
+        Animation deserialize(ByteBuffer& buffer);
+    };
+
+    ByteBuffer& operator<<(ByteBuffer& buffer, const Animation& animation);
+}
@@ -8,7 +8,7 @@ namespace Limitless {
 
     class DistributionSerializer {
     private:
-        static constexpr uint8_t VERSION = 0x1;
+        static constexpr uint8_t VERSION = 0x2;
     public:
         template<typename T>
         ByteBuffer serialize(const Distribution<T>& distr);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <limitless/util/random.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Limitless {
+    /*
+     * Walker's alias table
+     *
+     * samples index with probability proportional to its weight in O(1):
+     * one random column and one comparison against its threshold;
+     * built once in O(n) with Vose's method
+     */
+    class AliasTable {
+    private:
+        std::vector<float> probability;
+        std::vector<uint32_t> alias;
+        double total {};
+    public:
+        AliasTable() = default;
+
+        AliasTable(const float* weights, size_t count) {
+            build(weights, count);
+        }
+
+        // all zero or empty weights give uniform table
+        void build(const float* weights, size_t count) {
+            probability.resize(count);
+            alias.resize(count);
+
+            total = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                total += weights[i];
+            }
+
+            if (count == 0) {
+                return;
+            }
+
+            std::vector<uint32_t> small;
+            std::vector<uint32_t> large;
+            std::vector<double> scaled(count);
+
+            for (size_t i = 0; i < count; ++i) {
+                scaled[i] = total > 0.0 ? weights[i] * static_cast<double>(count) / total : 1.0;
+                alias[i] = static_cast<uint32_t>(i);
+                (scaled[i] < 1.0 ? small : large).emplace_back(static_cast<uint32_t>(i));
+            }
+
+            while (!small.empty() && !large.empty()) {
+                const auto less = small.back();
+                const auto more = large.back();
+                small.pop_back();
+
+                probability[less] = static_cast<float>(scaled[less]);
+                alias[less] = more;
+
+                scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+                if (scaled[more] < 1.0) {
+                    large.pop_back();
+                    small.emplace_back(more);
+                }
+            }
+
+            // leftovers are exactly one up to rounding errors
+            for (const auto i : small) {
+                probability[i] = 1.0f;
+            }
+            for (const auto i : large) {
+                probability[i] = 1.0f;
+            }
+        }
+
+        [[nodiscard]] uint32_t sample(Xoshiro128& generator) const noexcept {
+            const auto column = generator.nextBelow(probability.size());
+            return generator.nextFloat() < probability[column] ? column : alias[column];
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return probability.size(); }
+        [[nodiscard]] bool empty() const noexcept { return probability.empty(); }
+
+        // sum of weights table was built from
+        [[nodiscard]] double getTotal() const noexcept { return total; }
+    };
+}
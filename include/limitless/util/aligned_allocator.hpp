@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace Limitless {
+    /*
+     * std compatible allocator that aligns storage to specified boundary
+     *
+     * used by streams that are processed with SIMD loads
+     */
+    template<typename T, std::size_t Alignment>
+    class AlignedAllocator {
+        static_assert(Alignment >= alignof(T), "Alignment must not be less than natural alignment of type");
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() noexcept = default;
+
+        template<typename U>
+        AlignedAllocator([[maybe_unused]] const AlignedAllocator<U, Alignment>& other) noexcept {}
+
+        [[nodiscard]] T* allocate(std::size_t count) {
+            if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        void deallocate(T* pointer, [[maybe_unused]] std::size_t count) noexcept {
+            ::operator delete(pointer, std::align_val_t{Alignment});
+        }
+
+        template<typename U>
+        bool operator==([[maybe_unused]] const AlignedAllocator<U, Alignment>& other) const noexcept { return true; }
+
+        template<typename U>
+        bool operator!=([[maybe_unused]] const AlignedAllocator<U, Alignment>& other) const noexcept { return false; }
+    };
+}
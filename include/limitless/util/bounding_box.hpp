@@ -2,7 +2,9 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtx/functions.hpp>
+#include <algorithm>
 #include <vector>
+#include <limits>
 
 namespace Limitless {
     struct BoundingBox {
@@ -12,8 +14,12 @@ namespace Limitless {
 
     template<typename V>
     inline BoundingBox calculateBoundingBox(const std::vector<V>& vertices) {
+        if (vertices.empty()) {
+            return {};
+        }
+
         auto min = glm::vec3{ std::numeric_limits<float>::max() };
-        auto max = glm::vec3{ std::numeric_limits<float>::min() };
+        auto max = glm::vec3{ std::numeric_limits<float>::lowest() };
 
         for (const auto& v : vertices) {
             const glm::vec3 position = v.getPosition();
@@ -36,4 +42,40 @@ namespace Limitless {
 
         return { center, size };
     }
+
+    /*
+     * axis aligned box enclosing box transformed by matrix
+     *
+     * center is transformed as point, half size is projected on new axes by absolute rotation-scale part
+     */
+    inline BoundingBox transformBoundingBox(const BoundingBox& box, const glm::mat4& matrix) noexcept {
+        const auto center = glm::vec3{matrix * glm::vec4{box.center, 1.0f}};
+
+        const auto half = box.size / 2.0f;
+        glm::vec3 extent {0.0f};
+        for (int i = 0; i < 3; ++i) {
+            extent += glm::abs(glm::vec3{matrix[i]}) * half[i];
+        }
+
+        return { center, extent * 2.0f };
+    }
+
+    /*
+     * slab test of ray against box given by min and max corners
+     *
+     * returns distance at which ray enters box, clamped to zero if origin is inside,
+     * or infinity if box is missed within max_distance
+     */
+    inline float intersectRayBox(const glm::vec3& min, const glm::vec3& max, const glm::vec3& origin, const glm::vec3& inverse_direction, float max_distance) noexcept {
+        const auto t0 = (min - origin) * inverse_direction;
+        const auto t1 = (max - origin) * inverse_direction;
+
+        const auto near = glm::min(t0, t1);
+        const auto far = glm::max(t0, t1);
+
+        const auto enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+        const auto exit = std::min(std::min(far.x, far.y), std::min(far.z, max_distance));
+
+        return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+    }
 }
\ No newline at end of file
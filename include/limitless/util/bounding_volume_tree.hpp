@@ -0,0 +1,461 @@
+#pragma once
+
+#include <limitless/util/bounding_box.hpp>
+#include <limitless/util/frustum.hpp>
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Limitless {
+    /*
+     * Dynamic AABB tree
+     *
+     * leaves store enlarged (fat) boxes of objects, so objects moving inside of them cost nothing;
+     * leaf is reinserted only when its object leaves the fat box;
+     * insertion picks sibling by surface area heuristic and tree is kept balanced by rotations,
+     * so queries visit O(log n + k) nodes
+     */
+    template<typename T>
+    class BoundingVolumeTree {
+    public:
+        using Proxy = int32_t;
+        static constexpr Proxy NONE = -1;
+    private:
+        struct Bounds {
+            glm::vec3 min;
+            glm::vec3 max;
+        };
+
+        struct Node {
+            Bounds bounds {};
+            T data {};
+            // next free node for released nodes
+            Proxy parent {NONE};
+            Proxy left {NONE};
+            Proxy right {NONE};
+            // leaf is 0, released node is -1
+            int32_t height {-1};
+
+            [[nodiscard]] bool isLeaf() const noexcept { return left == NONE; }
+        };
+
+        std::vector<Node> nodes;
+        Proxy root {NONE};
+        Proxy free_list {NONE};
+        size_t count {};
+
+        // absolute enlargement of leaf boxes on each side
+        float margin;
+
+        static Bounds toBounds(const BoundingBox& box) noexcept {
+            return { box.center - box.size / 2.0f, box.center + box.size / 2.0f };
+        }
+
+        static BoundingBox toBox(const Bounds& bounds) noexcept {
+            return { (bounds.min + bounds.max) / 2.0f, bounds.max - bounds.min };
+        }
+
+        static Bounds merge(const Bounds& a, const Bounds& b) noexcept {
+            return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+        }
+
+        // half of surface area
+        static float area(const Bounds& bounds) noexcept {
+            const auto d = bounds.max - bounds.min;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+
+        static bool contains(const Bounds& outer, const Bounds& inner) noexcept {
+            return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::greaterThanEqual(outer.max, inner.max));
+        }
+
+        static bool overlaps(const Bounds& a, const Bounds& b) noexcept {
+            return glm::all(glm::lessThanEqual(a.min, b.max)) && glm::all(glm::greaterThanEqual(a.max, b.min));
+        }
+
+        Proxy allocate() {
+            if (free_list == NONE) {
+                nodes.emplace_back();
+                free_list = static_cast<Proxy>(nodes.size() - 1);
+            }
+
+            const auto proxy = free_list;
+            free_list = nodes[proxy].parent;
+            nodes[proxy] = Node {};
+            nodes[proxy].height = 0;
+            return proxy;
+        }
+
+        void release(Proxy proxy) noexcept {
+            nodes[proxy] = Node {};
+            nodes[proxy].parent = free_list;
+            free_list = proxy;
+        }
+
+        void refit(Proxy proxy) noexcept {
+            auto& node = nodes[proxy];
+            node.height = 1 + std::max(nodes[node.left].height, nodes[node.right].height);
+            node.bounds = merge(nodes[node.left].bounds, nodes[node.right].bounds);
+        }
+
+        void replaceChild(Proxy parent, Proxy old_child, Proxy new_child) noexcept {
+            if (parent == NONE) {
+                root = new_child;
+            } else if (nodes[parent].left == old_child) {
+                nodes[parent].left = new_child;
+            } else {
+                nodes[parent].right = new_child;
+            }
+        }
+
+        // refits and rebalances ancestors starting from proxy
+        void fixUpwards(Proxy proxy) noexcept {
+            while (proxy != NONE) {
+                proxy = balance(proxy);
+                refit(proxy);
+                proxy = nodes[proxy].parent;
+            }
+        }
+
+        /*
+         * rotates taller grandchild of unbalanced node a up to its place
+         *
+         * returns root of rotated subtree
+         */
+        Proxy balance(Proxy a) noexcept {
+            if (nodes[a].isLeaf() || nodes[a].height < 2) {
+                return a;
+            }
+
+            const auto b = nodes[a].left;
+            const auto c = nodes[a].right;
+            const auto difference = nodes[c].height - nodes[b].height;
+
+            if (difference > 1) {
+                rotate(a, c, false);
+                return c;
+            }
+
+            if (difference < -1) {
+                rotate(a, b, true);
+                return b;
+            }
+
+            return a;
+        }
+
+        // child of a becomes parent of a and keeps its taller child
+        void rotate(Proxy a, Proxy child, bool left) noexcept {
+            const auto f = nodes[child].left;
+            const auto g = nodes[child].right;
+
+            nodes[child].left = a;
+            nodes[child].parent = nodes[a].parent;
+            nodes[a].parent = child;
+            replaceChild(nodes[child].parent, a, child);
+
+            const auto [taller, shorter] = nodes[f].height > nodes[g].height ? std::pair{f, g} : std::pair{g, f};
+
+            nodes[child].right = taller;
+            (left ? nodes[a].left : nodes[a].right) = shorter;
+            nodes[shorter].parent = a;
+
+            refit(a);
+            refit(child);
+        }
+
+        void insertLeaf(Proxy leaf) {
+            if (root == NONE) {
+                root = leaf;
+                nodes[leaf].parent = NONE;
+                return;
+            }
+
+            // descends to sibling with the smallest area increase of the tree
+            const auto leaf_bounds = nodes[leaf].bounds;
+            auto index = root;
+            while (!nodes[index].isLeaf()) {
+                const auto& node = nodes[index];
+                const auto node_area = area(node.bounds);
+                const auto combined_area = area(merge(node.bounds, leaf_bounds));
+
+                // cost of new parent for this node and leaf
+                const auto cost = 2.0f * combined_area;
+                // cost of pushing leaf further down
+                const auto inheritance = 2.0f * (combined_area - node_area);
+
+                const auto descend = [&] (Proxy child) {
+                    const auto& child_node = nodes[child];
+                    const auto merged = area(merge(child_node.bounds, leaf_bounds));
+                    return (child_node.isLeaf() ? merged : merged - area(child_node.bounds)) + inheritance;
+                };
+
+                const auto left_cost = descend(node.left);
+                const auto right_cost = descend(node.right);
+
+                if (cost < left_cost && cost < right_cost) {
+                    break;
+                }
+
+                index = left_cost < right_cost ? node.left : node.right;
+            }
+
+            const auto sibling = index;
+            const auto old_parent = nodes[sibling].parent;
+            const auto new_parent = allocate();
+
+            auto& parent = nodes[new_parent];
+            parent.parent = old_parent;
+            parent.left = sibling;
+            parent.right = leaf;
+            parent.bounds = merge(leaf_bounds, nodes[sibling].bounds);
+            parent.height = nodes[sibling].height + 1;
+
+            replaceChild(old_parent, sibling, new_parent);
+            nodes[sibling].parent = new_parent;
+            nodes[leaf].parent = new_parent;
+
+            fixUpwards(new_parent);
+        }
+
+        void removeLeaf(Proxy leaf) noexcept {
+            if (leaf == root) {
+                root = NONE;
+                return;
+            }
+
+            const auto parent = nodes[leaf].parent;
+            const auto grandparent = nodes[parent].parent;
+            const auto sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+            replaceChild(grandparent, parent, sibling);
+            nodes[sibling].parent = grandparent;
+            release(parent);
+
+            fixUpwards(grandparent);
+        }
+
+        // reports every leaf of subtree
+        template<typename F>
+        void collect(Proxy proxy, std::vector<Proxy>& stack, F& callback) const {
+            const auto bottom = stack.size();
+            stack.push_back(proxy);
+
+            while (stack.size() > bottom) {
+                const auto& node = nodes[stack.back()];
+                stack.pop_back();
+
+                if (node.isLeaf()) {
+                    callback(node.data);
+                } else {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+            }
+        }
+
+        // visits leaves whose fat box satisfies test
+        template<typename Test, typename F>
+        void traverse(Test&& test, F& callback) const {
+            if (root == NONE) {
+                return;
+            }
+
+            std::vector<Proxy> stack;
+            stack.reserve(64);
+            stack.push_back(root);
+
+            while (!stack.empty()) {
+                const auto& node = nodes[stack.back()];
+                stack.pop_back();
+
+                if (!test(node.bounds)) {
+                    continue;
+                }
+
+                if (node.isLeaf()) {
+                    callback(node.data);
+                } else {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+            }
+        }
+
+        // distance along ray to box entry or infinity if missed
+        static float intersectRay(const Bounds& bounds, const glm::vec3& origin, const glm::vec3& inverse_direction, float max_distance) noexcept {
+            return intersectRayBox(bounds.min, bounds.max, origin, inverse_direction, max_distance);
+        }
+    public:
+        explicit BoundingVolumeTree(float _margin = 0.1f) noexcept
+            : margin {_margin} {
+        }
+
+        Proxy insert(const BoundingBox& box, T data) {
+            const auto proxy = allocate();
+
+            auto bounds = toBounds(box);
+            bounds.min -= margin;
+            bounds.max += margin;
+
+            nodes[proxy].bounds = bounds;
+            nodes[proxy].data = std::move(data);
+
+            insertLeaf(proxy);
+            ++count;
+
+            return proxy;
+        }
+
+        void remove(Proxy proxy) noexcept {
+            removeLeaf(proxy);
+            release(proxy);
+            --count;
+        }
+
+        /*
+         * updates box of object
+         *
+         * returns whether leaf was reinserted, which happens only when box leaves fat box
+         */
+        bool move(Proxy proxy, const BoundingBox& box) {
+            auto bounds = toBounds(box);
+            if (contains(nodes[proxy].bounds, bounds)) {
+                return false;
+            }
+
+            removeLeaf(proxy);
+
+            bounds.min -= margin;
+            bounds.max += margin;
+            nodes[proxy].bounds = bounds;
+
+            insertLeaf(proxy);
+
+            return true;
+        }
+
+        void clear() noexcept {
+            nodes.clear();
+            root = NONE;
+            free_list = NONE;
+            count = 0;
+        }
+
+        [[nodiscard]] const T& getData(Proxy proxy) const noexcept { return nodes[proxy].data; }
+        [[nodiscard]] BoundingBox getFatBox(Proxy proxy) const noexcept { return toBox(nodes[proxy].bounds); }
+        [[nodiscard]] int32_t getHeight() const noexcept { return root == NONE ? 0 : nodes[root].height; }
+        [[nodiscard]] size_t size() const noexcept { return count; }
+        [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+        // calls callback with data of every leaf intersecting frustum
+        template<typename F>
+        void query(const Frustum& frustum, F&& callback) const {
+            if (root == NONE) {
+                return;
+            }
+
+            std::vector<Proxy> stack;
+            stack.reserve(64);
+            stack.push_back(root);
+
+            while (!stack.empty()) {
+                const auto proxy = stack.back();
+                const auto& node = nodes[proxy];
+                stack.pop_back();
+
+                const auto box = toBox(node.bounds);
+                if (!frustum.intersects(box)) {
+                    continue;
+                }
+
+                // subtrees fully inside are reported without further tests
+                if (node.isLeaf() || frustum.contains(box)) {
+                    collect(proxy, stack, callback);
+                } else {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+            }
+        }
+
+        // calls callback with data of every leaf overlapping box
+        template<typename F>
+        void query(const BoundingBox& box, F&& callback) const {
+            const auto bounds = toBounds(box);
+            traverse([&] (const Bounds& node) { return overlaps(node, bounds); }, callback);
+        }
+
+        // calls callback with data of every leaf overlapping sphere
+        template<typename F>
+        void query(const glm::vec3& center, float radius, F&& callback) const {
+            const auto radius2 = radius * radius;
+            traverse([&] (const Bounds& node) {
+                const auto closest = glm::clamp(center, node.min, node.max);
+                const auto d = closest - center;
+                return glm::dot(d, d) <= radius2;
+            }, callback);
+        }
+
+        /*
+         * casts ray against leaves, nearer nodes first
+         *
+         * callback is called as callback(data, distance) with distance of fat box entry
+         * and returns new max distance, so precise hit shortens the ray and prunes farther nodes
+         */
+        template<typename F>
+        void raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, F&& callback) const {
+            if (root == NONE) {
+                return;
+            }
+
+            const auto inverse_direction = 1.0f / direction;
+
+            struct Entry {
+                Proxy proxy;
+                float distance;
+            };
+
+            std::vector<Entry> stack;
+            stack.reserve(64);
+
+            if (const auto distance = intersectRay(nodes[root].bounds, origin, inverse_direction, max_distance); distance <= max_distance) {
+                stack.push_back({root, distance});
+            }
+
+            while (!stack.empty()) {
+                const auto entry = stack.back();
+                stack.pop_back();
+
+                if (entry.distance > max_distance) {
+                    continue;
+                }
+
+                const auto& node = nodes[entry.proxy];
+                if (node.isLeaf()) {
+                    max_distance = std::min(max_distance, static_cast<float>(callback(node.data, entry.distance)));
+                    continue;
+                }
+
+                auto left = Entry {node.left, intersectRay(nodes[node.left].bounds, origin, inverse_direction, max_distance)};
+                auto right = Entry {node.right, intersectRay(nodes[node.right].bounds, origin, inverse_direction, max_distance)};
+
+                // nearer child is popped first
+                if (left.distance < right.distance) {
+                    std::swap(left, right);
+                }
+
+                if (left.distance <= max_distance) {
+                    stack.push_back(left);
+                }
+                if (right.distance <= max_distance) {
+                    stack.push_back(right);
+                }
+            }
+        }
+    };
+}
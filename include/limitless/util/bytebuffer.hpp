@@ -6,6 +6,7 @@
 #include <set>
 #include <unordered_map>
 #include <map>
+#include <vector>
 
 namespace Limitless 
 {
@@ -80,6 +81,23 @@ namespace Limitless
             read(reinterpret_cast<std::byte&>(value), sizeof(T));
         }
 
+        // count values copied at once, without size prefix
+        template<typename T, std::enable_if_t<std::is_trivially_copyable_v<T>, bool> = true>
+        void write(const T* values, size_t count)
+        {
+            if (count != 0) {
+                write(reinterpret_cast<const std::byte&>(*values), sizeof(T) * count);
+            }
+        }
+
+        template<typename T, std::enable_if_t<std::is_trivially_copyable_v<T>, bool> = true>
+        void read(T* values, size_t count)
+        {
+            if (count != 0) {
+                read(reinterpret_cast<std::byte&>(*values), sizeof(T) * count);
+            }
+        }
+
         void flip() 
         {
             std::reverse(buffer.begin(), buffer.end());
@@ -15,6 +15,7 @@
 #include "sorter.hpp"
 
 namespace Limitless {
+    // GPU picking by id colors; Scene::pick answers the same query on CPU without extra pass and readback
     class ColorPicker {
     private:
         struct PickData {
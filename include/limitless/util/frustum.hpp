@@ -0,0 +1,73 @@
+#pragma once
+
+#include <limitless/util/bounding_box.hpp>
+
+#include <glm/glm.hpp>
+#include <array>
+
+namespace Limitless {
+    /*
+     * view volume of projection * view matrix as six planes facing inside
+     *
+     * plane is (normal, distance); point p is inside when dot(normal, p) + distance >= 0 for every plane
+     */
+    class Frustum {
+    private:
+        std::array<glm::vec4, 6> planes;
+    public:
+        explicit Frustum(const glm::mat4& view_projection) noexcept {
+            // rows of clip matrix
+            const auto row = [&] (int i) {
+                return glm::vec4{view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]};
+            };
+
+            const auto x = row(0);
+            const auto y = row(1);
+            const auto z = row(2);
+            const auto w = row(3);
+
+            planes = { w + x, w - x, w + y, w - y, w + z, w - z };
+
+            for (auto& plane : planes) {
+                plane /= glm::length(glm::vec3{plane});
+            }
+        }
+
+        [[nodiscard]] const auto& getPlanes() const noexcept { return planes; }
+
+        /*
+         * conservative test: box is rejected only if it is fully behind one of the planes,
+         * boxes near frustum corners may pass
+         */
+        [[nodiscard]] bool intersects(const BoundingBox& box) const noexcept {
+            const auto half = box.size / 2.0f;
+
+            for (const auto& plane : planes) {
+                const auto normal = glm::vec3{plane};
+                const auto radius = glm::dot(glm::abs(normal), half);
+
+                if (glm::dot(normal, box.center) + plane.w < -radius) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // whether box is fully inside of every plane
+        [[nodiscard]] bool contains(const BoundingBox& box) const noexcept {
+            const auto half = box.size / 2.0f;
+
+            for (const auto& plane : planes) {
+                const auto normal = glm::vec3{plane};
+                const auto radius = glm::dot(glm::abs(normal), half);
+
+                if (glm::dot(normal, box.center) + plane.w < radius) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
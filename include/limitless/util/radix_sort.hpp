@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Limitless {
+    /*
+     * Stable LSD radix sort of values by 64-bit key, one byte per pass
+     *
+     * histograms of all bytes are counted in a single sweep; passes over bytes that are equal
+     * for every value are skipped, so keys with unused high bits cost less.
+     * buffer is scratch storage kept by caller to avoid allocation every call
+     */
+    template<typename T, typename KeyOf>
+    void radixSort(std::vector<T>& values, std::vector<T>& buffer, KeyOf&& key) {
+        constexpr auto RADIX = 256;
+        constexpr auto PASSES = sizeof(uint64_t);
+
+        const auto count = values.size();
+        if (count < 2) {
+            return;
+        }
+
+        std::array<std::array<size_t, RADIX>, PASSES> histograms {};
+        for (const auto& value : values) {
+            const uint64_t k = key(value);
+            for (size_t pass = 0; pass < PASSES; ++pass) {
+                ++histograms[pass][(k >> (pass * 8)) & 0xFF];
+            }
+        }
+
+        buffer.resize(count);
+
+        for (size_t pass = 0; pass < PASSES; ++pass) {
+            auto& histogram = histograms[pass];
+            const auto shift = pass * 8;
+
+            // every value has the same byte, order stays as is
+            if (histogram[(key(values[0]) >> shift) & 0xFF] == count) {
+                continue;
+            }
+
+            // exclusive prefix sum gives first output position of every byte value
+            size_t offset = 0;
+            for (auto& bucket : histogram) {
+                const auto size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+
+            for (auto& value : values) {
+                buffer[histogram[(key(value) >> shift) & 0xFF]++] = std::move(value);
+            }
+
+            values.swap(buffer);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+namespace Limitless {
+    /*
+     * xoshiro128+ pseudo random generator
+     *
+     * 16 bytes of state and a few integer ops per number, so it is much cheaper
+     * than std engines used through std::uniform_real_distribution;
+     * meets UniformRandomBitGenerator requirements to be used with std distributions
+     */
+    class Xoshiro128 {
+    private:
+        uint32_t state[4];
+
+        static constexpr uint32_t rotl(uint32_t x, int k) noexcept {
+            return (x << k) | (x >> (32 - k));
+        }
+
+        // expands seed to full state, so close seeds give unrelated sequences
+        static constexpr uint64_t splitmix64(uint64_t& x) noexcept {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31u);
+        }
+    public:
+        using result_type = uint32_t;
+
+        explicit Xoshiro128(uint64_t seed = 0) noexcept {
+            this->seed(seed);
+        }
+
+        void seed(uint64_t seed) noexcept {
+            const auto a = splitmix64(seed);
+            const auto b = splitmix64(seed);
+            state[0] = static_cast<uint32_t>(a);
+            state[1] = static_cast<uint32_t>(a >> 32u);
+            state[2] = static_cast<uint32_t>(b);
+            state[3] = static_cast<uint32_t>(b >> 32u);
+        }
+
+        static constexpr result_type min() noexcept { return std::numeric_limits<result_type>::min(); }
+        static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()() noexcept {
+            const auto result = state[0] + state[3];
+            const auto t = state[1] << 9u;
+
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+
+            state[2] ^= t;
+            state[3] = rotl(state[3], 11);
+
+            return result;
+        }
+
+        // uniform float in [0, 1); low bits of xoshiro128+ are weak, so upper 24 are used
+        float nextFloat() noexcept {
+            return static_cast<float>((*this)() >> 8u) * (1.0f / 16777216.0f);
+        }
+
+        // uniform integer in [0, range) without division
+        uint32_t nextBelow(uint64_t range) noexcept {
+            return static_cast<uint32_t>((static_cast<uint64_t>((*this)()) * range) >> 32u);
+        }
+
+        /*
+         * fills values with uniform floats in [0, 1)
+         *
+         * large batches are generated by independent lanes seeded from this generator,
+         * lanes have no dependency on each other, so the loop is vectorized by compiler
+         */
+        void fill(float* values, size_t count) noexcept {
+            constexpr size_t LANES = 8;
+            size_t i = 0;
+
+            if (count >= LANES * 8) {
+                uint32_t s0[LANES], s1[LANES], s2[LANES], s3[LANES];
+                for (size_t l = 0; l < LANES; ++l) {
+                    s0[l] = (*this)();
+                    s1[l] = (*this)();
+                    s2[l] = (*this)();
+                    s3[l] = (*this)() | 1u;
+                }
+
+                for (; i + LANES <= count; i += LANES) {
+                    for (size_t l = 0; l < LANES; ++l) {
+                        const auto result = s0[l] + s3[l];
+                        const auto t = s1[l] << 9u;
+
+                        s2[l] ^= s0[l];
+                        s3[l] ^= s1[l];
+                        s1[l] ^= s2[l];
+                        s0[l] ^= s3[l];
+
+                        s2[l] ^= t;
+                        s3[l] = rotl(s3[l], 11);
+
+                        values[i + l] = static_cast<float>(result >> 8u) * (1.0f / 16777216.0f);
+                    }
+                }
+            }
+
+            for (; i < count; ++i) {
+                values[i] = nextFloat();
+            }
+        }
+    };
+}
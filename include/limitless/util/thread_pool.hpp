@@ -2,6 +2,9 @@
 
 #include <condition_variable>
 #include <functional>
+#include <algorithm>
+#include <exception>
+#include <atomic>
 #include <future>
 #include <vector>
 #include <thread>
@@ -46,6 +49,61 @@ namespace Limitless {
             return future;
         }
 
+        /*
+         * calls f(i) for every i in [0, count)
+         *
+         * range is split into chunks that are taken dynamically by workers and the calling thread;
+         * works as a barrier: returns only when all chunks are done
+         */
+        template<typename F>
+        void forEach(size_t count, size_t chunk_size, F&& f) {
+            const auto chunk_count = (count + chunk_size - 1) / chunk_size;
+            if (chunk_count == 0) {
+                return;
+            }
+
+            std::atomic<size_t> next_chunk {0};
+            const auto process = [&] {
+                for (auto chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++) {
+                    const auto end = std::min(count, (chunk + 1) * chunk_size);
+                    for (auto i = chunk * chunk_size; i < end; ++i) {
+                        f(i);
+                    }
+                }
+            };
+
+            std::vector<std::future<void>> futures;
+            const auto helpers = std::min(threads.size(), chunk_count - 1);
+            futures.reserve(helpers);
+            for (size_t i = 0; i < helpers; ++i) {
+                futures.emplace_back(add(process));
+            }
+
+            // every helper must finish before leaving, they reference this stack frame
+            std::exception_ptr error;
+            try {
+                process();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            for (auto& future : futures) {
+                try {
+                    future.get();
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        [[nodiscard]] auto getSize() const noexcept { return threads.size(); }
+
         void joinAll();
     };
 }
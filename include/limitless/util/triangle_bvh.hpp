@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <optional>
+#include <cstdint>
+#include <vector>
+
+namespace Limitless {
+    struct TriangleHit {
+        // index of triangle in index list, i.e. its vertices are indices [3 * triangle, 3 * triangle + 2]
+        uint32_t triangle {};
+        // distance in units of ray direction
+        float distance {};
+        // weights of second and third vertex, first one is 1 - x - y
+        glm::vec2 barycentric {};
+    };
+
+    // Moller-Trumbore ray-triangle test; hits at distance in [0, max_distance] are reported, both faces are hit
+    std::optional<TriangleHit> intersectTriangle(const glm::vec3& origin, const glm::vec3& direction,
+                                                 const glm::vec3& a, const glm::vec3& b, const glm::vec3& c,
+                                                 float max_distance) noexcept;
+
+    /*
+     * Static bounding volume hierarchy over triangles of mesh
+     *
+     * built once by binned surface area heuristic; triangles are stored in leaf order, so ray cast
+     * touches O(log n) nodes and few contiguous triangles instead of all of them
+     */
+    class TriangleBVH {
+    private:
+        struct Node {
+            glm::vec3 min;
+            // leaf: first triangle; internal: index of right child, left child follows node
+            uint32_t offset {};
+            glm::vec3 max;
+            // triangle count of leaf, 0 for internal node
+            uint32_t count {};
+        };
+
+        struct Triangle {
+            glm::vec3 a, b, c;
+            uint32_t id;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<Triangle> triangles;
+
+        uint32_t build(std::vector<glm::vec3>& centroids, uint32_t begin, uint32_t end);
+    public:
+        static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+        TriangleBVH(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices);
+
+        [[nodiscard]] std::optional<TriangleHit> raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const;
+
+        [[nodiscard]] size_t getTriangleCount() const noexcept { return triangles.size(); }
+        [[nodiscard]] size_t getNodeCount() const noexcept { return nodes.size(); }
+    };
+}
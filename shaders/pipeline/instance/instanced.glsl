@@ -2,6 +2,14 @@ layout (std430) buffer model_buffer {
     mat4 _models[];
 };
 
+// first transform of draw when several instanced draws share the buffer
+uniform uint _instance_offset;
+
 mat4 getModelMatrix() {
-    return _models[gl_InstanceID];
+    #if defined (SHADER_DRAW_PARAMETERS)
+        // multi draw indirect commands keep their first transform in base instance
+        return _models[_instance_offset + uint(gl_BaseInstanceARB) + uint(gl_InstanceID)];
+    #else
+        return _models[_instance_offset + uint(gl_InstanceID)];
+    #endif
 }
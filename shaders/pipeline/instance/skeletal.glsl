@@ -2,14 +2,17 @@ layout (std430) buffer bone_buffer {
     mat4 _bones[];
 };
 
+// bones of all skeletal instances share one storage, instance palette starts at offset
+uniform uint _bone_offset;
+
 mat4 getBoneMatrix() {
     ivec4 bone_id = getVertexBoneID();
     vec4 bone_weight = getVertexBoneWeight();
 
-    mat4 bone_transform = _bones[bone_id[0]] * bone_weight[0];
-    bone_transform     += _bones[bone_id[1]] * bone_weight[1];
-    bone_transform     += _bones[bone_id[2]] * bone_weight[2];
-    bone_transform     += _bones[bone_id[3]] * bone_weight[3];
+    mat4 bone_transform = _bones[_bone_offset + uint(bone_id[0])] * bone_weight[0];
+    bone_transform     += _bones[_bone_offset + uint(bone_id[1])] * bone_weight[1];
+    bone_transform     += _bones[_bone_offset + uint(bone_id[2])] * bone_weight[2];
+    bone_transform     += _bones[_bone_offset + uint(bone_id[3])] * bone_weight[3];
 
     return bone_transform;
 }
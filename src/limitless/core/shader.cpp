@@ -22,6 +22,10 @@ namespace {
 
     inline constexpr auto explicit_uniform_location = "GL_ARB_explicit_uniform_location";
     inline constexpr auto extension_explicit_uniform_location = "#extension GL_ARB_explicit_uniform_location : require\n";
+
+    inline constexpr auto shader_draw_parameters = "GL_ARB_shader_draw_parameters";
+    inline constexpr auto extension_shader_draw_parameters = "#extension GL_ARB_shader_draw_parameters : require\n";
+    inline constexpr auto shader_draw_parameters_define = "#define SHADER_DRAW_PARAMETERS\n";
 }
 
 Shader::Shader(fs::path _path, Type _type, const ShaderAction& action)
@@ -112,6 +116,12 @@ void Shader::replaceExtensions() noexcept {
         extensions.append(extension_explicit_uniform_location);
     }
 
+    // draw parameters exist only in vertex stage
+    if (type == Type::Vertex && ContextInitializer::isExtensionSupported(shader_draw_parameters)) {
+        extensions.append(extension_shader_draw_parameters);
+        extensions.append(shader_draw_parameters_define);
+    }
+
     if (ContextInitializer::isExtensionSupported(bindless_texture)) {
         extensions.append(extension_bindless_texture);
         extensions.append(bindless_texture_define);
@@ -0,0 +1,101 @@
+#include <limitless/fx/beam_geometry.hpp>
+
+using namespace Limitless::fx;
+
+namespace {
+    constexpr auto DOT_PRODUCT_RANGE = glm::vec2(0.2f, 0.8f);
+
+    glm::vec2 perpendicular(const glm::vec2& v) noexcept {
+        return {-v.y, v.x};
+    }
+
+    // screen space offset of strip edge at point joining segments with directions incoming and line_normal
+    glm::vec2 getMiterOffset(const glm::vec4& point, const glm::vec2& line_normal, const glm::vec2& incoming, float size) noexcept {
+        const auto miter = glm::normalize(line_normal + perpendicular(incoming));
+        const auto dot = glm::clamp(glm::dot(miter, line_normal), DOT_PRODUCT_RANGE.x, DOT_PRODUCT_RANGE.y);
+        return miter * size / point.w * 0.5f / dot;
+    }
+
+    glm::vec4 unproject(const BeamFrame& frame, const glm::vec4& point, const glm::vec2& offset) noexcept {
+        const auto ndc = (glm::vec2(point) + offset) / frame.resolution * 2.0f - 1.0f;
+        return frame.inverse_view_projection * glm::vec4(ndc.x * point.w, ndc.y * point.w, point.z * point.w, point.w);
+    }
+}
+
+BeamFrame::BeamFrame(const glm::mat4& projection, const glm::mat4& view, const glm::vec2& _resolution) noexcept
+    : view_projection {projection * view}
+    , inverse_view_projection {glm::inverse(view_projection)}
+    , resolution {_resolution} {
+}
+
+void Limitless::fx::generateBeamLine(std::vector<glm::vec3>& line, const glm::vec3& source, const glm::vec3& target, float displacement, float offset, Xoshiro128& generator) {
+    size_t levels = 0;
+    for (auto d = displacement; d >= offset && levels < MAX_BEAM_LEVELS; d *= 0.5f) {
+        ++levels;
+    }
+
+    const auto segments = size_t{1} << levels;
+    line.resize(segments + 3);
+
+    // points are [1, segments + 1], ends are wrapped neighbours
+    auto* points = line.data() + 1;
+    points[0] = source;
+    points[segments] = target;
+
+    auto d = displacement;
+    for (auto step = segments / 2; step > 0; step /= 2, d *= 0.5f) {
+        for (auto i = step; i < segments; i += step * 2) {
+            const auto random = glm::vec3 {generator.nextFloat(), generator.nextFloat(), generator.nextFloat()} * 2.0f - 1.0f;
+            points[i] = (points[i - step] + points[i + step]) * 0.5f + random * d;
+        }
+    }
+
+    line.front() = points[segments];
+    line.back() = points[0];
+}
+
+void Limitless::fx::generateBeamVertices(const BeamFrame& frame, const std::vector<glm::vec3>& line, float size, std::vector<glm::vec4>& screen, BeamVertex* vertices) {
+    if (line.size() < 4) {
+        return;
+    }
+
+    // window coordinates with depth divided and w kept for unprojection
+    screen.resize(line.size());
+    for (size_t i = 0; i < line.size(); ++i) {
+        auto point = frame.view_projection * glm::vec4(line[i], 1.0f);
+        point.x /= point.w;
+        point.y /= point.w;
+        point.z /= point.w;
+
+        const auto window = (glm::vec2(point) + 1.0f) * 0.5f * frame.resolution;
+        point.x = window.x;
+        point.y = window.y;
+
+        screen[i] = point;
+    }
+
+    for (size_t i = 0; i + 3 < line.size(); ++i) {
+        const auto& a = screen[i];
+        const auto& b = screen[i + 1];
+        const auto& c = screen[i + 2];
+        const auto& d = screen[i + 3];
+
+        // segment b-c with a and d as neighbours
+        const auto line_normal = perpendicular(glm::normalize(glm::vec2(c) - glm::vec2(b)));
+        const auto begin = getMiterOffset(b, line_normal, glm::normalize(glm::vec2(b) - glm::vec2(a)), size);
+        const auto end = getMiterOffset(c, line_normal, glm::normalize(glm::vec2(d) - glm::vec2(c)), size);
+
+        const auto begin_left = unproject(frame, b, begin);
+        const auto begin_right = unproject(frame, b, -begin);
+        const auto end_right = unproject(frame, c, -end);
+        const auto end_left = unproject(frame, c, end);
+
+        auto* quad = vertices + i * 6;
+        quad[0] = { begin_left, {0.0f, 1.0f} };
+        quad[1] = { begin_right, {0.0f, 0.0f} };
+        quad[2] = { end_right, {1.0f, 0.0f} };
+        quad[3] = { begin_left, {0.0f, 1.0f} };
+        quad[4] = { end_right, {1.0f, 0.0f} };
+        quad[5] = { end_left, {0.0f, 1.0f} };
+    }
+}
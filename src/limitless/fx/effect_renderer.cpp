@@ -6,63 +6,44 @@
 #include <limitless/core/context.hpp>
 #include <limitless/core/uniform_setter.hpp>
 #include <limitless/fx/emitters/emitter_visitor.hpp>
-#include <limitless/fx/emitters/visitor_creator.hpp>
+#include <limitless/fx/emitters/visitor_collector.hpp>
 
 using namespace Limitless::fx;
 
 void EffectRenderer::visitEmitters(const Instances& instances, EmitterVisitor& emitter_visitor) noexcept {
-    auto effect_instance_visitor = [] (const EffectInstance& effect_instance, EmitterVisitor& visitor) {
-        for (const auto& [name, emitter] : effect_instance.getEmitters()) {
-            emitter->accept(visitor);
-        }
-    };
-
-    std::function<void(const AbstractInstance& instance)> visitor = [&] (const AbstractInstance& instance) {
-        for (const auto& [_, attachment] : instance.getAttachments()) {
-            visitor(*attachment);
+    // attachments are already in the list
+    for (const auto& instance : instances) {
+        if (instance.get().getShaderType() != ModelShader::Effect) {
+            continue;
         }
 
-        if (instance.getShaderType() == ModelShader::Effect) {
-            effect_instance_visitor(static_cast<const EffectInstance&>(instance), emitter_visitor);
+        for (const auto& [name, emitter] : static_cast<const EffectInstance&>(instance.get()).getEmitters()) {
+            emitter->accept(emitter_visitor);
         }
-    };
-
-    for (const auto& instance : instances) {
-        visitor(instance);
     }
 }
 
-void EffectRenderer::updateRenderers(const Instances& instances) noexcept {
-    EmitterRendererCreator creator {renderers};
-    visitEmitters(instances, creator);
-}
-
 void EffectRenderer::update(const Instances& instances) {
-    updateRenderers(instances);
+    for (const auto& [_, renderer] : renderers) {
+        renderer->emitters.clear();
+    }
+
+    EmitterCollector collector {renderers};
+    visitEmitters(instances, collector);
 
     for (const auto& [type, renderer] : renderers) {
         type.material->update();
         switch (type.emitter_type) {
-            case AbstractEmitter::Type::Sprite: {
-                ParticleCollector<SpriteParticle> collector {type};
-                visitEmitters(instances, collector);
-                static_cast<EmitterRenderer<SpriteParticle>&>(*renderer).update(collector);
+            case AbstractEmitter::Type::Sprite:
+                static_cast<EmitterRenderer<SpriteParticle>&>(*renderer).update();
                 break;
-            }
-            case AbstractEmitter::Type::Mesh: {
-                ParticleCollector<MeshParticle> collector {type};
-                visitEmitters(instances, collector);
-                static_cast<EmitterRenderer<MeshParticle>&>(*renderer).update(collector);
+            case AbstractEmitter::Type::Mesh:
+                static_cast<EmitterRenderer<MeshParticle>&>(*renderer).update();
                 break;
-            }
-            case AbstractEmitter::Type::Beam: {
-                ParticleCollector<BeamParticleMapping> collector {type};
-                visitEmitters(instances, collector);
-                static_cast<EmitterRenderer<BeamParticle>&>(*renderer).update(collector);
+            case AbstractEmitter::Type::Beam:
+                static_cast<EmitterRenderer<BeamParticle>&>(*renderer).update();
                 break;
-            }
         }
-
     }
 }
 
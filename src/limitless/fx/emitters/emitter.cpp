@@ -1,5 +1,7 @@
 #include <limitless/fx/emitters/emitter.hpp>
 
+#include <limitless/fx/particle_kernels.hpp>
+
 using namespace Limitless::fx;
 
 template<typename Particle>
@@ -14,18 +16,23 @@ Emitter<P>::Emitter(Type _type)
 
 template<typename P>
 void Emitter<P>::emit(uint32_t count) noexcept {
-    for (uint32_t i = 0; i < count; ++i) {
-        P particle {};
+    if (count == 0) {
+        return;
+    }
 
-        particle.position = local_position + position;
-        particle.rotation = glm::eulerAngles(rotation * local_rotation);
+    P prototype {};
+    prototype.position = local_position + position;
+    prototype.rotation = glm::eulerAngles(rotation * local_rotation);
 
-        for (auto& module : modules) {
-            module->initialize(*this, particle, particles.size());
-        }
+    // streams grow once for the whole batch, then every module fills its ranges
+    const auto begin = particles.count();
+    particles.append(prototype, count);
 
-        particles.emplace_back(particle);
+    for (auto& module : modules) {
+        module->initialize(*this, particles, begin, count);
     }
+
+    particles.captureLifespan(begin);
 }
 
 template<typename P>
@@ -109,9 +116,7 @@ void Emitter<P>::setPosition(const glm::vec3& new_position) noexcept {
         const auto final_position = new_position + local_position;
         const auto diff = final_position - (position + local_position);
 
-        for (auto& particle : particles) {
-            particle.position += diff;
-        }
+        kernels::addScaled(particles.position.data(), diff, particles.count(), 1.0f);
     }
 
     position = new_position;
@@ -123,11 +128,11 @@ void Emitter<P>::setRotation(const glm::quat& new_rotation) noexcept {
         const auto final_rotation = new_rotation * local_rotation;
         const auto diff = final_rotation * glm::inverse(rotation * local_rotation);
 
-        for (auto& particle : particles) {
-            particle.rotation += glm::eulerAngles(diff);
+        kernels::addScaled(particles.rotation.data(), glm::eulerAngles(diff), particles.count(), 1.0f);
 
-            particle.velocity = diff * particle.velocity;
-            particle.acceleration = diff * particle.acceleration;
+        for (size_t i = 0; i < particles.count(); ++i) {
+            particles.velocity[i] = diff * particles.velocity[i];
+            particles.acceleration[i] = diff * particles.acceleration[i];
         }
     }
 
@@ -136,30 +141,24 @@ void Emitter<P>::setRotation(const glm::quat& new_rotation) noexcept {
 
 template<typename P>
 void Emitter<P>::spawnParticles() noexcept {
-    using namespace std::chrono;
-
     if (spawn.spawn_rate <= 0.0f) {
         return;
     }
 
     const auto isFirst = [&] () {
-        return spawn.last_spawn == time_point<steady_clock>();
+        return !spawn.last_spawn.has_value();
     };
 
-    const auto current_time = steady_clock::now();
-    if (isFirst()) {
-        spawn.last_spawn = current_time;
-    }
-    const auto delta = duration_cast<std::chrono::duration<float>>(current_time - spawn.last_spawn).count();
+    const auto delta = isFirst() ? 0.0f : (time - *spawn.last_spawn).count();
 
     switch (spawn.mode) {
         case EmitterSpawn::Mode::Spray: {
             if (delta >= (1.0f / spawn.spawn_rate) || isFirst()) {
-                const auto remaining = spawn.max_count - particles.size();
+                const auto remaining = spawn.max_count - particles.count();
                 if (remaining > 0) {
                     emit(glm::clamp(static_cast<size_t>(delta * spawn.spawn_rate), static_cast<size_t>(1), remaining));
                 }
-                spawn.last_spawn = current_time;
+                spawn.last_spawn = time;
             }
             break;
         }
@@ -167,14 +166,14 @@ void Emitter<P>::spawnParticles() noexcept {
             if (spawn.burst->loops != spawn.burst->loops_done) {
                 if (delta >= (1.0f / spawn.spawn_rate) || isFirst()) {
                     auto emit_count = spawn.burst->burst_count->get();
-                    emit_count = (particles.size() + emit_count > spawn.max_count) ? spawn.max_count - particles.size() : emit_count;
+                    emit_count = (particles.count() + emit_count > spawn.max_count) ? spawn.max_count - particles.count() : emit_count;
                     emit(emit_count);
 
                     if (spawn.burst->loops != -1) {
                         ++spawn.burst->loops_done;
                     }
 
-                    spawn.last_spawn = current_time;
+                    spawn.last_spawn = time;
                 }
             }
             break;
@@ -183,49 +182,28 @@ void Emitter<P>::spawnParticles() noexcept {
 
 template<typename P>
 void Emitter<P>::killParticles() noexcept {
-    std::vector<size_t> indices;
-    for (size_t i = 0; i < particles.size(); ++i) {
-        if (particles[i].lifetime <= 0.0f) {
-            indices.emplace_back(i);
-        }
-    }
-
-    for (auto it = particles.begin(); it != particles.end();) {
-        if (it->lifetime <= 0.0f) {
-            it = particles.erase(it);
-        } else {
-            ++it;
-        }
+    if (!particles.kill(remap)) {
+        return;
     }
 
     for (auto& module : modules) {
-        module->deinitialize(indices);
+        module->deinitialize(remap);
     }
 }
 
 template<typename P>
-void Emitter<P>::update([[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) {
-    using namespace std::chrono;
-
-    const auto current_time = steady_clock::now();
-    const auto delta_time = duration_cast<std::chrono::duration<float>>(current_time - last_time);
-    last_time = current_time;
-
-	if (start_time == time_point<steady_clock>()) {
-		start_time = current_time;
-	}
+void Emitter<P>::update([[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera, float dt) {
+    time += std::chrono::duration<float>(dt);
 
     killParticles();
 
     {
         for (auto& module : modules) {
-            module->update(*this, particles, delta_time.count(), ctx, camera);
+            module->update(*this, particles, dt, ctx, camera);
         }
 
-        for (auto& particle : particles) {
-            particle.position += particle.velocity * delta_time.count();
-            particle.velocity += particle.acceleration * delta_time.count();
-        }
+        kernels::addScaled(particles.position.data(), particles.velocity.data(), particles.count(), dt);
+        kernels::addScaled(particles.velocity.data(), particles.acceleration.data(), particles.count(), dt);
     }
 
     if (!done) {
@@ -233,7 +211,7 @@ void Emitter<P>::update([[maybe_unused]] Context& ctx, [[maybe_unused]] const Ca
     }
 
     if (duration.count() != 0.0f) {
-        if (current_time - start_time >= duration) {
+        if (time >= duration) {
             done = true;
         }
     }
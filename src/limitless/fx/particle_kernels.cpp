@@ -0,0 +1,223 @@
+#include <limitless/fx/particle_kernels.hpp>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define LIMITLESS_SIMD_AVX
+    #define LIMITLESS_SIMD_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define LIMITLESS_SIMD_SSE
+#endif
+
+using namespace Limitless::fx;
+
+namespace {
+    inline float* flat(glm::vec3* values) noexcept { return reinterpret_cast<float*>(values); }
+    inline const float* flat(const glm::vec3* values) noexcept { return reinterpret_cast<const float*>(values); }
+    inline float* flat(glm::vec4* values) noexcept { return reinterpret_cast<float*>(values); }
+    inline const float* flat(const glm::vec4* values) noexcept { return reinterpret_cast<const float*>(values); }
+}
+
+void kernels::add(float* values, size_t count, float delta) noexcept {
+    size_t i = 0;
+
+#if defined(LIMITLESS_SIMD_AVX)
+    const auto d = _mm256_set1_ps(delta);
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), d));
+    }
+#elif defined(LIMITLESS_SIMD_SSE)
+    const auto d = _mm_set1_ps(delta);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), d));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        values[i] += delta;
+    }
+}
+
+void kernels::addScaled(float* values, const float* rates, size_t count, float scale) noexcept {
+    size_t i = 0;
+
+#if defined(LIMITLESS_SIMD_AVX)
+    const auto s = _mm256_set1_ps(scale);
+    for (; i + 8 <= count; i += 8) {
+        const auto r = _mm256_mul_ps(_mm256_loadu_ps(rates + i), s);
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), r));
+    }
+#elif defined(LIMITLESS_SIMD_SSE)
+    const auto s = _mm_set1_ps(scale);
+    for (; i + 4 <= count; i += 4) {
+        const auto r = _mm_mul_ps(_mm_loadu_ps(rates + i), s);
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), r));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        values[i] += rates[i] * scale;
+    }
+}
+
+void kernels::addScaled(glm::vec3* values, const glm::vec3* rates, size_t count, float scale) noexcept {
+    addScaled(flat(values), flat(rates), count * 3, scale);
+}
+
+void kernels::addScaled(glm::vec3* values, const glm::vec3& rate, size_t count, float scale) noexcept {
+    const auto delta = rate * scale;
+    size_t i = 0;
+
+#if defined(LIMITLESS_SIMD_SSE)
+    // three registers cover four particles repeating xyz pattern
+    const auto d0 = _mm_setr_ps(delta.x, delta.y, delta.z, delta.x);
+    const auto d1 = _mm_setr_ps(delta.y, delta.z, delta.x, delta.y);
+    const auto d2 = _mm_setr_ps(delta.z, delta.x, delta.y, delta.z);
+
+    for (; i + 4 <= count; i += 4) {
+        auto* v = flat(values + i);
+        _mm_storeu_ps(v, _mm_add_ps(_mm_loadu_ps(v), d0));
+        _mm_storeu_ps(v + 4, _mm_add_ps(_mm_loadu_ps(v + 4), d1));
+        _mm_storeu_ps(v + 8, _mm_add_ps(_mm_loadu_ps(v + 8), d2));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        values[i] += delta;
+    }
+}
+
+void kernels::clamp(glm::vec4* values, size_t count, float min, float max) noexcept {
+    auto* v = flat(values);
+    const auto size = count * 4;
+    size_t i = 0;
+
+#if defined(LIMITLESS_SIMD_AVX)
+    const auto lo = _mm256_set1_ps(min);
+    const auto hi = _mm256_set1_ps(max);
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(v + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(v + i), lo), hi));
+    }
+#elif defined(LIMITLESS_SIMD_SSE)
+    const auto lo = _mm_set1_ps(min);
+    const auto hi = _mm_set1_ps(max);
+    for (; i + 4 <= size; i += 4) {
+        _mm_storeu_ps(v + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(v + i), lo), hi));
+    }
+#endif
+
+    for (; i < size; ++i) {
+        v[i] = glm::clamp(v[i], min, max);
+    }
+}
+
+void kernels::approach(float* values, const float* targets, bool uniform, const float* lifetime, size_t count, float dt) noexcept {
+    if (count == 0) {
+        return;
+    }
+
+    size_t i = 0;
+
+#if defined(LIMITLESS_SIMD_AVX)
+    const auto delta = _mm256_set1_ps(dt);
+    const auto uniform_target = _mm256_set1_ps(targets[0]);
+    for (; i + 8 <= count; i += 8) {
+        const auto t = uniform ? uniform_target : _mm256_loadu_ps(targets + i);
+        const auto v = _mm256_loadu_ps(values + i);
+        const auto f = _mm256_div_ps(delta, _mm256_loadu_ps(lifetime + i));
+        _mm256_storeu_ps(values + i, _mm256_add_ps(v, _mm256_mul_ps(_mm256_sub_ps(t, v), f)));
+    }
+#elif defined(LIMITLESS_SIMD_SSE)
+    const auto delta = _mm_set1_ps(dt);
+    const auto uniform_target = _mm_set1_ps(targets[0]);
+    for (; i + 4 <= count; i += 4) {
+        const auto t = uniform ? uniform_target : _mm_loadu_ps(targets + i);
+        const auto v = _mm_loadu_ps(values + i);
+        const auto f = _mm_div_ps(delta, _mm_loadu_ps(lifetime + i));
+        _mm_storeu_ps(values + i, _mm_add_ps(v, _mm_mul_ps(_mm_sub_ps(t, v), f)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const auto& target = uniform ? targets[0] : targets[i];
+        values[i] += (target - values[i]) * (dt / lifetime[i]);
+    }
+}
+
+void kernels::approach(glm::vec3* values, const glm::vec3* targets, bool uniform, const float* lifetime, size_t count, float dt) noexcept {
+    if (count == 0) {
+        return;
+    }
+
+    size_t i = 0;
+
+#if defined(LIMITLESS_SIMD_SSE)
+    const auto delta = _mm_set1_ps(dt);
+    const auto& target = targets[0];
+    const auto ut0 = _mm_setr_ps(target.x, target.y, target.z, target.x);
+    const auto ut1 = _mm_setr_ps(target.y, target.z, target.x, target.y);
+    const auto ut2 = _mm_setr_ps(target.z, target.x, target.y, target.z);
+
+    // four particles per iteration; factors are spread over xyz lanes with shuffles
+    for (; i + 4 <= count; i += 4) {
+        auto* v = flat(values + i);
+        const auto* t = flat(targets + (uniform ? 0 : i));
+
+        const auto f = _mm_div_ps(delta, _mm_loadu_ps(lifetime + i));
+        const auto f0 = _mm_shuffle_ps(f, f, _MM_SHUFFLE(1, 0, 0, 0));
+        const auto f1 = _mm_shuffle_ps(f, f, _MM_SHUFFLE(2, 2, 1, 1));
+        const auto f2 = _mm_shuffle_ps(f, f, _MM_SHUFFLE(3, 3, 3, 2));
+
+        const auto t0 = uniform ? ut0 : _mm_loadu_ps(t);
+        const auto t1 = uniform ? ut1 : _mm_loadu_ps(t + 4);
+        const auto t2 = uniform ? ut2 : _mm_loadu_ps(t + 8);
+
+        const auto v0 = _mm_loadu_ps(v);
+        const auto v1 = _mm_loadu_ps(v + 4);
+        const auto v2 = _mm_loadu_ps(v + 8);
+
+        _mm_storeu_ps(v, _mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(t0, v0), f0)));
+        _mm_storeu_ps(v + 4, _mm_add_ps(v1, _mm_mul_ps(_mm_sub_ps(t1, v1), f1)));
+        _mm_storeu_ps(v + 8, _mm_add_ps(v2, _mm_mul_ps(_mm_sub_ps(t2, v2), f2)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const auto& target = uniform ? targets[0] : targets[i];
+        values[i] += (target - values[i]) * (dt / lifetime[i]);
+    }
+}
+
+void kernels::approach(glm::vec4* values, const glm::vec4* targets, bool uniform, const float* lifetime, size_t count, float dt) noexcept {
+    if (count == 0) {
+        return;
+    }
+
+    size_t i = 0;
+
+#if defined(LIMITLESS_SIMD_SSE)
+    const auto delta = _mm_set1_ps(dt);
+    const auto uniform_target = _mm_loadu_ps(flat(targets));
+
+    const auto step = [&] (size_t index, __m128 factor) {
+        auto* v = flat(values + index);
+        const auto t = uniform ? uniform_target : _mm_loadu_ps(flat(targets + index));
+        const auto value = _mm_loadu_ps(v);
+        _mm_storeu_ps(v, _mm_add_ps(value, _mm_mul_ps(_mm_sub_ps(t, value), factor)));
+    };
+
+    // one particle per register; factors for four particles are computed at once
+    for (; i + 4 <= count; i += 4) {
+        const auto f = _mm_div_ps(delta, _mm_loadu_ps(lifetime + i));
+        step(i + 0, _mm_shuffle_ps(f, f, _MM_SHUFFLE(0, 0, 0, 0)));
+        step(i + 1, _mm_shuffle_ps(f, f, _MM_SHUFFLE(1, 1, 1, 1)));
+        step(i + 2, _mm_shuffle_ps(f, f, _MM_SHUFFLE(2, 2, 2, 2)));
+        step(i + 3, _mm_shuffle_ps(f, f, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const auto& target = uniform ? targets[0] : targets[i];
+        values[i] += (target - values[i]) * (dt / lifetime[i]);
+    }
+}
@@ -0,0 +1,264 @@
+#include <limitless/fx/particle_storage.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <type_traits>
+#include <algorithm>
+
+using namespace Limitless::fx;
+
+namespace {
+    template<typename Particle>
+    constexpr bool has_extra = !std::is_empty_v<ParticleExtra<Particle>>;
+
+    void scatter([[maybe_unused]] ParticleExtra<SpriteParticle>& extra, [[maybe_unused]] const SpriteParticle& particle) noexcept {}
+    void scatter([[maybe_unused]] ParticleExtra<MeshParticle>& extra, [[maybe_unused]] const MeshParticle& particle) noexcept {}
+    void gather([[maybe_unused]] SpriteParticle& particle, [[maybe_unused]] const ParticleExtra<SpriteParticle>& extra) noexcept {}
+    void gather([[maybe_unused]] MeshParticle& particle, [[maybe_unused]] const ParticleExtra<MeshParticle>& extra) noexcept {}
+
+    void scatter(ParticleExtra<BeamParticle>& extra, const BeamParticle& particle) {
+        extra.displacement = particle.displacement;
+        extra.target = particle.target;
+        extra.offset = particle.offset;
+        extra.speed = particle.speed;
+        extra.length = particle.length;
+        extra.build = particle.build;
+        extra.speed_time = particle.speed_time;
+        extra.rebuild_delta = particle.rebuild_delta;
+        extra.derivative_line = particle.derivative_line;
+        extra.since_rebuild = particle.since_rebuild;
+    }
+
+    void gather(BeamParticle& particle, const ParticleExtra<BeamParticle>& extra) {
+        particle.displacement = extra.displacement;
+        particle.target = extra.target;
+        particle.offset = extra.offset;
+        particle.speed = extra.speed;
+        particle.length = extra.length;
+        particle.build = extra.build;
+        particle.speed_time = extra.speed_time;
+        particle.rebuild_delta = extra.rebuild_delta;
+        particle.derivative_line = extra.derivative_line;
+        particle.since_rebuild = extra.since_rebuild;
+    }
+
+    // model matrix is derived state; it is built only when particle is packed
+    template<typename Particle>
+    void updateModel([[maybe_unused]] Particle& particle) noexcept {
+        if constexpr (std::is_same_v<Particle, MeshParticle>) {
+            auto model = glm::translate(glm::mat4(1.0f), particle.position);
+
+            model = glm::rotate(model, particle.rotation.x, glm::vec3(1.0f, 0.f, 0.f));
+            model = glm::rotate(model, particle.rotation.y, glm::vec3(0.0f, 1.f, 0.f));
+            model = glm::rotate(model, particle.rotation.z, glm::vec3(0.0f, 0.f, 1.f));
+
+            model = glm::scale(model, particle.size);
+
+            particle.model = model;
+        }
+    }
+}
+
+template<typename Particle>
+void ParticleStorage<Particle>::reserve(size_t count) {
+    color.reserve(count);
+    subUV.reserve(count);
+    properties.reserve(count);
+    acceleration.reserve(count);
+    lifetime.reserve(count);
+    position.reserve(count);
+    size.reserve(count);
+    rotation.reserve(count);
+    time.reserve(count);
+    velocity.reserve(count);
+    lifespan.reserve(count);
+
+    if constexpr (has_extra<Particle>) {
+        extra.reserve(count);
+    }
+}
+
+template<typename Particle>
+void ParticleStorage<Particle>::clear() noexcept {
+    color.clear();
+    subUV.clear();
+    properties.clear();
+    acceleration.clear();
+    lifetime.clear();
+    position.clear();
+    size.clear();
+    rotation.clear();
+    time.clear();
+    velocity.clear();
+    lifespan.clear();
+    extra.clear();
+}
+
+template<typename Particle>
+void ParticleStorage<Particle>::push(const Particle& particle) {
+    color.emplace_back(particle.color);
+    subUV.emplace_back(particle.subUV);
+    properties.emplace_back(particle.properties);
+    acceleration.emplace_back(particle.acceleration);
+    lifetime.emplace_back(particle.lifetime);
+    position.emplace_back(particle.position);
+    size.emplace_back(particle.size);
+    rotation.emplace_back(particle.rotation);
+    time.emplace_back(particle.time);
+    velocity.emplace_back(particle.velocity);
+    lifespan.emplace_back(particle.lifetime);
+
+    if constexpr (has_extra<Particle>) {
+        scatter(extra.emplace_back(), particle);
+    }
+}
+
+template<typename Particle>
+void ParticleStorage<Particle>::append(const Particle& prototype, size_t count) {
+    const auto total = this->count() + count;
+
+    color.resize(total, prototype.color);
+    subUV.resize(total, prototype.subUV);
+    properties.resize(total, prototype.properties);
+    acceleration.resize(total, prototype.acceleration);
+    lifetime.resize(total, prototype.lifetime);
+    position.resize(total, prototype.position);
+    size.resize(total, prototype.size);
+    rotation.resize(total, prototype.rotation);
+    time.resize(total, prototype.time);
+    velocity.resize(total, prototype.velocity);
+    lifespan.resize(total, prototype.lifetime);
+
+    if constexpr (has_extra<Particle>) {
+        ParticleExtra<Particle> value;
+        scatter(value, prototype);
+        extra.resize(total, value);
+    }
+}
+
+template<typename Particle>
+void ParticleStorage<Particle>::captureLifespan(size_t begin) noexcept {
+    std::copy(lifetime.begin() + begin, lifetime.end(), lifespan.begin() + begin);
+}
+
+template<typename Particle>
+Particle ParticleStorage<Particle>::get(size_t index) const {
+    Particle particle {};
+
+    particle.color = color[index];
+    particle.subUV = subUV[index];
+    particle.properties = properties[index];
+    particle.acceleration = acceleration[index];
+    particle.lifetime = lifetime[index];
+    particle.position = position[index];
+    particle.size = size[index];
+    particle.rotation = rotation[index];
+    particle.time = time[index];
+    particle.velocity = velocity[index];
+
+    if constexpr (has_extra<Particle>) {
+        gather(particle, extra[index]);
+    }
+
+    updateModel(particle);
+
+    return particle;
+}
+
+template<typename Particle>
+void ParticleStorage<Particle>::set(size_t index, const Particle& particle) {
+    color[index] = particle.color;
+    subUV[index] = particle.subUV;
+    properties[index] = particle.properties;
+    acceleration[index] = particle.acceleration;
+    lifetime[index] = particle.lifetime;
+    position[index] = particle.position;
+    size[index] = particle.size;
+    rotation[index] = particle.rotation;
+    time[index] = particle.time;
+    velocity[index] = particle.velocity;
+
+    if constexpr (has_extra<Particle>) {
+        scatter(extra[index], particle);
+    }
+}
+
+template<typename Particle>
+bool ParticleStorage<Particle>::kill(ParticleRemap& remap) {
+    remap.moves.clear();
+
+    // partitions lifetime stream moving the last alive particle into the first dead slot
+    size_t i = 0;
+    size_t alive = count();
+    for (;;) {
+        while (i < alive && lifetime[i] > 0.0f) {
+            ++i;
+        }
+
+        while (alive > i && lifetime[alive - 1] <= 0.0f) {
+            --alive;
+        }
+
+        if (i >= alive) {
+            break;
+        }
+
+        --alive;
+        lifetime[i] = lifetime[alive];
+        remap.moves.emplace_back(alive, i);
+        ++i;
+    }
+
+    remap.count = alive;
+
+    if (alive == count()) {
+        return false;
+    }
+
+    lifetime.resize(alive);
+
+    // stream major order; every stream is walked once
+    remap.apply(color);
+    remap.apply(subUV);
+    remap.apply(properties);
+    remap.apply(acceleration);
+    remap.apply(position);
+    remap.apply(size);
+    remap.apply(rotation);
+    remap.apply(time);
+    remap.apply(velocity);
+    remap.apply(lifespan);
+
+    if constexpr (has_extra<Particle>) {
+        remap.apply(extra);
+    }
+
+    return true;
+}
+
+template<typename Particle>
+void ParticleStorage<Particle>::pack(Particle* dst) const noexcept {
+    // extra state is not needed on GPU
+    for (size_t i = 0; i < count(); ++i) {
+        auto& particle = dst[i];
+
+        particle.color = color[i];
+        particle.subUV = subUV[i];
+        particle.properties = properties[i];
+        particle.acceleration = acceleration[i];
+        particle.lifetime = lifetime[i];
+        particle.position = position[i];
+        particle.size = size[i];
+        particle.rotation = rotation[i];
+        particle.time = time[i];
+        particle.velocity = velocity[i];
+
+        updateModel(particle);
+    }
+}
+
+namespace Limitless::fx {
+    template class ParticleStorage<SpriteParticle>;
+    template class ParticleStorage<MeshParticle>;
+    template class ParticleStorage<BeamParticle>;
+}
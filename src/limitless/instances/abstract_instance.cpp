@@ -1,5 +1,6 @@
 #include <limitless/instances/abstract_instance.hpp>
 #include <limitless/core/uniform_setter.hpp>
+#include <limitless/pipeline/render_queue.hpp>
 
 using namespace Limitless;
 
@@ -55,51 +56,80 @@ bool AbstractInstance::doesCastShadow() const noexcept {
 
 AbstractInstance& AbstractInstance::setPosition(const glm::vec3& _position) noexcept {
     position = _position;
+    model_dirty = true;
     return *this;
 }
 
 AbstractInstance& AbstractInstance::setRotation(const glm::quat& _rotation) noexcept {
     rotation = _rotation;
+    model_dirty = true;
     return *this;
 }
 
 AbstractInstance& AbstractInstance::rotateBy(const glm::quat& _rotation) noexcept {
     rotation = _rotation * rotation;
+    model_dirty = true;
     return *this;
 }
 
 AbstractInstance& AbstractInstance::setScale(const glm::vec3& _scale) noexcept {
     scale = _scale;
+    model_dirty = true;
     return *this;
 }
 
 AbstractInstance& AbstractInstance::setTransformation(const glm::mat4& transformation) {
-	transformation_matrix = transformation;
+	// sockets and attachments set it every frame, mostly to the same value
+	if (transformation_matrix != transformation) {
+		transformation_matrix = transformation;
+		final_dirty = true;
+	}
 	return *this;
 }
 
 AbstractInstance& AbstractInstance::setParent(const glm::mat4& _parent) {
-	parent = _parent;
+	if (parent != _parent) {
+		parent = _parent;
+		final_dirty = true;
+	}
 	return *this;
 }
 
+bool AbstractInstance::updateTransform() noexcept {
+	if (model_dirty) {
+		updateModelMatrix();
+		model_dirty = false;
+		final_dirty = true;
+	}
+
+	if (!final_dirty) {
+		return false;
+	}
+
+	updateFinalMatrix();
+	updateBoundingBox();
+	final_dirty = false;
+	bounds_changed = true;
+
+	return true;
+}
+
 void AbstractInstance::draw(Context& ctx, const Assets& assets, ShaderPass material_shader_type, ms::Blending blending) {
     draw(ctx, assets, material_shader_type, blending, UniformSetter {});
 }
 
-void AbstractInstance::updateAttachments(Context& context, const Camera& camera) {
-	InstanceAttachment::setParent(final_matrix);
-	InstanceAttachment::updateAttachments(context, camera);
+void AbstractInstance::enqueue(RenderQueue& queue) {
+    queue.add(*this);
 }
 
-void AbstractInstance::update(Context& context, const Camera& camera) {
-	// updates current model matrices
-	updateModelMatrix();
-	updateFinalMatrix();
-	updateBoundingBox();
+void AbstractInstance::updateAttachments(Context& context, const Camera& camera, float dt) {
+	InstanceAttachment::setParent(final_matrix);
+	InstanceAttachment::updateAttachments(context, camera, dt);
+}
 
-	// propagates current instance values to attachments
-	updateAttachments(context, camera);
+void AbstractInstance::update([[maybe_unused]] Context& context, [[maybe_unused]] const Camera& camera, [[maybe_unused]] float dt) {
+	// updates current model matrices if they are outdated; in scene hierarchy has already done it
+	updateTransform();
 }
 
 void AbstractInstance::removeOutline() noexcept {
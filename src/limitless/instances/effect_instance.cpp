@@ -25,7 +25,7 @@ EffectInstance::EffectInstance(const EffectInstance& effect) noexcept
     }
 }
 
-void EffectInstance::updateEmitters(Context& context, const Camera& camera) const noexcept {
+void EffectInstance::updateEmitters(Context& context, const Camera& camera, float dt) noexcept {
 	// because we do not use final_matrix in emitter shaders explicitly
 	// we should decompose it to parameters
 	// and set it to emitters
@@ -44,14 +44,21 @@ void EffectInstance::updateEmitters(Context& context, const Camera& camera) cons
 		emitter->setRotation(rotation);
 		//TODO
 		//emitter->setScale(scale);
-        emitter->update(context, camera);
+        emitter->update(context, camera, dt);
 	}
-}
 
-void EffectInstance::update(Context& context, const Camera& camera) {
-    AbstractInstance::update(context, camera);
-	updateEmitters(context, camera);
 	done = isDone();
+	emitters_updated = true;
+}
+
+void EffectInstance::update(Context& context, const Camera& camera, float dt) {
+    AbstractInstance::update(context, camera, dt);
+
+    // scene simulates emitters on workers before instance updates
+    if (!emitters_updated) {
+        updateEmitters(context, camera, dt);
+    }
+    emitters_updated = false;
 }
 
 void EffectInstance::draw([[maybe_unused]] Limitless::Context& ctx,
@@ -10,9 +10,16 @@ InstanceAttachment::InstanceAttachment(const InstanceAttachment& attachment) {
 	}
 }
 
-void InstanceAttachment::updateAttachments(Context& context, const Camera& camera) {
+void InstanceAttachment::updateAttachments(Context& context, const Camera& camera, float dt) {
 	for (const auto& [_, attachment] : attachments) {
-        attachment->update(context, camera);
+        attachment->update(context, camera, dt);
+        attachment->updateAttachments(context, camera, dt);
+	}
+}
+
+void InstanceAttachment::notifyStructureChange() noexcept {
+	if (structure_version) {
+		++*structure_version;
 	}
 }
 
@@ -28,6 +35,7 @@ void InstanceAttachment::attach(std::unique_ptr<AbstractInstance> attachment) {
 	if (!success) {
 		throw std::logic_error {"Attachment already attached! id: " + std::to_string(attachment->getId())};
 	}
+	notifyStructureChange();
 }
 
 void InstanceAttachment::detach(uint64_t id) {
@@ -35,6 +43,7 @@ void InstanceAttachment::detach(uint64_t id) {
 	if (erased == 0) {
 		throw std::logic_error {"There is no such attachment! id: " + std::to_string(id)};
 	}
+	notifyStructureChange();
 }
 
 const std::unique_ptr<AbstractInstance>& InstanceAttachment::getAttachment(uint64_t id) const {
@@ -5,6 +5,9 @@
 #include <limitless/assets.hpp>
 #include <limitless/core/shader_program.hpp>
 #include <limitless/core/context.hpp>
+#include <limitless/pipeline/shader_pass_types.hpp>
+
+#include <algorithm>
 
 using namespace Limitless;
 
@@ -13,6 +16,28 @@ MeshInstance::MeshInstance(std::shared_ptr<AbstractMesh> _mesh, const std::share
     , material {_material} {
 }
 
+const std::shared_ptr<AbstractMesh>& MeshInstance::getLevelMesh(uint32_t level) const noexcept {
+    if (level == 0 || lods.empty()) {
+        return mesh;
+    }
+
+    return lods[std::min<size_t>(level, lods.size()) - 1];
+}
+
+const std::shared_ptr<AbstractMesh>& MeshInstance::getMesh(ShaderPass pass) const noexcept {
+    return getLevelMesh(pass == ShaderPass::DirectionalShadow ? shadow_lod : lod);
+}
+
+void MeshInstance::addLevelOfDetail(std::shared_ptr<AbstractMesh> level_mesh) {
+    lods.emplace_back(std::move(level_mesh));
+}
+
+void MeshInstance::setLevelOfDetail(uint32_t level, uint32_t shadow_level) noexcept {
+    const auto coarsest = static_cast<uint32_t>(lods.size());
+    lod = std::min(level, coarsest);
+    shadow_lod = std::min(shadow_level, coarsest);
+}
+
 void MeshInstance::hide() noexcept {
     hidden = true;
 }
@@ -31,6 +56,8 @@ void MeshInstance::draw(Context& ctx,
     if (hidden) {
         return;
     }
+
+    const auto& drawn = getMesh(pass);
     //TODO: refactor this shitty unreadable nonhuman orc code
     if (!material.isLayered()) {
         const auto& mat = material[0];
@@ -57,9 +84,9 @@ void MeshInstance::draw(Context& ctx,
         if (mat.contains(ms::Property::TessellationFactor)) {
             //TODO: move to somewhere else
             glPatchParameteri(GL_PATCH_VERTICES, 4);
-            mesh->draw(VertexStreamDraw::Patches);
+            drawn->draw(VertexStreamDraw::Patches);
         } else {
-            mesh->draw();
+            drawn->draw();
         }
         return;
     }
@@ -87,9 +114,9 @@ void MeshInstance::draw(Context& ctx,
 
         if (mat->contains(ms::Property::TessellationFactor)) {
             glPatchParameteri(GL_PATCH_VERTICES, 4);
-            mesh->draw(VertexStreamDraw::Patches);
+            drawn->draw(VertexStreamDraw::Patches);
         } else {
-            mesh->draw();
+            drawn->draw();
         }
     }
 }
@@ -106,6 +133,8 @@ void MeshInstance::draw_instanced(Context& ctx,
         return;
     }
 
+    const auto& drawn = getMesh(pass);
+
     // iterates over material layers
     for (const auto& [index, mat] : material) {
         if (mat->getBlending() != blending) {
@@ -118,8 +147,9 @@ void MeshInstance::draw_instanced(Context& ctx,
         // gets required shader from storage
         auto& shader = assets.shaders.get(pass, model, mat->getShaderIndex());
 
-        // updates model/material uniforms
+        // updates model/material uniforms; whole model buffer belongs to this draw
         shader << UniformValue {"_model_transform", model_matrix}
+               << UniformValue {"_instance_offset", 0u}
                << *mat;
 
         // sets custom pass-dependent uniforms
@@ -129,9 +159,9 @@ void MeshInstance::draw_instanced(Context& ctx,
 
         if (mat->contains(ms::Property::TessellationFactor)) {
             glPatchParameteri(GL_PATCH_VERTICES, 4);
-            mesh->draw_instanced(VertexStreamDraw::Patches, count);
+            drawn->draw_instanced(VertexStreamDraw::Patches, count);
         } else {
-            mesh->draw_instanced(count);
+            drawn->draw_instanced(count);
         }
     }
 }
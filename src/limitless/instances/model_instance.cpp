@@ -2,6 +2,9 @@
 
 #include <limitless/models/model.hpp>
 #include <limitless/models/elementary_model.hpp>
+#include <limitless/models/mesh.hpp>
+#include <limitless/pipeline/render_queue.hpp>
+#include <limitless/camera.hpp>
 #include <stdexcept>
 
 using namespace Limitless;
@@ -14,9 +17,23 @@ ModelInstance::ModelInstance(ModelShader shader, decltype(model) _model, const g
         auto& model_meshes = simple_model.getMeshes();
         auto& model_mats = simple_model.getMaterials();
 
+        const auto& levels = simple_model.getLevelsOfDetail();
+        if (!levels.empty()) {
+            lod_levels = &levels;
+        }
+
         for (uint32_t i = 0; i < model_meshes.size(); ++i) {
-            meshes.emplace(model_meshes[i]->getName(), MeshInstance{model_meshes[i], model_mats[i]});
+            const auto [it, inserted] = meshes.emplace(model_meshes[i]->getName(), MeshInstance{model_meshes[i], model_mats[i]});
+            if (!inserted) {
+                continue;
+            }
+
+            for (const auto& level : levels) {
+                it->second.addLevelOfDetail(level.meshes[i]);
+            }
         }
+
+        applyLevelOfDetail();
     } catch (...) {
         throw std::logic_error{"Wrong model for ModelInstance"};
     }
@@ -49,6 +66,16 @@ void ModelInstance::draw(Context& ctx, const Assets& assets, ShaderPass pass, ms
     }
 }
 
+void ModelInstance::enqueue(RenderQueue& queue) {
+    if (hidden) {
+        return;
+    }
+
+    for (auto& [name, mesh] : meshes) {
+        queue.add(*this, mesh, shader_type, final_matrix);
+    }
+}
+
 MeshInstance& ModelInstance::operator[](const std::string& mesh) {
     return meshes.at(mesh);
 }
@@ -58,12 +85,85 @@ ModelInstance* ModelInstance::clone() noexcept {
 }
 
 void ModelInstance::updateBoundingBox() noexcept {
-    bounding_box.center = glm::vec4{position, 1.0f} + glm::vec4{model->getBoundingBox().center, 1.0f} * final_matrix;
-    bounding_box.size = glm::vec4{model->getBoundingBox().size, 1.0f} * final_matrix;
+    // final matrix already contains position, rotation and scale
+    bounding_box = transformBoundingBox(model->getBoundingBox(), final_matrix);
+}
+
+std::optional<TriangleHit> ModelInstance::raycastMesh(const MeshInstance& mesh, const glm::vec3& origin, const glm::vec3& direction, float max_distance) {
+    if (auto* triangle_mesh = dynamic_cast<Mesh*>(mesh.getMesh().get()); triangle_mesh) {
+        return triangle_mesh->getTriangleBVH().raycast(origin, direction, max_distance);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<RayHit> ModelInstance::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) {
+    if (hidden) {
+        return std::nullopt;
+    }
+
+    // ray is moved to model space instead of moving triangles; direction is not normalized, so distances stay the same
+    const auto inverse = glm::inverse(final_matrix);
+    const auto model_origin = glm::vec3{inverse * glm::vec4{origin, 1.0f}};
+    const auto model_direction = glm::vec3{inverse * glm::vec4{direction, 0.0f}};
+
+    std::optional<RayHit> hit;
+    for (const auto& [_, mesh] : meshes) {
+        if (mesh.isHidden()) {
+            continue;
+        }
+
+        if (const auto result = raycastMesh(mesh, model_origin, model_direction, max_distance); result) {
+            max_distance = result->distance;
+            hit = RayHit{this, mesh.getMesh(), result->triangle, result->barycentric, result->distance};
+        }
+    }
+
+    return hit;
+}
+
+void ModelInstance::updateLevelOfDetail(const Camera& camera) noexcept {
+    if (!lod_levels) {
+        return;
+    }
+
+    // fraction of screen height covered by bounding sphere
+    const auto radius = glm::length(bounding_box.size) * 0.5f;
+    const auto distance = glm::distance(bounding_box.center, camera.getPosition());
+    const auto screen_size = distance > radius ? radius * camera.getProjection()[1][1] / distance : std::numeric_limits<float>::max();
+
+    // level changes only after size passes threshold by hysteresis, so instances near it do not pop every frame
+    const auto& levels = *lod_levels;
+    auto level = lod;
+    while (level < levels.size() && screen_size < levels[level].screen_size * (1.0f - LOD_HYSTERESIS)) {
+        ++level;
+    }
+    while (level > 0 && screen_size > levels[level - 1].screen_size * (1.0f + LOD_HYSTERESIS)) {
+        --level;
+    }
+
+    if (level == lod) {
+        return;
+    }
+
+    lod = level;
+    applyLevelOfDetail();
+}
+
+void ModelInstance::applyLevelOfDetail() noexcept {
+    for (auto& [_, mesh] : meshes) {
+        mesh.setLevelOfDetail(lod, lod + shadow_lod_bias);
+    }
+}
+
+void ModelInstance::setShadowLodBias(uint32_t bias) noexcept {
+    shadow_lod_bias = bias;
+    applyLevelOfDetail();
 }
 
-void ModelInstance::update(Context& context, const Camera& camera) {
-	AbstractInstance::update(context, camera);
+void ModelInstance::update(Context& context, const Camera& camera, float dt) {
+	AbstractInstance::update(context, camera, dt);
+	updateLevelOfDetail(camera);
 	//TODO: propagate to inherited classes
 	for (auto& [_, mesh] : meshes) {
 		mesh.update();
@@ -8,40 +8,16 @@
 #include <limitless/core/vertex.hpp>
 #include <limitless/models/mesh.hpp>
 #include <limitless/core/skeletal_stream.hpp>
+#include <limitless/pipeline/render_queue.hpp>
 #include <iostream>
 
 using namespace Limitless;
 
-constexpr auto SKELETAL_BUFFER_NAME = "bone_buffer";
-
-void SkeletalInstance::initializeBuffer() {
-    BufferBuilder builder;
-    bone_buffer = builder.setTarget(Buffer::Type::ShaderStorage)
-            .setUsage(Buffer::Usage::DynamicDraw)
-            .setAccess(Buffer::MutableAccess::WriteOrphaning)
-            .setData(bone_transform.data())
-            .setDataSize(bone_transform.size() * sizeof(glm::mat4))
-            .build();
-}
-
 SkeletalInstance::SkeletalInstance(std::shared_ptr<AbstractModel> m, const glm::vec3& position)
     : ModelInstance(ModelShader::Skeletal, std::move(m), position) {
     auto& skeletal = dynamic_cast<SkeletalModel&>(*model);
 
     bone_transform.resize(skeletal.getBones().size(), glm::mat4(1.0f));
-    initializeBuffer();
-}
-
-const AnimationNode* SkeletalInstance::findAnimationNode(const Bone& bone) const noexcept {
-    if (animation) {
-        for (auto& node : animation->nodes) {
-            if (&node.bone == &bone) {
-                return &node;
-            }
-        }
-    }
-
-    return nullptr;
 }
 
 SkeletalInstance& SkeletalInstance::setPosition(const glm::vec3& position) noexcept {
@@ -60,7 +36,7 @@ SkeletalInstance& SkeletalInstance::setScale(const glm::vec3& scale) noexcept {
 }
 
 SkeletalInstance& SkeletalInstance::setTransformation(const glm::mat4& transformation) {
-	transformation_matrix = transformation;
+	AbstractInstance::setTransformation(transformation);
 	return *this;
 }
 
@@ -69,29 +45,92 @@ void SkeletalInstance::draw(Context& ctx, const Assets& assets, ShaderPass pass,
         return;
     }
 
-	bone_buffer->bindBase(ctx.getIndexedBuffers().getBindingPoint(IndexedBuffer::Type::ShaderStorage, SKELETAL_BUFFER_NAME));
+    uint32_t offset {};
+	getBoneBuffer(offset).bindBase(ctx.getIndexedBuffers().getBindingPoint(IndexedBuffer::Type::ShaderStorage, BONE_BUFFER_NAME));
+
+    auto setter = uniform_setter;
+    setter.add([offset] (ShaderProgram& shader) {
+        shader << UniformValue {BONE_OFFSET_NAME, offset};
+    });
 
     // iterates over all meshes
     for (auto& [name, mesh] : meshes) {
-        mesh.draw(ctx, assets, pass, shader_type, final_matrix, blending, uniform_setter);
+        mesh.draw(ctx, assets, pass, shader_type, final_matrix, blending, setter);
+    }
+}
+
+void SkeletalInstance::enqueue(RenderQueue& queue) {
+    if (hidden) {
+        return;
     }
 
-    bone_buffer->fence();
+    uint32_t offset {};
+    auto& buffer = getBoneBuffer(offset);
+
+    for (auto& [name, mesh] : meshes) {
+        queue.add(*this, mesh, shader_type, final_matrix, &buffer, offset);
+    }
 }
 
-SkeletalInstance& SkeletalInstance::play(const std::string& name) {
+Buffer& SkeletalInstance::getBoneBuffer(uint32_t& offset) {
+    if (bones.storage) {
+        offset = bones.offset;
+        return *bones.storage;
+    }
+
+    offset = 0;
+    if (bones.own_uploaded) {
+        return *bones.own;
+    }
+
+    const auto size = sizeof(glm::mat4) * bone_transform.size();
+    if (!bones.own) {
+        BufferBuilder builder;
+        bones.own = builder.setTarget(Buffer::Type::ShaderStorage)
+                .setUsage(Buffer::Usage::DynamicDraw)
+                .setAccess(Buffer::MutableAccess::WriteOrphaning)
+                .setData(bone_transform.data())
+                .setDataSize(size)
+                .build();
+    } else {
+        bones.own->mapData(bone_transform.data(), size);
+    }
+    bones.own_uploaded = true;
+
+    return *bones.own;
+}
+
+SkeletalInstance::AnimationTrack SkeletalInstance::makeTrack(const std::string& name) const {
     const auto& skeletal = dynamic_cast<SkeletalModel&>(*model);
     const auto& animations = skeletal.getAnimations();
 
     const auto found = std::find_if(animations.begin(), animations.end(), [&] (const auto& anim) { return name == anim.name; });
     if (found == animations.end()) {
         throw std::runtime_error("Animation not found " + name);
-    } else {
-        animation = &(*found);
-        animation_duration = std::chrono::seconds(0);
-        last_time = std::chrono::time_point<std::chrono::steady_clock>();
     }
 
+    AnimationTrack track;
+    track.animation = &(*found);
+    track.cursors.assign(found->nodes.size(), KeyCursor{});
+    return track;
+}
+
+SkeletalInstance& SkeletalInstance::play(const std::string& name) {
+    auto track = makeTrack(name);
+    tracks.clear();
+    tracks.emplace_back(std::move(track));
+    return *this;
+}
+
+SkeletalInstance& SkeletalInstance::crossFade(const std::string& name, float duration) {
+    if (tracks.empty() || duration <= 0.0f) {
+        return play(name);
+    }
+
+    auto track = makeTrack(name);
+    track.weight = 0.0f;
+    track.fade_speed = 1.0f / duration;
+    tracks.emplace_back(std::move(track));
     return *this;
 }
 
@@ -106,75 +145,147 @@ SkeletalInstance& SkeletalInstance::resume() noexcept {
 }
 
 SkeletalInstance& SkeletalInstance::stop() noexcept {
-    animation = nullptr;
+    tracks.clear();
+    layers.clear();
     return *this;
 }
 
-void SkeletalInstance::updateAnimationFrame() {
-	if (!animation || paused) {
-		return;
-	}
+SkeletalInstance& SkeletalInstance::playLayer(size_t layer, const std::string& name, float weight, BoneMask mask, LayerBlending blending) {
+    const auto& skeletal = static_cast<const SkeletalModel&>(*model);
+    if (!mask.empty() && mask.size() != skeletal.getFlatSkeleton().size()) {
+        throw std::invalid_argument("Bone mask does not match skeleton of " + skeletal.getName());
+    }
+
+    auto track = makeTrack(name);
+    track.weight = weight;
+
+    if (layer >= layers.size()) {
+        layers.resize(layer + 1);
+    }
+    layers[layer] = {std::move(track), std::move(mask), blending};
+
+    return *this;
+}
 
-	auto& skeletal = dynamic_cast<SkeletalModel&>(*model);
-	auto& bones = skeletal.getBones();
-	const Animation& anim = *animation;
+SkeletalInstance& SkeletalInstance::setLayerWeight(size_t layer, float weight) {
+    layers.at(layer).track.weight = weight;
+    return *this;
+}
+
+SkeletalInstance& SkeletalInstance::stopLayer(size_t layer) noexcept {
+    if (layer < layers.size()) {
+        layers[layer] = {};
+    }
+    return *this;
+}
 
-	const auto current_time = std::chrono::steady_clock::now();
-	if (last_time == std::chrono::time_point<std::chrono::steady_clock>()) {
-		last_time = current_time;
+void SkeletalInstance::advanceTracks(float dt) noexcept {
+    for (auto& track : tracks) {
+        track.duration += std::chrono::duration<double>(dt);
+        track.weight = std::min(track.weight + track.fade_speed * dt, 1.0f);
+    }
+
+    // tracks under fully faded in one are not visible anymore
+    for (auto i = tracks.size(); i-- > 1; ) {
+        if (tracks[i].weight >= 1.0f) {
+            tracks.erase(tracks.begin(), tracks.begin() + static_cast<std::ptrdiff_t>(i));
+            break;
+        }
+    }
+
+    for (auto& layer : layers) {
+        layer.track.duration += std::chrono::duration<double>(dt);
+    }
+}
+
+void SkeletalInstance::updateAnimationFrame(float dt) {
+	if (tracks.empty() || paused) {
+		return;
 	}
-	const auto delta_time = current_time - last_time;
-	animation_duration += delta_time;
-	last_time = current_time;
-	const auto animation_time = glm::mod(animation_duration.count() * anim.tps, anim.duration);
 
-	std::function<void(const Tree<uint32_t>&, const glm::mat4&)> node_traversal;
-	node_traversal = [&](const Tree<uint32_t>& node, const glm::mat4& parent_mat) {
-		auto anim_node = findAnimationNode(bones[*node]);
+	advanceTracks(dt);
 
-		//TODO: move to ctor
-		auto local_transform = !bones[*node].isFake() ? bones[*node].node_transform : glm::mat4(1.f);
+	const auto& skeletal = static_cast<const SkeletalModel&>(*model);
+	const auto time = [] (const AnimationTrack& track) {
+		return glm::mod(track.duration.count() * track.animation->tps, track.animation->duration);
+	};
 
-		if (anim_node) {
-			glm::vec3 scale = anim_node->scalingLerp(animation_time);
-			glm::vec3 position = anim_node->positionLerp(animation_time);
-			auto rotation = anim_node->rotationLerp(animation_time);
+	const auto blended_layers = std::any_of(layers.begin(), layers.end(), [] (const auto& layer) {
+		return layer.track.animation && layer.track.weight > 0.0f;
+	});
 
-			auto translate = glm::translate(glm::mat4(1.f), position);
-			auto rotate = glm::mat4_cast(rotation);
-			auto scale_mat = glm::scale(glm::mat4(1.f), scale);
+	// single animation is sampled straight to skinning matrices
+	if (tracks.size() == 1 && !blended_layers) {
+		auto& track = tracks.front();
+		skeletal.samplePose(*track.animation, time(track), bone_transform, track.cursors.data());
+		return;
+	}
 
-			local_transform =  translate * rotate * scale_mat;
-		}
+	// poses of one evaluation, reused by all instances animated on this thread
+	thread_local PoseArena arena;
+	const auto size = skeletal.getFlatSkeleton().size();
+	arena.reset(size, 3);
 
-		auto transform = parent_mat * local_transform;
-		bone_transform[*node] = skeletal.getGlobalInverseMatrix() * transform * bones[*node].offset_matrix;
+	const auto pose = arena.allocate();
+	const auto source = arena.allocate();
+	const auto reference = arena.allocate();
 
-		for (const auto& n : node) {
-			node_traversal(n, transform);
+	skeletal.sampleLocalPose(*tracks[0].animation, time(tracks[0]), pose, tracks[0].cursors.data());
+	for (size_t i = 1; i < tracks.size(); ++i) {
+		skeletal.sampleLocalPose(*tracks[i].animation, time(tracks[i]), source, tracks[i].cursors.data());
+		blendPoses(pose, source, tracks[i].weight, nullptr, size);
+	}
+
+	for (auto& layer : layers) {
+		auto& track = layer.track;
+		if (!track.animation || track.weight <= 0.0f) {
+			continue;
 		}
-	};
 
-	try {
-		node_traversal(skeletal.getSkeletonTree(), glm::mat4(1.f));
-	} catch (const std::exception& e) {
-		throw std::runtime_error("Wrong TPS/duration. " + std::string(e.what()));
+		const auto* mask = layer.mask.empty() ? nullptr : layer.mask.data();
+		skeletal.sampleLocalPose(*track.animation, time(track), source, track.cursors.data());
+
+		switch (layer.blending) {
+			case LayerBlending::Override:
+				blendPoses(pose, source, track.weight, mask, size);
+				break;
+			case LayerBlending::Additive:
+				skeletal.sampleLocalPose(*track.animation, 0.0, reference);
+				addPoses(pose, source, reference, track.weight, mask, size);
+				break;
+		}
 	}
 
-	bone_buffer->mapData(bone_transform.data(), sizeof(glm::mat4) * bone_transform.size());
+	skeletal.applyPose(pose, bone_transform);
 }
 
-void SkeletalInstance::updateAttachments(Context& context, const Camera& camera) {
+void SkeletalInstance::animate(float dt) {
+	updateAnimationFrame(dt);
+
+	// sockets are set before transforms are propagated to attachments
+	SocketAttachment::update();
 	SocketAttachment::setTransformation();
-	AbstractInstance::updateAttachments(context, camera);
+
+	animated = true;
 }
 
-void SkeletalInstance::update(Context& context, const Camera& camera) {
-	updateAnimationFrame();
+void SkeletalInstance::update(Context& context, const Camera& camera, float dt) {
+	if (!animated) {
+		animate(dt);
+	}
+	animated = false;
 
-	SocketAttachment::update();
+	// slot of previous frame may be reused, so transforms go to own storage until written again
+	bones.storage.reset();
+	bones.own_uploaded = false;
+
+    ModelInstance::update(context, camera, dt);
+}
 
-    ModelInstance::update(context, camera);
+void SkeletalInstance::writeBones(glm::mat4* palette, const std::shared_ptr<Buffer>& storage, uint32_t offset) noexcept {
+    std::copy(bone_transform.begin(), bone_transform.end(), palette + offset);
+    bones.storage = storage;
+    bones.offset = offset;
 }
 
 SkeletalInstance* SkeletalInstance::clone() noexcept {
@@ -188,16 +299,82 @@ void SkeletalInstance::updateBoundingBox() noexcept {
 glm::vec3 SkeletalInstance::getSkinnedVertexPosition(const std::shared_ptr<AbstractMesh>& mesh, size_t vertex_index) const {
     const auto& skinned_mesh = dynamic_cast<SkinnedVertexStream<VertexNormalTangent>&>(dynamic_cast<Mesh&>(*mesh).getVertexStream());
 
-    const auto& bone_weight = skinned_mesh.getBoneWeights().at(vertex_index);
-    const auto& vertex = skinned_mesh.getVertices().at(vertex_index);
+    return skinVertex(skinned_mesh.getBoneWeights().at(vertex_index), skinned_mesh.getVertices().at(vertex_index).position);
+}
 
+glm::vec3 SkeletalInstance::skinVertex(const VertexBoneWeight& bone_weight, const glm::vec3& position) const noexcept {
     auto transform = bone_transform[bone_weight.bone_index[0]] * bone_weight.weight[0];
     transform     += bone_transform[bone_weight.bone_index[1]] * bone_weight.weight[1];
     transform     += bone_transform[bone_weight.bone_index[2]] * bone_weight.weight[2];
     transform     += bone_transform[bone_weight.bone_index[3]] * bone_weight.weight[3];
 
-    auto matrix = final_matrix;
-    matrix *= transform;
+    return final_matrix * (transform * glm::vec4(position, 1.0f));
+}
+
+void SkeletalInstance::getSkinnedVertexPositions(const SkinnedVertexStream<VertexNormalTangent>& stream, const uint32_t* indices, size_t count, glm::vec3* positions) const noexcept {
+    const auto* bone_weights = stream.getBoneWeights().data();
+    const auto* vertices = stream.getVertices().data();
+
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = skinVertex(bone_weights[indices[i]], vertices[indices[i]].position);
+    }
+}
+
+void SkeletalInstance::getSkinnedVertexPositions(const SkinnedVertexStream<VertexNormalTangent>& stream, glm::vec3* positions) const noexcept {
+    const auto& bone_weights = stream.getBoneWeights();
+    const auto& vertices = stream.getVertices();
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        positions[i] = skinVertex(bone_weights[i], vertices[i].position);
+    }
+}
+
+std::optional<RayHit> SkeletalInstance::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) {
+    if (hidden) {
+        return std::nullopt;
+    }
+
+    std::optional<RayHit> hit;
+
+    for (const auto& [_, mesh] : meshes) {
+        if (mesh.isHidden()) {
+            continue;
+        }
+
+        auto* triangle_mesh = dynamic_cast<Mesh*>(mesh.getMesh().get());
+        if (!triangle_mesh) {
+            continue;
+        }
+
+        std::optional<TriangleHit> result;
+
+        if (const auto* skinned = dynamic_cast<const SkinnedVertexStream<VertexNormalTangent>*>(&triangle_mesh->getVertexStream()); skinned) {
+            // pose changes every frame, so every vertex is skinned to world space once and triangles are tested one by one
+            skinned_positions.resize(skinned->getVertices().size());
+            getSkinnedVertexPositions(*skinned, skinned_positions.data());
+
+            const auto& indices = skinned->getIndices();
+            for (uint32_t i = 0; i + 2 < indices.size(); i += 3) {
+                const auto& a = skinned_positions[indices[i]];
+                const auto& b = skinned_positions[indices[i + 1]];
+                const auto& c = skinned_positions[indices[i + 2]];
+
+                if (auto triangle = intersectTriangle(origin, direction, a, b, c, max_distance); triangle) {
+                    triangle->triangle = i / 3;
+                    max_distance = triangle->distance;
+                    result = triangle;
+                }
+            }
+        } else {
+            const auto inverse = glm::inverse(final_matrix);
+            result = raycastMesh(mesh, inverse * glm::vec4{origin, 1.0f}, inverse * glm::vec4{direction, 0.0f}, max_distance);
+        }
+
+        if (result) {
+            max_distance = result->distance;
+            hit = RayHit{this, mesh.getMesh(), result->triangle, result->barycentric, result->distance};
+        }
+    }
 
-    return matrix * glm::vec4(vertex.position, 1.0);
+    return hit;
 }
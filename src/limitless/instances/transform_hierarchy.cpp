@@ -0,0 +1,71 @@
+#include <limitless/instances/transform_hierarchy.hpp>
+#include <limitless/instances/abstract_instance.hpp>
+#include <limitless/util/thread_pool.hpp>
+
+using namespace Limitless;
+
+void TransformHierarchy::build(const std::vector<AbstractInstance*>& roots) {
+    nodes.clear();
+    levels.clear();
+
+    for (auto* root : roots) {
+        nodes.push_back({root, NO_PARENT});
+    }
+
+    // breadth first, so each level follows previous one
+    levels.push_back(0);
+    for (size_t begin = 0, end = nodes.size(); begin != end; begin = end, end = nodes.size()) {
+        levels.push_back(end);
+
+        for (auto i = begin; i < end; ++i) {
+            for (const auto& [_, attachment] : nodes[i].instance->getAttachments()) {
+                nodes.push_back({attachment.get(), static_cast<uint32_t>(i)});
+            }
+        }
+    }
+
+    // only attachments of this hierarchy make it outdated
+    for (auto& node : nodes) {
+        node.instance->setStructureVersion(&structure_version);
+    }
+
+    changed.assign(nodes.size(), 0);
+    version = structure_version;
+    valid = true;
+    propagate_all = true;
+}
+
+bool TransformHierarchy::isOutdated() const noexcept {
+    return !valid || version != structure_version;
+}
+
+void TransformHierarchy::updateNode(size_t index) noexcept {
+    const auto& node = nodes[index];
+
+    // clean subtrees only check flags
+    if (node.parent != NO_PARENT && (propagate_all || changed[node.parent])) {
+        node.instance->setParent(nodes[node.parent].instance->getFinalMatrix());
+    }
+
+    changed[index] = node.instance->updateTransform();
+}
+
+void TransformHierarchy::update(ThreadPool* pool) {
+    for (size_t level = 0; level + 1 < levels.size(); ++level) {
+        const auto begin = levels[level];
+        const auto count = levels[level + 1] - begin;
+
+        // nodes of one level depend only on previous levels
+        if (pool && count >= PARALLEL_THRESHOLD) {
+            pool->forEach(count, PARALLEL_CHUNK, [&] (size_t i) {
+                updateNode(begin + i);
+            });
+        } else {
+            for (auto i = begin; i < begin + count; ++i) {
+                updateNode(i);
+            }
+        }
+    }
+
+    propagate_all = false;
+}
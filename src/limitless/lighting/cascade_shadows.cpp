@@ -15,6 +15,7 @@
 #include <limitless/scene.hpp>
 
 #include <limitless/fx/effect_renderer.hpp>
+#include <limitless/util/frustum.hpp>
 
 using namespace Limitless;
 
@@ -183,7 +184,7 @@ void CascadeShadows::updateLightMatrices(const DirectionalLight& light) {
     }
 }
 
-void CascadeShadows::draw(Instances& instances,
+void CascadeShadows::draw(const Scene& scene,
                           const DirectionalLight& light,
                           Context& ctx, const
                           Assets& assets,
@@ -207,7 +208,11 @@ void CascadeShadows::draw(Instances& instances,
             shader << UniformValue{"light_space", frustums[i].crop};
         };
 
-        for (const auto& instance : instances) {
+        // light space volume of cascade, including casters in front of it
+        casters.clear();
+        scene.query(Frustum{frustums[i].crop}, casters);
+
+        for (const auto& instance : casters) {
             if (!instance.get().doesCastShadow()) {
                 continue;
             }
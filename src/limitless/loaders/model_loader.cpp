@@ -16,12 +16,7 @@
 
 using namespace Limitless;
 
-std::shared_ptr<AbstractModel> ModelLoader::loadModel(Assets& assets, const fs::path& _path, const ModelLoaderFlags& flags) {
-    const auto path = convertPathSeparators(_path);
-
-    Assimp::Importer importer;
-    const aiScene* scene;
-
+const aiScene* ModelLoader::readScene(Assimp::Importer& importer, const fs::path& path, const ModelLoaderFlags& flags) {
     auto scene_flags = aiProcess_ValidateDataStructure |
                        aiProcess_Triangulate |
                        aiProcess_GenUVCoords |
@@ -44,13 +39,22 @@ std::shared_ptr<AbstractModel> ModelLoader::loadModel(Assets& assets, const fs::
         scene_flags |= aiProcess_FlipWindingOrder;
     }
 
-    scene = importer.ReadFile(path.string().c_str(), scene_flags);
+    const auto* scene = importer.ReadFile(path.string().c_str(), scene_flags);
 
     if (!scene || /*scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||*/ !scene->mRootNode) 
     {
         throw model_loader_error(importer.GetErrorString());
     }
 
+    return scene;
+}
+
+std::shared_ptr<AbstractModel> ModelLoader::loadModel(Assets& assets, const fs::path& _path, const ModelLoaderFlags& flags) {
+    const auto path = convertPathSeparators(_path);
+
+    Assimp::Importer importer;
+    const aiScene* scene = readScene(importer, path, flags);
+
     std::unordered_map<std::string, uint32_t> bone_map;
     std::vector<Bone> bones;
 
@@ -61,7 +65,7 @@ std::shared_ptr<AbstractModel> ModelLoader::loadModel(Assets& assets, const fs::
         materials = loadMaterials(assets, scene, path, bone_map.empty() ? ModelShader::Model : ModelShader::Skeletal);
     }
 
-    auto animations = loadAnimations(scene, bones, bone_map);
+    auto animations = loadAnimations(scene, bones, bone_map, flags);
 
     auto animation_tree = loadAnimationTree(scene, bones, bone_map);
 
@@ -73,9 +77,52 @@ std::shared_ptr<AbstractModel> ModelLoader::loadModel(Assets& assets, const fs::
         std::shared_ptr<AbstractModel>(new Model(std::move(meshes), std::move(materials), path.stem().string())) :
         std::shared_ptr<AbstractModel>(new SkeletalModel(std::move(meshes), std::move(materials), std::move(bones), std::move(bone_map), std::move(animation_tree), std::move(animations), glm::inverse(global_matrix), path.stem().string()));
 
+    loadLevelsOfDetail(assets, static_cast<Model&>(*model), path, flags);
+
     return model;
 }
 
+fs::path ModelLoader::getLevelOfDetailPath(const fs::path& path, uint32_t level) {
+    return path.parent_path() / (path.stem().string() + "_lod" + std::to_string(level) + path.extension().string());
+}
+
+void ModelLoader::checkLevelOfDetail(const aiScene* scene, size_t mesh_count, size_t bone_count, const std::unordered_map<std::string, uint32_t>& level_bone_map) {
+    if (scene->mNumMeshes != mesh_count) {
+        throw model_loader_error("Level of detail has different mesh count than model");
+    }
+
+    // skeleton of model is already flattened, so level can not add bones to it
+    if (level_bone_map.size() != bone_count) {
+        throw model_loader_error("Level of detail has bones that model does not have");
+    }
+}
+
+void ModelLoader::loadLevelsOfDetail(Assets& assets, Model& model, const fs::path& path, const ModelLoaderFlags& flags) {
+    // skinned levels reuse bone indices of model by bone names, resolved against copies of its bones
+    const auto* skeletal = dynamic_cast<const SkeletalModel*>(&model);
+    const auto bone_count = skeletal ? skeletal->getBoneMap().size() : 0;
+
+    auto screen_size = flags.lod_screen_size;
+    for (uint32_t level = 1; ; ++level) {
+        const auto level_path = getLevelOfDetailPath(path, level);
+        if (!fs::exists(level_path)) {
+            break;
+        }
+
+        Assimp::Importer importer;
+        const aiScene* scene = readScene(importer, level_path, flags);
+
+        auto bone_map = skeletal ? skeletal->getBoneMap() : std::unordered_map<std::string, uint32_t>{};
+        auto bones = skeletal ? skeletal->getBones() : std::vector<Bone>{};
+
+        auto meshes = loadMeshes(assets, scene, level_path, bones, bone_map, flags);
+        checkLevelOfDetail(scene, model.getMeshes().size(), bone_count, bone_map);
+
+        model.addLevelOfDetail({std::move(meshes), screen_size});
+        screen_size *= 0.5f;
+    }
+}
+
 template<typename T>
 std::vector<T> ModelLoader::loadVertices(aiMesh* mesh) {
     std::vector<T> vertices;
@@ -315,7 +362,7 @@ std::vector<std::shared_ptr<ms::Material>> ModelLoader::loadMaterials(Assets& as
     return materials;
 }
 
-std::vector<Animation> ModelLoader::loadAnimations(const aiScene* scene, std::vector<Bone>& bones, std::unordered_map<std::string, uint32_t>& bone_map) {
+std::vector<Animation> ModelLoader::loadAnimations(const aiScene* scene, std::vector<Bone>& bones, std::unordered_map<std::string, uint32_t>& bone_map, const ModelLoaderFlags& flags) {
     std::vector<Animation> animations;
 
     for (uint32_t i = 0; i < scene->mNumAnimations; ++i) {
@@ -333,7 +380,7 @@ std::vector<Animation> ModelLoader::loadAnimations(const aiScene* scene, std::ve
                 bone_map.emplace(channel->mNodeName.C_Str(), bones.size() - 1);
             }
 
-            auto& bone = bones.at(bone_map.at(channel->mNodeName.C_Str()));
+            const auto bone = bone_map.at(channel->mNodeName.C_Str());
             std::vector<KeyFrame<glm::vec3>> pos_frames;
             std::vector<KeyFrame<glm::fquat>> rot_frames;
             std::vector<KeyFrame<glm::vec3>> scale_frames;
@@ -353,7 +400,7 @@ std::vector<Animation> ModelLoader::loadAnimations(const aiScene* scene, std::ve
                 scale_frames.emplace_back(vec, channel->mScalingKeys[k].mTime);
             }
 
-            anim_nodes.emplace_back(pos_frames, rot_frames, scale_frames, bone);
+            anim_nodes.emplace_back(pos_frames, rot_frames, scale_frames, bone, flags.animation_tolerance);
         }
 
         animations.emplace_back(anim_name, anim->mDuration, anim->mTicksPerSecond > 0 ? anim->mTicksPerSecond : 25, anim_nodes);
@@ -451,7 +498,7 @@ void ModelLoader::addAnimations(const fs::path& _path, const std::shared_ptr<Abs
     auto& bones = model.getBones();
     auto& animations = model.getAnimations();
 
-    auto loaded = loadAnimations(scene, bones, bone_map);
+    auto loaded = loadAnimations(scene, bones, bone_map, flags);
 
     if (loaded.empty()) {
         throw model_loader_error{"Animations are empty!"};
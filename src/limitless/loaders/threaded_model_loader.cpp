@@ -98,16 +98,45 @@ std::function<std::shared_ptr<AbstractModel>()> ThreadedModelLoader::loadModel(A
         materials = loadMaterials(assets, scene, path, bone_map.empty() ? ModelShader::Model : ModelShader::Skeletal);
     }
 
-    auto animations = loadAnimations(scene, bones, bone_map);
+    auto animations = loadAnimations(scene, bones, bone_map, flags);
     auto animation_tree = loadAnimationTree(scene, bones, bone_map);
     auto global_matrix = convert(scene->mRootNode->mTransformation);
+    const auto mesh_count = scene->mNumMeshes;
 
     importer.FreeScene();
 
-    return [meshes = std::move(meshes), materials = std::move(materials), bones = std::move(bones), bone_map = std::move(bone_map), animations = std::move(animations), animation_tree = std::move(animation_tree), global_matrix, name = path.stem().string()] () mutable {
-        return bone_map.empty() ?
+    // levels of detail are read here too, their meshes are created with model meshes
+    std::vector<std::pair<std::function<std::vector<std::shared_ptr<AbstractMesh>>()>, float>> levels;
+    auto screen_size = flags.lod_screen_size;
+    for (uint32_t level = 1; ; ++level) {
+        const auto level_path = getLevelOfDetailPath(path, level);
+        if (!fs::exists(level_path)) {
+            break;
+        }
+
+        Assimp::Importer level_importer;
+        const aiScene* level_scene = readScene(level_importer, level_path, flags);
+
+        auto level_bone_map = bone_map;
+        auto level_bones = bones;
+
+        auto level_meshes = loadMeshes(assets, level_scene, level_path, level_bones, level_bone_map, flags);
+        checkLevelOfDetail(level_scene, mesh_count, bone_map.size(), level_bone_map);
+
+        levels.emplace_back(std::move(level_meshes), screen_size);
+        screen_size *= 0.5f;
+    }
+
+    return [meshes = std::move(meshes), materials = std::move(materials), bones = std::move(bones), bone_map = std::move(bone_map), animations = std::move(animations), animation_tree = std::move(animation_tree), global_matrix, levels = std::move(levels), name = path.stem().string()] () mutable {
+        auto model = bone_map.empty() ?
                std::shared_ptr<AbstractModel>(new Model(meshes(), std::move(materials), name)) :
                std::shared_ptr<AbstractModel>(new SkeletalModel(meshes(), std::move(materials), std::move(bones), std::move(bone_map), std::move(animation_tree), std::move(animations), glm::inverse(global_matrix), name));
+
+        for (auto& [level_meshes, level_screen_size] : levels) {
+            static_cast<Model&>(*model).addLevelOfDetail({level_meshes(), level_screen_size});
+        }
+
+        return model;
     };
 }
 
@@ -26,7 +26,7 @@ Cylinder::Cylinder() : ElementaryModel("cylinder") {
             "cylinder")
     );
 
-//    calculateBoundingBox();
+    calculateBoundingBox();
 }
 
 Cylinder::Cylinder(float base_radius, float top_radius, float height)
@@ -52,7 +52,7 @@ Cylinder::Cylinder(float base_radius, float top_radius, float height)
                     "cylinder")
     );
 
-//    calculateBoundingBox();
+    calculateBoundingBox();
 }
 
 std::vector<glm::vec3> Cylinder::generateNormals() const {
@@ -0,0 +1,37 @@
+#include <limitless/models/mesh.hpp>
+
+#include <limitless/core/indexed_stream.hpp>
+#include <limitless/core/vertex.hpp>
+
+#include <numeric>
+
+using namespace Limitless;
+
+const TriangleBVH& Mesh::getTriangleBVH() {
+    if (triangle_bvh) {
+        return *triangle_bvh;
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+
+    if (auto* vertex_stream = dynamic_cast<VertexStream<VertexNormalTangent>*>(stream.get()); vertex_stream && vertex_stream->getDrawMode() == VertexStreamDraw::Triangles) {
+        const auto& vertices = vertex_stream->getVertices();
+
+        positions.reserve(vertices.size());
+        for (const auto& vertex : vertices) {
+            positions.emplace_back(vertex.position);
+        }
+
+        if (auto* indexed = dynamic_cast<IndexedVertexStream<VertexNormalTangent>*>(vertex_stream); indexed) {
+            indices = indexed->getIndices();
+        } else {
+            indices.resize(vertices.size());
+            std::iota(indices.begin(), indices.end(), 0);
+        }
+    }
+
+    triangle_bvh = std::make_unique<TriangleBVH>(positions, indices);
+
+    return *triangle_bvh;
+}
@@ -1,8 +1,22 @@
 #include <limitless/models/model.hpp>
 
+#include <stdexcept>
+
 using namespace Limitless;
 
 Model::Model(decltype(meshes)&& _meshes, decltype(materials)&& _materials, std::string name)
     : AbstractModel(std::move(_meshes), std::move(name))
     , materials(std::move(_materials)) {
 }
+
+void Model::addLevelOfDetail(LevelOfDetail level) {
+    if (level.meshes.size() != meshes.size()) {
+        throw std::invalid_argument("Level of detail of " + name + " has different mesh count");
+    }
+
+    if (!levels.empty() && level.screen_size >= levels.back().screen_size) {
+        throw std::invalid_argument("Level of detail of " + name + " should have smaller screen size than previous one");
+    }
+
+    levels.emplace_back(std::move(level));
+}
@@ -0,0 +1,63 @@
+#include <limitless/models/pose.hpp>
+#include <stdexcept>
+
+using namespace Limitless;
+
+void PoseArena::reset(size_t _pose_size, size_t count) {
+    pose_size = _pose_size;
+    used = 0;
+
+    // storage only grows
+    if (pose_size * count > positions.size()) {
+        positions.resize(pose_size * count);
+        rotations.resize(pose_size * count);
+        scales.resize(pose_size * count);
+    }
+
+    capacity = pose_size ? positions.size() / pose_size : 0;
+}
+
+Pose PoseArena::allocate() {
+    if (used == capacity) {
+        throw std::out_of_range("PoseArena is exhausted");
+    }
+
+    const auto offset = used++ * pose_size;
+    return {positions.data() + offset, rotations.data() + offset, scales.data() + offset};
+}
+
+namespace {
+    // normalized lerp along shortest path
+    glm::fquat nlerp(const glm::fquat& a, const glm::fquat& b, float weight) noexcept {
+        const auto b_weight = glm::dot(a, b) < 0.0f ? -weight : weight;
+        return glm::normalize(a * (1.0f - weight) + b * b_weight);
+    }
+}
+
+void Limitless::blendPoses(Pose target, Pose source, float weight, const float* mask, size_t size) noexcept {
+    for (size_t i = 0; i < size; ++i) {
+        const auto w = mask ? weight * mask[i] : weight;
+        if (w <= 0.0f) {
+            continue;
+        }
+
+        target.positions[i] = target.positions[i] * (1.0f - w) + source.positions[i] * w;
+        target.rotations[i] = nlerp(target.rotations[i], source.rotations[i], w);
+        target.scales[i] = target.scales[i] * (1.0f - w) + source.scales[i] * w;
+    }
+}
+
+void Limitless::addPoses(Pose target, Pose additive, Pose reference, float weight, const float* mask, size_t size) noexcept {
+    static const glm::fquat identity {1.0f, 0.0f, 0.0f, 0.0f};
+
+    for (size_t i = 0; i < size; ++i) {
+        const auto w = mask ? weight * mask[i] : weight;
+        if (w <= 0.0f) {
+            continue;
+        }
+
+        target.positions[i] += (additive.positions[i] - reference.positions[i]) * w;
+        target.rotations[i] = glm::normalize(target.rotations[i] * nlerp(identity, glm::inverse(reference.rotations[i]) * additive.rotations[i], w));
+        target.scales[i] *= glm::vec3{1.0f - w} + additive.scales[i] / reference.scales[i] * w;
+    }
+}
@@ -1,110 +1,289 @@
 #include <limitless/models/skeletal_model.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 using namespace Limitless;
 
-AnimationNode::AnimationNode(decltype(positions) _positions, decltype(rotations) _rotations, decltype(scales) _scales, Bone& _bone) noexcept
-    : rotations(std::move(_rotations))
-    , positions(std::move(_positions))
-    , scales(std::move(_scales))
-    , bone(_bone) {
+namespace {
+    constexpr float QUAT_COMPONENT_MAX = 0.70710678f;
+    constexpr float QUAT_STEPS = 32767.0f;
+    constexpr float RANGE_STEPS = 65535.0f;
+
+    glm::vec3 interpolate(const glm::vec3& a, const glm::vec3& b, float factor) noexcept {
+        return a * (1.0f - factor) + b * factor;
+    }
+
+    glm::fquat interpolate(const glm::fquat& a, const glm::fquat& b, float factor) noexcept {
+        return glm::normalize(glm::slerp(a, b, factor));
+    }
+
+    // largest difference of components
+    float difference(const glm::vec3& a, const glm::vec3& b) noexcept {
+        const auto d = glm::abs(a - b);
+        return glm::max(d.x, glm::max(d.y, d.z));
+    }
+
+    // q and -q are the same rotation
+    float difference(const glm::fquat& a, const glm::fquat& b) noexcept {
+        const auto sign = glm::dot(a, b) < 0.0f ? -1.0f : 1.0f;
+        float result {};
+        for (glm::length_t i = 0; i < 4; ++i) {
+            result = glm::max(result, glm::abs(a[i] - b[i] * sign));
+        }
+        return result;
+    }
+
+    // indices of keys that are needed to reproduce track within tolerance, greedy from the first key
+    template<typename T>
+    std::vector<size_t> reduceKeys(const std::vector<KeyFrame<T>>& frames, float tolerance) {
+        std::vector<size_t> kept {0};
+
+        const auto fits = [&] (size_t from, size_t to) {
+            const auto span = frames[to].time - frames[from].time;
+            for (auto i = from + 1; i < to; ++i) {
+                const auto factor = span > 0.0 ? static_cast<float>((frames[i].time - frames[from].time) / span) : 0.0f;
+                if (difference(interpolate(frames[from].data, frames[to].data, factor), frames[i].data) > tolerance) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        size_t anchor = 0;
+        for (size_t end = 2; end < frames.size(); ++end) {
+            if (!fits(anchor, end)) {
+                anchor = end - 1;
+                kept.push_back(anchor);
+            }
+        }
+
+        // constant track is sampled as its only key
+        if (frames.size() > 1 && (kept.size() > 1 || difference(frames.front().data, frames.back().data) > tolerance)) {
+            kept.push_back(frames.size() - 1);
+        }
+
+        return kept;
+    }
+
+    PackedKey pack(const glm::fquat& rotation) noexcept {
+        glm::length_t largest = 0;
+        for (glm::length_t i = 1; i < 4; ++i) {
+            if (glm::abs(rotation[i]) > glm::abs(rotation[largest])) {
+                largest = i;
+            }
+        }
+
+        // largest component is restored as positive
+        const auto sign = rotation[largest] < 0.0f ? -1.0f : 1.0f;
+
+        PackedKey key {};
+        for (glm::length_t i = 0, j = 0; i < 4; ++i) {
+            if (i == largest) {
+                continue;
+            }
+
+            const auto normalized = glm::clamp(rotation[i] * sign / QUAT_COMPONENT_MAX * 0.5f + 0.5f, 0.0f, 1.0f);
+            key[j++] = static_cast<uint16_t>(static_cast<uint16_t>(std::lround(normalized * QUAT_STEPS)) << 1u);
+        }
+
+        key[0] |= static_cast<uint16_t>(largest & 1);
+        key[1] |= static_cast<uint16_t>(largest >> 1);
+        return key;
+    }
+
+    glm::fquat unpack(const PackedKey& key) noexcept {
+        const auto largest = static_cast<glm::length_t>((key[0] & 1u) | ((key[1] & 1u) << 1u));
+
+        glm::fquat rotation;
+        float sum {};
+        for (glm::length_t i = 0, j = 0; i < 4; ++i) {
+            if (i == largest) {
+                continue;
+            }
+
+            const auto component = (static_cast<float>(key[j++] >> 1u) / QUAT_STEPS * 2.0f - 1.0f) * QUAT_COMPONENT_MAX;
+            rotation[i] = component;
+            sum += component * component;
+        }
+        rotation[largest] = std::sqrt(glm::max(0.0f, 1.0f - sum));
+
+        return rotation;
+    }
 }
 
-size_t AnimationNode::findPositionKeyframe(double anim_time) const {
-    for (size_t i = 0; i < positions.size() - 1; ++i) {
-        if (anim_time <= positions[i + 1].time) {
-            return i;
+template<typename T>
+KeyTrack<T>::KeyTrack(const std::vector<KeyFrame<T>>& frames, float tolerance) {
+    if (frames.empty()) {
+        return;
+    }
+
+    const auto kept = reduceKeys(frames, tolerance);
+    times.reserve(kept.size());
+    keys.reserve(kept.size());
+
+    if constexpr (std::is_same_v<T, glm::fquat>) {
+        for (const auto index : kept) {
+            times.emplace_back(static_cast<float>(frames[index].time));
+            keys.emplace_back(pack(glm::normalize(frames[index].data)));
         }
+    } else {
+        auto max = frames[kept.front()].data;
+        min = max;
+        for (const auto index : kept) {
+            min = glm::min(min, frames[index].data);
+            max = glm::max(max, frames[index].data);
+        }
+        extent = max - min;
+
+        for (const auto index : kept) {
+            const auto normalized = glm::vec3 {
+                extent.x > 0.0f ? (frames[index].data.x - min.x) / extent.x : 0.0f,
+                extent.y > 0.0f ? (frames[index].data.y - min.y) / extent.y : 0.0f,
+                extent.z > 0.0f ? (frames[index].data.z - min.z) / extent.z : 0.0f
+            };
+
+            times.emplace_back(static_cast<float>(frames[index].time));
+            keys.push_back({
+                static_cast<uint16_t>(std::lround(normalized.x * RANGE_STEPS)),
+                static_cast<uint16_t>(std::lround(normalized.y * RANGE_STEPS)),
+                static_cast<uint16_t>(std::lround(normalized.z * RANGE_STEPS))
+            });
+        }
+    }
+}
+
+template<typename T>
+T KeyTrack<T>::value(size_t index) const noexcept {
+    const auto& key = keys[index];
+
+    if constexpr (std::is_same_v<T, glm::fquat>) {
+        return unpack(key);
+    } else {
+        return min + glm::vec3{key[0], key[1], key[2]} / RANGE_STEPS * extent;
     }
-    return 0;
-    throw std::out_of_range("no position keyframe for time " + std::to_string(anim_time));
 }
 
-size_t AnimationNode::findRotationKeyframe(double anim_time) const {
-    for (size_t i = 0; i < rotations.size() - 1; ++i) {
-        if (anim_time <= rotations[i + 1].time)
-            return i;
+template<typename T>
+size_t KeyTrack<T>::find(float time, uint32_t& cursor) const noexcept {
+    // keys that playback passes in one sample before binary search is cheaper
+    static constexpr uint32_t CURSOR_STEPS = 4;
+
+    const size_t last = times.size() - 2;
+    size_t index = std::min<size_t>(cursor, last);
+
+    if (time >= times[index]) {
+        for (uint32_t step = 0; step < CURSOR_STEPS; ++step) {
+            if (index == last || time < times[index + 1]) {
+                cursor = static_cast<uint32_t>(index);
+                return index;
+            }
+            ++index;
+        }
     }
-	return 0;
-    throw std::out_of_range("no rotation keyframe for time " + std::to_string(anim_time));
+
+    // first key after time among inner keys, so index stays in [0, last]
+    const auto next = std::upper_bound(times.begin() + 1, times.end() - 1, time);
+    index = static_cast<size_t>(next - times.begin()) - 1;
+
+    cursor = static_cast<uint32_t>(index);
+    return index;
 }
 
-size_t AnimationNode::findScalingKeyframe(double anim_time) const {
-    for (size_t i = 0; i < scales.size() - 1; ++i) {
-        if (anim_time <= scales[i + 1].time)
-            return i;
+template struct Limitless::KeyTrack<glm::vec3>;
+template struct Limitless::KeyTrack<glm::fquat>;
+
+namespace {
+    // position of time between keys index and index + 1
+    template<typename T>
+    float segmentFactor(const KeyTrack<T>& track, size_t index, float time) noexcept {
+        const auto dt = track.times[index + 1] - track.times[index];
+        return dt > 0.0f ? glm::clamp((time - track.times[index]) / dt, 0.0f, 1.0f) : 0.0f;
     }
-    return 0;
-    throw std::out_of_range("no scaling keyframe for time " + std::to_string(anim_time));
 }
 
-glm::vec3 AnimationNode::positionLerp(double anim_time) const {
+AnimationNode::AnimationNode(const std::vector<KeyFrame<glm::vec3>>& _positions, const std::vector<KeyFrame<glm::fquat>>& _rotations, const std::vector<KeyFrame<glm::vec3>>& _scales, uint32_t _bone, float tolerance)
+    : rotations(_rotations, tolerance)
+    , positions(_positions, tolerance)
+    , scales(_scales, tolerance)
+    , bone(_bone) {
+}
+
+AnimationNode::AnimationNode(KeyTrack<glm::vec3> _positions, KeyTrack<glm::fquat> _rotations, KeyTrack<glm::vec3> _scales, uint32_t _bone) noexcept
+    : rotations(std::move(_rotations))
+    , positions(std::move(_positions))
+    , scales(std::move(_scales))
+    , bone(_bone) {
+}
+
+glm::vec3 AnimationNode::positionLerp(float anim_time, uint32_t& cursor) const noexcept {
     if (positions.empty()) {
         return glm::vec3{0.0f};
     }
 
     if (positions.size() == 1) {
-        return positions[0].data;
+        return positions.value(0);
     }
 
-    auto index = findPositionKeyframe(anim_time);
-    auto& a = positions[index];
-    auto& b = positions[index + 1];
-
-    double dt = b.time - a.time;
-    double norm = (anim_time - a.time) / dt;
-
-//    if (!(norm >= 0.f && norm <= 1.f)) {
-//        throw std::runtime_error("norm >= 0.f && norm <= 1.f");
-//    }
-
-//    return glm::mix(a.data, b.data, norm);
-    return a.data * (float)(1.0 - norm) + b.data * (float)norm;
+    const auto index = positions.find(anim_time, cursor);
+    const auto factor = segmentFactor(positions, index, anim_time);
+    return positions.value(index) * (1.0f - factor) + positions.value(index + 1) * factor;
 }
 
-glm::fquat AnimationNode::rotationLerp(double anim_time) const {
+glm::fquat AnimationNode::rotationLerp(float anim_time, uint32_t& cursor) const noexcept {
     if (rotations.empty()) {
         return glm::fquat{1.f, 0.f, 0.f, 0.f};
     }
+
     if (rotations.size() == 1) {
-        return rotations[0].data;
+        return rotations.value(0);
     }
 
-    auto index = findRotationKeyframe(anim_time);
-    auto& a = rotations[index];
-    auto& b = rotations[index + 1];
-
-    double dt = b.time - a.time;
-    double norm = (anim_time - a.time) / dt;
-
-//    if (!(norm >= 0.f && norm <= 1.f)) {
-//        throw std::runtime_error("norm >= 0.f && norm <= 1.f");
-//    }
-
-    return glm::normalize(glm::slerp(a.data, b.data, static_cast<float>(norm)));
+    const auto index = rotations.find(anim_time, cursor);
+    return glm::normalize(glm::slerp(rotations.value(index), rotations.value(index + 1), segmentFactor(rotations, index, anim_time)));
 }
 
-glm::vec3 AnimationNode::scalingLerp(double anim_time) const {
+glm::vec3 AnimationNode::scalingLerp(float anim_time, uint32_t& cursor) const noexcept {
     if (scales.empty()) {
         return glm::vec3{1.f};
     }
 
     if (scales.size() == 1) {
-        return scales[0].data;
+        return scales.value(0);
     }
 
-    auto index = findScalingKeyframe(anim_time);
-    auto a = scales[index];
-    auto b = scales[index + 1];
+    const auto index = scales.find(anim_time, cursor);
+    const auto factor = segmentFactor(scales, index, anim_time);
+    return scales.value(index) * (1.0f - factor) + scales.value(index + 1) * factor;
+}
 
-    double dt = b.time - a.time;
-    double norm = (anim_time - a.time) / dt;
+glm::vec3 AnimationNode::positionLerp(double anim_time) const noexcept {
+    uint32_t cursor {};
+    return positionLerp(static_cast<float>(anim_time), cursor);
+}
 
-//    if (!(norm >= 0.f && norm <= 1.f)) {
-//        throw std::runtime_error("norm >= 0.f && norm <= 1.f");
-//    }
+glm::fquat AnimationNode::rotationLerp(double anim_time) const noexcept {
+    uint32_t cursor {};
+    return rotationLerp(static_cast<float>(anim_time), cursor);
+}
 
-    return glm::mix(a.data, b.data, norm);
+glm::vec3 AnimationNode::scalingLerp(double anim_time) const noexcept {
+    uint32_t cursor {};
+    return scalingLerp(static_cast<float>(anim_time), cursor);
+}
+
+Animation::Animation(std::string _name, double _duration, double _tps, decltype(nodes) _nodes) noexcept
+    : nodes(std::move(_nodes))
+    , name(std::move(_name))
+    , duration(_duration)
+    , tps(_tps) {
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].bone >= channels.size()) {
+            channels.resize(nodes[i].bone + 1, NO_CHANNEL);
+        }
+        channels[nodes[i].bone] = i;
+    }
 }
 
 SkeletalModel::SkeletalModel(decltype(meshes)&& meshes, decltype(materials)&& materials, decltype(bones)&& _bones, decltype(bone_map)&& _bone_map, decltype(skeleton)&& _skeleton, decltype(animations)&& _animations, const glm::mat4& _global_matrix, std::string name) noexcept
@@ -114,4 +293,119 @@ SkeletalModel::SkeletalModel(decltype(meshes)&& meshes, decltype(materials)&& ma
     , bones {std::move(_bones)}
     , global_inverse {_global_matrix}
     , skeleton {std::move(_skeleton)} {
+    flattenSkeleton();
+}
+
+void SkeletalModel::flattenSkeleton() {
+    flat_skeleton.clear();
+
+    // breadth first, parents are added before children
+    std::vector<const Tree<uint32_t>*> trees {&skeleton};
+    flat_skeleton.push_back({*skeleton, SkeletonNode::NO_PARENT, {}});
+
+    for (uint32_t i = 0; i < trees.size(); ++i) {
+        for (const auto& child : *trees[i]) {
+            trees.emplace_back(&child);
+            flat_skeleton.push_back({*child, i, {}});
+        }
+    }
+
+    for (auto& node : flat_skeleton) {
+        const auto& bone = bones[node.bone];
+        node.local_transform = bone.isFake() ? glm::mat4{1.0f} : bone.node_transform;
+
+        glm::vec3 skew;
+        glm::vec4 perspective;
+        glm::decompose(node.local_transform, node.scale, node.rotation, node.position, skew, perspective);
+    }
+}
+
+void SkeletalModel::samplePose(const Animation& animation, double time, std::vector<glm::mat4>& bone_transform, KeyCursor* cursors) const {
+    const auto key_time = static_cast<float>(time);
+
+    // global transforms of nodes in flattened order, reused between calls of thread
+    thread_local std::vector<glm::mat4> global_transform;
+    global_transform.resize(flat_skeleton.size());
+
+    for (size_t i = 0; i < flat_skeleton.size(); ++i) {
+        const auto& node = flat_skeleton[i];
+
+        auto local_transform = node.local_transform;
+        if (const auto* channel = animation.findChannel(node.bone); channel) {
+            // without cursors every track is searched from its first key
+            KeyCursor local_cursor;
+            auto& cursor = cursors ? cursors[channel - animation.nodes.data()] : local_cursor;
+
+            const auto position = channel->positionLerp(key_time, cursor.position);
+            const auto rotation = channel->rotationLerp(key_time, cursor.rotation);
+            const auto scale = channel->scalingLerp(key_time, cursor.scale);
+
+            // translate * rotate * scale without full matrix products
+            local_transform = glm::mat4_cast(rotation);
+            local_transform[0] *= scale.x;
+            local_transform[1] *= scale.y;
+            local_transform[2] *= scale.z;
+            local_transform[3] = glm::vec4{position, 1.0f};
+        }
+
+        global_transform[i] = node.parent == SkeletonNode::NO_PARENT ? local_transform : global_transform[node.parent] * local_transform;
+        bone_transform[node.bone] = global_inverse * global_transform[i] * bones[node.bone].offset_matrix;
+    }
+}
+
+void SkeletalModel::sampleLocalPose(const Animation& animation, double time, Pose pose, KeyCursor* cursors) const noexcept {
+    const auto key_time = static_cast<float>(time);
+
+    for (size_t i = 0; i < flat_skeleton.size(); ++i) {
+        const auto& node = flat_skeleton[i];
+
+        if (const auto* channel = animation.findChannel(node.bone); channel) {
+            KeyCursor local_cursor;
+            auto& cursor = cursors ? cursors[channel - animation.nodes.data()] : local_cursor;
+
+            pose.positions[i] = channel->positionLerp(key_time, cursor.position);
+            pose.rotations[i] = channel->rotationLerp(key_time, cursor.rotation);
+            pose.scales[i] = channel->scalingLerp(key_time, cursor.scale);
+        } else {
+            pose.positions[i] = node.position;
+            pose.rotations[i] = node.rotation;
+            pose.scales[i] = node.scale;
+        }
+    }
+}
+
+void SkeletalModel::applyPose(Pose pose, std::vector<glm::mat4>& bone_transform) const {
+    thread_local std::vector<glm::mat4> global_transform;
+    global_transform.resize(flat_skeleton.size());
+
+    for (size_t i = 0; i < flat_skeleton.size(); ++i) {
+        const auto& node = flat_skeleton[i];
+
+        auto local_transform = glm::mat4_cast(pose.rotations[i]);
+        local_transform[0] *= pose.scales[i].x;
+        local_transform[1] *= pose.scales[i].y;
+        local_transform[2] *= pose.scales[i].z;
+        local_transform[3] = glm::vec4{pose.positions[i], 1.0f};
+
+        global_transform[i] = node.parent == SkeletonNode::NO_PARENT ? local_transform : global_transform[node.parent] * local_transform;
+        bone_transform[node.bone] = global_inverse * global_transform[i] * bones[node.bone].offset_matrix;
+    }
+}
+
+BoneMask SkeletalModel::makeBoneMask(const std::string& bone, float weight) const {
+    const auto found = bone_map.find(bone);
+    if (found == bone_map.end()) {
+        throw std::runtime_error("Bone not found " + bone);
+    }
+
+    // parents precede children, so descendants inherit weight in one pass
+    BoneMask mask(flat_skeleton.size(), 0.0f);
+    for (size_t i = 0; i < flat_skeleton.size(); ++i) {
+        const auto& node = flat_skeleton[i];
+        if (node.bone == found->second || (node.parent != SkeletonNode::NO_PARENT && mask[node.parent] > 0.0f)) {
+            mask[i] = weight;
+        }
+    }
+
+    return mask;
 }
@@ -4,6 +4,7 @@
 #include <limitless/ms/blending.hpp>
 
 #include <limitless/pipeline/sceneupdate_pass.hpp>
+#include <limitless/pipeline/frustum_culling_pass.hpp>
 #include <limitless/pipeline/effectupdate_pass.hpp>
 #include <limitless/pipeline/shadow_pass.hpp>
 #include <limitless/pipeline/skybox_pass.hpp>
@@ -13,6 +14,7 @@
 #include <limitless/pipeline/translucent_pass.hpp>
 #include <limitless/pipeline/gbuffer_pass.hpp>
 #include <limitless/pipeline/depth_pass.hpp>
+#include <limitless/pipeline/static_geometry_pass.hpp>
 #include <limitless/scene.hpp>
 #include <limitless/pipeline/blur_pass.hpp>
 #include <limitless/pipeline/composite_pass.hpp>
@@ -39,15 +41,26 @@ void Deferred::update(ContextEventObserver& ctx, const RenderSettings& settings)
 
 void Deferred::build(ContextEventObserver& ctx, const RenderSettings& settings) {
     add<SceneUpdatePass>(ctx);
+
+    StaticGeometry* geometry {};
+    if (settings.static_geometry_batching) {
+        add<StaticGeometryPass>(static_geometry);
+        geometry = &static_geometry;
+    } else {
+        static_geometry.clear();
+    }
+
     auto& fx = add<EffectUpdatePass>(ctx);
 
     if (settings.directional_cascade_shadow_mapping) {
         add<DirectionalShadowPass>(ctx, settings, fx.getRenderer());
     }
 
+    add<FrustumCullingPass>();
+
     add<DeferredFramebufferPass>(size);
-    add<DepthPass>(fx.getRenderer());
-    add<GBufferPass>(fx.getRenderer());
+    add<DepthPass>(fx.getRenderer(), geometry);
+    add<GBufferPass>(fx.getRenderer(), geometry);
 
     add<SkyboxPass>();
 
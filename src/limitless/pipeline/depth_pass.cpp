@@ -4,7 +4,6 @@
 #include <limitless/instances/abstract_instance.hpp>
 #include <limitless/pipeline/shader_pass_types.hpp>
 #include <limitless/ms/blending.hpp>
-#include <limitless/util/sorter.hpp>
 #include <limitless/core/context.hpp>
 
 #include <limitless/fx/effect_renderer.hpp>
@@ -12,13 +11,14 @@
 
 using namespace Limitless;
 
-DepthPass::DepthPass(Pipeline& pipeline, fx::EffectRenderer& _renderer)
+DepthPass::DepthPass(Pipeline& pipeline, fx::EffectRenderer& _renderer, StaticGeometry* static_geometry)
     : RenderPass(pipeline)
     , renderer {_renderer} {
+    queue.setStaticGeometry(static_geometry);
 }
 
 void DepthPass::draw([[maybe_unused]] Instances& instances, Context& ctx, [[maybe_unused]] const Assets& assets, [[maybe_unused]] const Camera& camera, [[maybe_unused]] UniformSetter& setter) {
-    std::sort(instances.begin(), instances.end(), FrontToBackSorter{camera});
+    queue.build(instances, assets, ShaderPass::Depth, ms::Blending::Opaque, camera);
 
     ctx.enable(Capabilities::DepthTest);
 	ctx.enable(Capabilities::StencilTest);
@@ -32,11 +32,9 @@ void DepthPass::draw([[maybe_unused]] Instances& instances, Context& ctx, [[mayb
 
     fb.bind();
 
-    for (auto& instance : instances) {
-    	instance.get().isOutlined() ? ctx.setStencilMask(0xFF) : ctx.setStencilMask(0x00);
-
-        instance.get().draw(ctx, assets, ShaderPass::Depth, ms::Blending::Opaque, setter);
-    }
+    queue.draw(ctx, setter, [&] (AbstractInstance& instance) {
+        instance.isOutlined() ? ctx.setStencilMask(0xFF) : ctx.setStencilMask(0x00);
+    });
 
     renderer.draw(ctx, assets, ShaderPass::Depth, ms::Blending::Opaque, setter);
 
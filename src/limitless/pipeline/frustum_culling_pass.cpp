@@ -0,0 +1,15 @@
+#include <limitless/pipeline/frustum_culling_pass.hpp>
+
+#include <limitless/scene.hpp>
+#include <limitless/camera.hpp>
+
+using namespace Limitless;
+
+FrustumCullingPass::FrustumCullingPass(Pipeline& pipeline)
+    : RenderPass(pipeline) {
+}
+
+void FrustumCullingPass::update(Scene& scene, Instances& instances, [[maybe_unused]] Context& ctx, const Camera& camera) {
+    instances.clear();
+    scene.query(Frustum{camera.getProjection() * camera.getView()}, instances);
+}
@@ -4,7 +4,6 @@
 #include <limitless/pipeline/shader_pass_types.hpp>
 #include <limitless/pipeline/pipeline.hpp>
 #include <limitless/ms/blending.hpp>
-#include <limitless/util/sorter.hpp>
 #include <limitless/core/context.hpp>
 #include <limitless/fx/effect_renderer.hpp>
 #include <limitless/pipeline/deferred_framebuffer_pass.hpp>
@@ -12,14 +11,14 @@
 
 using namespace Limitless;
 
-GBufferPass::GBufferPass(Pipeline& pipeline, fx::EffectRenderer& _renderer)
+GBufferPass::GBufferPass(Pipeline& pipeline, fx::EffectRenderer& _renderer, StaticGeometry* static_geometry)
     : RenderPass(pipeline)
     , renderer {_renderer} {
-
+    queue.setStaticGeometry(static_geometry);
 }
 
 void GBufferPass::draw([[maybe_unused]] Instances& instances, Context& ctx, [[maybe_unused]] const Assets& assets, [[maybe_unused]] const Camera& camera, [[maybe_unused]] UniformSetter& setter) {
-    std::sort(instances.begin(), instances.end(), FrontToBackSorter{camera});
+    queue.build(instances, assets, ShaderPass::GBuffer, ms::Blending::Opaque, camera);
 
     ctx.enable(Capabilities::DepthTest);
     ctx.disable(Capabilities::Blending);
@@ -30,9 +29,7 @@ void GBufferPass::draw([[maybe_unused]] Instances& instances, Context& ctx, [[ma
 
     fb.bind();
 
-    for (auto& instance : instances) {
-        instance.get().draw(ctx, assets, ShaderPass::GBuffer, ms::Blending::Opaque, setter);
-    }
+    queue.draw(ctx, setter);
 
     renderer.draw(ctx, assets, ShaderPass::GBuffer, ms::Blending::Opaque, setter);
 }
@@ -14,7 +14,7 @@ Pipeline::Pipeline(glm::uvec2 size, RenderTarget& target) noexcept
 }
 
 void Pipeline::draw(Context& context, const Assets& assets, Scene& scene, Camera& camera) {
-    Instances instances;
+    instances.clear();
 
     for (const auto& pass : passes) {
         pass->update(scene, instances, context, camera);
@@ -0,0 +1,416 @@
+#include <limitless/pipeline/render_queue.hpp>
+
+#include <limitless/instances/skeletal_instance.hpp>
+#include <limitless/instances/mesh_instance.hpp>
+#include <limitless/core/shader_program.hpp>
+#include <limitless/core/uniform_setter.hpp>
+#include <limitless/core/uniform.hpp>
+#include <limitless/core/context.hpp>
+#include <limitless/core/buffer_builder.hpp>
+#include <limitless/pipeline/static_geometry.hpp>
+#include <limitless/util/radix_sort.hpp>
+#include <limitless/ms/material.hpp>
+#include <limitless/camera.hpp>
+#include <limitless/assets.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Limitless;
+
+namespace {
+    constexpr uint64_t PASS_BITS = 3;
+    constexpr uint64_t BLENDING_BITS = 3;
+    constexpr uint64_t SHADER_BITS = 12;
+    constexpr uint64_t MATERIAL_BITS = 14;
+    constexpr uint64_t MESH_BITS = 14;
+    constexpr uint64_t DEPTH_BITS = 18;
+
+    static_assert(PASS_BITS + BLENDING_BITS + SHADER_BITS + MATERIAL_BITS + MESH_BITS + DEPTH_BITS == 64);
+
+    constexpr uint64_t mask(uint64_t bits) noexcept {
+        return (uint64_t{1} << bits) - 1;
+    }
+
+    // non-negative floats are ordered as their bit patterns, top bits keep exponent and start of mantissa
+    uint64_t quantizeDistance(float distance) noexcept {
+        distance = std::max(distance, 0.0f);
+
+        uint32_t bits;
+        std::memcpy(&bits, &distance, sizeof(bits));
+
+        return bits >> (31 - DEPTH_BITS);
+    }
+
+    uint64_t intern(std::unordered_map<const void*, uint64_t>& ids, const void* object) {
+        return ids.emplace(object, ids.size()).first->second;
+    }
+
+    constexpr auto INSTANCE_BUFFER_NAME = "model_buffer";
+}
+
+bool RenderQueue::MaterialValueLess::operator()(const ms::Material* lhs, const ms::Material* rhs) const noexcept {
+    return *lhs < *rhs;
+}
+
+ShaderProgram& RenderQueue::getShader(ModelShader model, uint64_t shader_index) {
+    const auto key = (static_cast<uint64_t>(model) << 56) | shader_index;
+
+    auto found = programs.find(key);
+    if (found == programs.end()) {
+        found = programs.emplace(key, &assets->shaders.get(pass, model, shader_index)).first;
+    }
+
+    return *found->second;
+}
+
+uint64_t RenderQueue::getMaterialId(const ms::Material& material, bool by_value) {
+    // both maps share one id sequence
+    const auto next = material_ids.size() + material_values.size();
+
+    if (by_value) {
+        return material_values.emplace(&material, next).first->second;
+    }
+
+    return material_ids.emplace(&material, next).first->second;
+}
+
+// ids wrap when there are more distinct objects than key bits, which only makes groups interleave
+uint64_t RenderQueue::makeKey(uint64_t shader_id, uint64_t material_id, uint64_t mesh_id, float distance) const noexcept {
+    shader_id &= mask(SHADER_BITS);
+    material_id &= mask(MATERIAL_BITS);
+    mesh_id &= mask(MESH_BITS);
+    const auto depth = quantizeDistance(distance);
+
+    auto key = (static_cast<uint64_t>(pass) & mask(PASS_BITS)) << (64 - PASS_BITS);
+    key |= (static_cast<uint64_t>(blending) & mask(BLENDING_BITS)) << (64 - PASS_BITS - BLENDING_BITS);
+
+    if (blending == ms::Blending::Opaque) {
+        key |= shader_id << (MATERIAL_BITS + MESH_BITS + DEPTH_BITS);
+        key |= material_id << (MESH_BITS + DEPTH_BITS);
+        key |= mesh_id << DEPTH_BITS;
+        key |= depth;
+    } else {
+        key |= (mask(DEPTH_BITS) - depth) << (SHADER_BITS + MATERIAL_BITS + MESH_BITS);
+        key |= shader_id << (MATERIAL_BITS + MESH_BITS);
+        key |= material_id << MESH_BITS;
+        key |= mesh_id;
+    }
+
+    return key;
+}
+
+void RenderQueue::build(Instances& instances, const Assets& _assets, ShaderPass _pass, ms::Blending _blending, const Camera& camera) {
+    clear();
+
+    assets = &_assets;
+    pass = _pass;
+    blending = _blending;
+    camera_position = camera.getPosition();
+
+    for (auto& instance : instances) {
+        instance.get().enqueue(*this);
+    }
+
+    radixSort(items, sort_buffer, [] (const Item& item) { return item.key; });
+
+    merge();
+}
+
+void RenderQueue::merge() {
+    instance_transforms.clear();
+    commands.clear();
+
+    const auto sameBatch = [] (const Item& lhs, const Item& rhs) {
+        // outline is per instance state that is set for whole draw
+        return rhs.instanceable
+            && lhs.shader == rhs.shader
+            && lhs.material_id == rhs.material_id
+            && lhs.instance->isOutlined() == rhs.instance->isOutlined()
+            // static meshes share vertex array, so they are merged even if different
+            && (lhs.range ? rhs.range != nullptr : !rhs.range && lhs.mesh->getMesh() == rhs.mesh->getMesh());
+    };
+
+    size_t count = 0;
+    for (size_t begin = 0; begin < items.size();) {
+        auto end = begin + 1;
+
+        if (items[begin].instanceable) {
+            while (end < items.size() && sameBatch(items[begin], items[end])) {
+                ++end;
+            }
+        }
+
+        if (items[begin].range) {
+            auto batch = items[begin];
+            batch.shader = &getShader(ModelShader::Instanced, batch.material->getShaderIndex());
+            batch.command_offset = static_cast<uint32_t>(commands.size());
+
+            commands.split();
+            for (auto i = begin; i < end; ++i) {
+                commands.add(*items[i].range, static_cast<uint32_t>(instance_transforms.size()));
+                instance_transforms.push_back(*items[i].transform);
+            }
+
+            batch.command_count = static_cast<uint32_t>(commands.size()) - batch.command_offset;
+
+            items[count++] = batch;
+            begin = end;
+            continue;
+        }
+
+        if (end - begin < MIN_INSTANCES) {
+            for (auto i = begin; i < end; ++i) {
+                items[count++] = items[i];
+            }
+            begin = end;
+            continue;
+        }
+
+        auto batch = items[begin];
+        batch.shader = &getShader(ModelShader::Instanced, batch.material->getShaderIndex());
+        batch.instance_offset = static_cast<uint32_t>(instance_transforms.size());
+        batch.instance_count = static_cast<uint32_t>(end - begin);
+
+        for (auto i = begin; i < end; ++i) {
+            instance_transforms.push_back(*items[i].transform);
+        }
+
+        items[count++] = batch;
+        begin = end;
+    }
+
+    items.resize(count);
+}
+
+void RenderQueue::uploadInstances() {
+    const auto size = sizeof(glm::mat4) * instance_transforms.size();
+
+    if (!instance_buffer) {
+        BufferBuilder builder;
+        instance_buffer = builder.setTarget(Buffer::Type::ShaderStorage)
+                .setUsage(Buffer::Usage::DynamicDraw)
+                .setAccess(Buffer::MutableAccess::WriteOrphaning)
+                .setData(nullptr)
+                .setDataSize(size)
+                .build();
+    } else if (instance_buffer->getSize() < size) {
+        instance_buffer->resize(size);
+    }
+
+    instance_buffer->mapData(instance_transforms.data(), size);
+}
+
+void RenderQueue::uploadCommands() {
+    const auto size = sizeof(DrawElementsIndirectCommand) * commands.size();
+
+    if (!command_buffer) {
+        BufferBuilder builder;
+        command_buffer = builder.setTarget(Buffer::Type::IndirectDraw)
+                .setUsage(Buffer::Usage::DynamicDraw)
+                .setAccess(Buffer::MutableAccess::WriteOrphaning)
+                .setData(nullptr)
+                .setDataSize(size)
+                .build();
+    } else if (command_buffer->getSize() < size) {
+        command_buffer->resize(size);
+    }
+
+    command_buffer->mapData(commands.getCommands().data(), size);
+}
+
+void RenderQueue::drawStatic(const Item& item, ShaderProgram& shader, Context& ctx) {
+    const auto bindInstances = [&] () {
+        instance_buffer->bindBase(ctx.getIndexedBuffers().getBindingPoint(IndexedBuffer::Type::ShaderStorage, INSTANCE_BUFFER_NAME));
+    };
+
+    if (StaticGeometry::isMultiDrawSupported()) {
+        // shader adds base instance of command to offset
+        shader << UniformValue {"_instance_offset", 0u};
+        shader.use();
+        bindInstances();
+
+        command_buffer->bind();
+        static_geometry->drawIndirect(item.command_offset, item.command_count);
+        return;
+    }
+
+    for (auto i = item.command_offset; i < item.command_offset + item.command_count; ++i) {
+        const auto& command = commands.getCommands()[i];
+
+        shader << UniformValue {"_instance_offset", command.base_instance};
+        shader.use();
+        bindInstances();
+
+        static_geometry->draw(command);
+    }
+}
+
+void RenderQueue::add(AbstractInstance& instance, MeshInstance& mesh, ModelShader model, const glm::mat4& transform, Buffer* bones, uint32_t bone_offset) {
+    if (mesh.isHidden()) {
+        return;
+    }
+
+    auto& material = mesh.getMaterial();
+    const auto distance = glm::distance(camera_position, instance.getPosition());
+
+    const auto push = [&] (uint64_t layer, const ms::Material& mat) {
+        if (mat.getBlending() != blending) {
+            return;
+        }
+
+        // per instance bones, tessellation and blending of several layers cannot be shared
+        const auto instanceable = blending == ms::Blending::Opaque
+                                  && model == ModelShader::Model
+                                  && material.count() == 1
+                                  && mat.getModelShaders().count(ModelShader::Instanced) != 0
+                                  && !mat.contains(ms::Property::TessellationFactor);
+
+        Item item;
+        item.instance = &instance;
+        item.shader = &getShader(model, mat.getShaderIndex());
+        item.material = &mat;
+        item.material_instance = &material;
+        item.layer = layer;
+        item.mesh = &mesh;
+        item.transform = &transform;
+        item.bones = bones;
+        item.bone_offset = bone_offset;
+        item.material_id = getMaterialId(mat, instanceable);
+        item.instanceable = instanceable;
+
+        if (instanceable && static_geometry) {
+            item.range = static_geometry->find(mesh.getMesh().get());
+        }
+
+        item.key = makeKey(intern(shader_ids, item.shader), item.material_id, intern(mesh_ids, mesh.getMesh().get()), distance);
+
+        items.push_back(item);
+    };
+
+    if (!material.isLayered()) {
+        push(0, material[0]);
+        return;
+    }
+
+    for (const auto& [index, mat] : material) {
+        push(index, *mat);
+    }
+}
+
+void RenderQueue::add(AbstractInstance& instance) {
+    const auto distance = glm::distance(camera_position, instance.getPosition());
+    // instances that draw themselves go after every shader group
+    Item item;
+    item.key = makeKey(mask(SHADER_BITS), 0, 0, distance);
+    item.instance = &instance;
+
+    items.push_back(item);
+}
+
+void RenderQueue::draw(Context& ctx, const UniformSetter& setter, const InstanceCallback& callback) {
+    const AbstractInstance* last_instance {};
+    ShaderProgram* last_shader {};
+    const MaterialInstance* last_material_instance {};
+    uint64_t last_layer {};
+    const ms::Material* last_material {};
+    const Buffer* bound_bones {};
+
+    if (!instance_transforms.empty()) {
+        uploadInstances();
+    }
+
+    if (!commands.empty()) {
+        uploadCommands();
+    }
+
+    for (const auto& item : items) {
+        if (item.instance != last_instance) {
+            last_instance = item.instance;
+            if (callback) {
+                callback(*item.instance);
+            }
+        }
+
+        if (!item.shader) {
+            item.instance->draw(ctx, *assets, pass, blending, setter);
+
+            // instance could bind anything, nothing is reused after it
+            last_shader = nullptr;
+            last_material_instance = nullptr;
+            last_material = nullptr;
+            bound_bones = nullptr;
+            continue;
+        }
+
+        auto& shader = *item.shader;
+
+        if (item.bones && item.bones != bound_bones) {
+            item.bones->bindBase(ctx.getIndexedBuffers().getBindingPoint(IndexedBuffer::Type::ShaderStorage, SkeletalInstance::BONE_BUFFER_NAME));
+            bound_bones = item.bones;
+        }
+
+        // blending and culling depend on layers of material instance
+        if (item.material_instance != last_material_instance || item.layer != last_layer) {
+            item.material_instance->setMaterialState(ctx, item.layer, pass);
+            last_material_instance = item.material_instance;
+            last_layer = item.layer;
+        }
+
+        const auto shader_changed = &shader != last_shader;
+
+        if (shader_changed || item.material != last_material) {
+            shader << *item.material;
+            last_material = item.material;
+        }
+
+        // pass-dependent uniforms are the same for every draw with this shader
+        if (shader_changed) {
+            setter(shader);
+            last_shader = &shader;
+        }
+
+        if (item.command_count != 0) {
+            drawStatic(item, shader, ctx);
+            continue;
+        }
+
+        const auto& mesh = item.mesh->getMesh();
+
+        if (item.instance_count != 0) {
+            shader << UniformValue {"_instance_offset", item.instance_offset};
+
+            shader.use();
+
+            // program binds named storages in use(), so transforms are bound after it
+            instance_buffer->bindBase(ctx.getIndexedBuffers().getBindingPoint(IndexedBuffer::Type::ShaderStorage, INSTANCE_BUFFER_NAME));
+
+            mesh->draw_instanced(item.instance_count);
+            continue;
+        }
+
+        shader << UniformValue {"_model_transform", *item.transform};
+
+        if (item.bones) {
+            shader << UniformValue {SkeletalInstance::BONE_OFFSET_NAME, item.bone_offset};
+        }
+
+        shader.use();
+
+        if (item.material->contains(ms::Property::TessellationFactor)) {
+            glPatchParameteri(GL_PATCH_VERTICES, 4);
+            mesh->draw(VertexStreamDraw::Patches);
+        } else {
+            mesh->draw();
+        }
+    }
+}
+
+void RenderQueue::clear() noexcept {
+    items.clear();
+    shader_ids.clear();
+    material_ids.clear();
+    material_values.clear();
+    mesh_ids.clear();
+    programs.clear();
+}
@@ -16,9 +16,9 @@ DirectionalShadowPass::DirectionalShadowPass(Pipeline& pipeline, Context& ctx, c
     , effect_renderer {&renderer} {
 }
 
-void DirectionalShadowPass::draw(Instances& instances, Context& ctx, const Assets& assets, const Camera& camera, [[maybe_unused]] UniformSetter& setter) {
+void DirectionalShadowPass::draw([[maybe_unused]] Instances& instances, Context& ctx, const Assets& assets, const Camera& camera, [[maybe_unused]] UniformSetter& setter) {
     if (light) {
-        shadows.draw(instances, *light, ctx, assets, camera, effect_renderer);
+        shadows.draw(*scene, *light, ctx, assets, camera, effect_renderer);
         shadows.mapData();
     }
 }
@@ -29,6 +29,7 @@ void DirectionalShadowPass::addSetter(UniformSetter& setter) {
     });
 }
 
-void DirectionalShadowPass::update(Scene& scene, [[maybe_unused]] Instances& instances, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) {
-    light = &scene.lighting.directional_light;
+void DirectionalShadowPass::update(Scene& _scene, [[maybe_unused]] Instances& instances, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) {
+    scene = &_scene;
+    light = &scene->lighting.directional_light;
 }
@@ -0,0 +1,277 @@
+#include <limitless/pipeline/static_geometry.hpp>
+
+#include <limitless/core/skeletal_stream.hpp>
+#include <limitless/core/buffer_builder.hpp>
+#include <limitless/core/context_initializer.hpp>
+#include <limitless/models/mesh.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace Limitless;
+
+namespace {
+    std::shared_ptr<Buffer> makeBuffer(Buffer::Type target, size_t size) {
+        BufferBuilder builder;
+        return builder.setTarget(target)
+                .setUsage(Buffer::Storage::Dynamic)
+                .setAccess(Buffer::ImmutableAccess::None)
+                .setDataSize(size)
+                .build();
+    }
+}
+
+VertexStream<VertexNormalTangent>* StaticGeometry::getShareableStream(AbstractMesh& mesh) noexcept {
+    auto* triangle_mesh = dynamic_cast<Mesh*>(&mesh);
+    if (!triangle_mesh) {
+        return nullptr;
+    }
+
+    auto* stream = dynamic_cast<VertexStream<VertexNormalTangent>*>(&triangle_mesh->getVertexStream());
+
+    // skinned streams keep bone weights in their own vertex array
+    const auto shareable = stream && !dynamic_cast<SkinnedVertexStream<VertexNormalTangent>*>(stream)
+                                  && stream->getUsage() == VertexStreamUsage::Static
+                                  && stream->getDrawMode() == VertexStreamDraw::Triangles
+                                  && !stream->getVertices().empty();
+
+    return shareable ? stream : nullptr;
+}
+
+size_t StaticGeometry::getIndexCount(const VertexStream<VertexNormalTangent>& stream) noexcept {
+    if (const auto* indexed = dynamic_cast<const IndexedVertexStream<VertexNormalTangent>*>(&stream); indexed) {
+        return indexed->getIndices().size();
+    }
+    return stream.getVertices().size();
+}
+
+void StaticGeometry::add(const std::shared_ptr<AbstractMesh>& mesh) {
+    if (!mesh) {
+        return;
+    }
+
+    if (auto found = allocations.find(mesh.get()); found != allocations.end()) {
+        if (!found->second.mesh.expired()) {
+            return;
+        }
+
+        // another mesh was created at address of destroyed one
+        release(found->second);
+        allocations.erase(found);
+    }
+
+    auto* stream = getShareableStream(*mesh);
+    if (!stream) {
+        return;
+    }
+
+    allocations.emplace(mesh.get(), Allocation {mesh, stream, std::nullopt, 0});
+}
+
+void StaticGeometry::release(Allocation& allocation) noexcept {
+    if (!allocation.range) {
+        return;
+    }
+
+    vertex_count -= allocation.vertex_count;
+    index_count -= allocation.range->index_count;
+    allocation.range.reset();
+}
+
+void StaticGeometry::update() {
+    auto pending = false;
+
+    for (auto it = allocations.begin(); it != allocations.end();) {
+        auto& allocation = it->second;
+
+        if (allocation.mesh.expired()) {
+            release(allocation);
+            it = allocations.erase(it);
+            continue;
+        }
+
+        // mapped again after upload, so it has own buffers with new data
+        if (allocation.range && !allocation.stream->isShared()) {
+            release(allocation);
+        }
+
+        pending |= !allocation.range;
+        ++it;
+    }
+
+    if (vertex_end - vertex_count > vertex_count || index_end - index_count > index_count) {
+        pack();
+    } else if (pending) {
+        append();
+    }
+}
+
+void StaticGeometry::reserve(size_t vertices, size_t indices) {
+    if (vertices <= vertex_capacity && indices <= index_capacity) {
+        return;
+    }
+
+    vertex_capacity = std::max(vertices, vertex_capacity * 2);
+    index_capacity = std::max(indices, index_capacity * 2);
+
+    vertex_buffer = makeBuffer(Buffer::Type::Array, vertex_capacity * sizeof(VertexNormalTangent));
+    index_buffer = makeBuffer(Buffer::Type::Element, index_capacity * sizeof(uint32_t));
+
+    // uploaded meshes draw through the same vertex array, so they see new buffers
+    if (!vertex_array) {
+        vertex_array = std::make_shared<VertexArray>();
+    }
+    *vertex_array << std::pair<VertexNormalTangent, const std::shared_ptr<Buffer>&>(VertexNormalTangent{}, vertex_buffer);
+    vertex_array->setElementBuffer(index_buffer);
+
+    // ranges stay in place, meshes keep their data on CPU
+    for (const auto& [_, allocation] : allocations) {
+        if (allocation.range) {
+            write(allocation);
+        }
+    }
+}
+
+void StaticGeometry::place(Allocation& allocation) {
+    GeometryRange range;
+    range.first_index = static_cast<uint32_t>(index_end);
+    range.index_count = static_cast<uint32_t>(getIndexCount(*allocation.stream));
+    range.base_vertex = static_cast<int32_t>(vertex_end);
+    allocation.vertex_count = static_cast<uint32_t>(allocation.stream->getVertices().size());
+
+    vertex_end += allocation.vertex_count;
+    index_end += range.index_count;
+    vertex_count += allocation.vertex_count;
+    index_count += range.index_count;
+
+    allocation.range = range;
+    write(allocation);
+    allocation.stream->share({vertex_array, range.first_index, range.index_count, range.base_vertex});
+}
+
+void StaticGeometry::write(const Allocation& allocation) {
+    // without direct state access element buffer is written through binding of current vertex array
+    vertex_array->bind();
+
+    const auto& range = *allocation.range;
+    const auto& vertices = allocation.stream->getVertices();
+
+    vertex_buffer->bufferSubData(range.base_vertex * sizeof(VertexNormalTangent), vertices.size() * sizeof(VertexNormalTangent), vertices.data());
+
+    const uint32_t* indices;
+    if (const auto* indexed = dynamic_cast<const IndexedVertexStream<VertexNormalTangent>*>(allocation.stream); indexed) {
+        indices = indexed->getIndices().data();
+    } else {
+        sequential_indices.resize(vertices.size());
+        std::iota(sequential_indices.begin(), sequential_indices.end(), 0);
+        indices = sequential_indices.data();
+    }
+
+    index_buffer->bufferSubData(range.first_index * sizeof(uint32_t), range.index_count * sizeof(uint32_t), indices);
+}
+
+void StaticGeometry::append() {
+    auto vertices = vertex_end;
+    auto indices = index_end;
+    for (const auto& [_, allocation] : allocations) {
+        if (!allocation.range) {
+            vertices += allocation.stream->getVertices().size();
+            indices += getIndexCount(*allocation.stream);
+        }
+    }
+
+    reserve(vertices, indices);
+
+    for (auto& [_, allocation] : allocations) {
+        if (!allocation.range) {
+            place(allocation);
+        }
+    }
+}
+
+void StaticGeometry::pack() {
+    size_t vertices = 0;
+    size_t indices = 0;
+    for (auto& [_, allocation] : allocations) {
+        vertices += allocation.stream->getVertices().size();
+        indices += getIndexCount(*allocation.stream);
+        allocation.range.reset();
+    }
+
+    vertex_end = 0;
+    index_end = 0;
+    vertex_count = 0;
+    index_count = 0;
+
+    // buffers are allocated again to fit alive meshes only
+    vertex_capacity = 0;
+    index_capacity = 0;
+    vertex_buffer.reset();
+    index_buffer.reset();
+
+    if (allocations.empty()) {
+        vertex_array.reset();
+        return;
+    }
+
+    reserve(vertices, indices);
+
+    for (auto& [_, allocation] : allocations) {
+        place(allocation);
+    }
+}
+
+const GeometryRange* StaticGeometry::find(const AbstractMesh* mesh) const noexcept {
+    const auto found = allocations.find(mesh);
+    if (found == allocations.end() || found->second.mesh.expired() || !found->second.range) {
+        return nullptr;
+    }
+
+    return &*found->second.range;
+}
+
+void StaticGeometry::bind() {
+    if (vertex_array) {
+        vertex_array->bind();
+    }
+}
+
+bool StaticGeometry::isMultiDrawSupported() {
+    static const auto supported = ContextInitializer::isExtensionSupported("GL_ARB_multi_draw_indirect")
+                                  && ContextInitializer::isExtensionSupported("GL_ARB_shader_draw_parameters");
+    return supported;
+}
+
+void StaticGeometry::drawIndirect(uint32_t offset, uint32_t count) {
+    bind();
+
+    const auto* indirect = reinterpret_cast<const void*>(offset * sizeof(DrawElementsIndirectCommand));
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, indirect, static_cast<GLsizei>(count), 0);
+}
+
+void StaticGeometry::draw(const DrawElementsIndirectCommand& command) {
+    bind();
+
+    const auto* offset = reinterpret_cast<const void*>(command.first_index * sizeof(uint32_t));
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT, offset,
+                                      static_cast<GLsizei>(command.instance_count), command.base_vertex);
+}
+
+void StaticGeometry::clear() {
+    for (auto& [_, allocation] : allocations) {
+        if (allocation.range && !allocation.mesh.expired()) {
+            allocation.stream->unshare();
+        }
+    }
+
+    allocations.clear();
+    vertex_buffer.reset();
+    index_buffer.reset();
+    vertex_array.reset();
+    vertex_capacity = 0;
+    index_capacity = 0;
+    vertex_end = 0;
+    index_end = 0;
+    vertex_count = 0;
+    index_count = 0;
+}
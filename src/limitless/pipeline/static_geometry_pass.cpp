@@ -0,0 +1,39 @@
+#include <limitless/pipeline/static_geometry_pass.hpp>
+
+#include <limitless/pipeline/static_geometry.hpp>
+#include <limitless/instances/model_instance.hpp>
+#include <limitless/scene.hpp>
+
+using namespace Limitless;
+
+StaticGeometryPass::StaticGeometryPass(Pipeline& pipeline, StaticGeometry& _geometry)
+    : RenderPass(pipeline)
+    , geometry {_geometry} {
+}
+
+void StaticGeometryPass::update(Scene& scene, [[maybe_unused]] Instances& instances, [[maybe_unused]] Context& ctx, [[maybe_unused]] const Camera& camera) {
+    const auto version = scene.getStructureVersion();
+    if (&scene == last_scene && version == last_version) {
+        return;
+    }
+
+    last_scene = &scene;
+    last_version = version;
+
+    // only model meshes are drawn from shared buffers, every level of detail of them; lights share model type
+    for (const auto& wrapper : scene.getWrappers(ModelShader::Model)) {
+        auto* instance = dynamic_cast<ModelInstance*>(&wrapper.get());
+        if (!instance) {
+            continue;
+        }
+
+        for (const auto& [_, mesh] : instance->getMeshes()) {
+            for (uint32_t level = 0; level < mesh.getLevelCount(); ++level) {
+                geometry.add(mesh.getLevelMesh(level));
+            }
+        }
+    }
+
+    // meshes of removed instances are dropped here as well
+    geometry.update();
+}
@@ -1,7 +1,6 @@
 #include <limitless/pipeline/translucent_pass.hpp>
 
 #include <limitless/pipeline/shader_pass_types.hpp>
-#include <limitless/util/sorter.hpp>
 #include <limitless/instances/abstract_instance.hpp>
 #include <limitless/fx/effect_renderer.hpp>
 #include <limitless/assets.hpp>
@@ -21,22 +20,6 @@ TranslucentPass::TranslucentPass(Pipeline& pipeline, fx::EffectRenderer& _render
     , renderer {_renderer} {
 }
 
-void TranslucentPass::sort(Instances& instances, const Camera& camera, ms::Blending blending) {
-    switch (blending) {
-        case ms::Blending::Opaque:
-            std::sort(instances.begin(), instances.end(), FrontToBackSorter{camera});
-            break;
-        case ms::Blending::Translucent:
-        case ms::Blending::Additive:
-        case ms::Blending::Modulate:
-            std::sort(instances.begin(), instances.end(), BackToFrontSorter{camera});
-            break;
-        case ms::Blending::MultipleOpaque:
-        case ms::Blending::Text:
-            throw std::logic_error("This type of blending cannot be used as ColorPass value");
-    }
-}
-
 void TranslucentPass::draw(Instances& instances, Context& ctx, const Assets& assets, const Camera& camera, UniformSetter& setter) {
     std::array transparent = {
         ms::Blending::Additive,
@@ -51,11 +34,8 @@ void TranslucentPass::draw(Instances& instances, Context& ctx, const Assets& ass
     });
 
     for (const auto& blending : transparent) {
-        sort(instances, camera, blending);
-
-        for (auto& instance : instances) {
-            instance.get().draw(ctx, assets, ShaderPass::Forward, blending, setter);
-        }
+        queue.build(instances, assets, ShaderPass::Forward, blending, camera);
+        queue.draw(ctx, setter);
 
         renderer.draw(ctx, assets, ShaderPass::Forward, blending, setter);
     }
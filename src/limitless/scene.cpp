@@ -1,70 +1,292 @@
 #include <limitless/scene.hpp>
 #include <limitless/instances/skeletal_instance.hpp>
+#include <limitless/instances/effect_instance.hpp>
 #include <limitless/assets.hpp>
 
 using namespace Limitless;
 
 Scene::Scene(Context& context)
-    : lighting {context} {
+    : lighting {context}
+    , update_pool {std::max(std::thread::hardware_concurrency(), 1u) - 1} {
 }
 
 AbstractInstance& Scene::operator[](uint64_t id) noexcept { return *instances[id]; }
 AbstractInstance& Scene::at(uint64_t id) { return *instances.at(id); }
 
-void Scene::remove(uint64_t id) { instances.erase(id); }
+void Scene::remove(uint64_t id) {
+    if (auto it = instances.find(id); it != instances.end()) {
+        removeFromIndex(*it->second);
+        instances.erase(it);
+        hierarchy.invalidate();
+    }
+}
 
 void Scene::setSkybox(std::shared_ptr<Skybox> _skybox) {
     skybox = std::move(_skybox);
 }
 
+void Scene::setFixedTimestep(std::optional<float> step) {
+    if (step && *step <= 0.0f) {
+        throw std::invalid_argument("Fixed timestep should be positive");
+    }
+
+    fixed_timestep = step;
+    accumulator = 0.0f;
+}
+
 void Scene::update(Context& context, const Camera& camera) {
+    const auto current_time = std::chrono::steady_clock::now();
+    const auto dt = last_update ? std::chrono::duration<float>(current_time - *last_update).count() : 0.0f;
+    last_update = current_time;
+
+    advance(context, camera, dt);
+}
+
+void Scene::advance(Context& context, const Camera& camera, float dt) {
     lighting.update();
 
     removeDeadInstances();
 
-    //TODO: why is here two updates?
-    for (auto& [_, instance] : instances) {
-        if (instance->getShaderType() != ModelShader::Effect) {
-            instance->update(context, camera);
-        }
+    if (!fixed_timestep) {
+        simulate(context, camera, dt);
+        updateIndex();
+        uploadBones();
+        return;
     }
 
-    for (auto& [_, instance] : instances) {
-        if (instance->getShaderType() == ModelShader::Effect) {
-            instance->update(context, camera);
-        }
+    accumulator += dt;
+
+    uint32_t steps = 0;
+    while (accumulator >= *fixed_timestep && steps < MAX_FIXED_STEPS) {
+        simulate(context, camera, *fixed_timestep);
+        accumulator -= *fixed_timestep;
+        ++steps;
+    }
+
+    // simulation can not keep up, so it slows down instead of spiraling
+    if (steps == MAX_FIXED_STEPS) {
+        accumulator = std::min(accumulator, *fixed_timestep);
     }
+
+    updateIndex();
+    // every frame maps another region, so bones are written even if no step was simulated
+    uploadBones();
+}
+
+void Scene::updateStructure() {
+    if (!hierarchy.isOutdated()) {
+        return;
+    }
+
+    std::vector<AbstractInstance*> roots;
+    roots.reserve(instances.size());
+    for (const auto& [_, instance] : instances) {
+        roots.emplace_back(instance.get());
+    }
+    hierarchy.build(roots);
+
+    wrappers.clear();
+    for (auto& list : shader_wrappers) {
+        list.clear();
+    }
+
+    for (size_t i = 0; i < hierarchy.size(); ++i) {
+        auto& instance = hierarchy[i];
+        wrappers.emplace_back(instance);
+        shader_wrappers[static_cast<size_t>(instance.getShaderType())].emplace_back(instance);
+    }
+
+    ++structure_version;
+}
+
+void Scene::simulate(Context& context, const Camera& camera, float dt) {
+    updateStructure();
+
+    // phases are barriers; instances within one phase do not depend on each other,
+    // so the result does not depend on how they are split between workers
+
+    // animations are sampled first, because they set socket transformations of attachments
+    const auto& skeletal = shader_wrappers[static_cast<size_t>(ModelShader::Skeletal)];
+    update_pool.forEach(skeletal.size(), SKELETAL_UPDATE_CHUNK, [&] (size_t i) {
+        static_cast<SkeletalInstance&>(skeletal[i].get()).animate(dt);
+    });
+
+    // matrices of all instances and attachments, level by level
+    hierarchy.update(&update_pool);
+
+    // emitters can depend on other instances (i.e. mesh location on skeletal instance)
+    const auto& effects = shader_wrappers[static_cast<size_t>(ModelShader::Effect)];
+    update_pool.forEach(effects.size(), EFFECT_UPDATE_CHUNK, [&] (size_t i) {
+        static_cast<EffectInstance&>(effects[i].get()).updateEmitters(context, camera, dt);
+    });
+
+    // the rest is done on this thread, because it uploads buffers (materials, instanced matrices, lights);
+    // work done by phases above is skipped. flattened list has parents first, so attachments
+    // are updated without recursion through their parents
+    for (auto& instance : wrappers) {
+        instance.get().update(context, camera, dt);
+    }
+}
+
+void Scene::uploadBones() {
+    const auto& skeletal = shader_wrappers[static_cast<size_t>(ModelShader::Skeletal)];
+    if (skeletal.empty()) {
+        return;
+    }
+
+    bone_offsets.resize(skeletal.size());
+    size_t count = 0;
+    for (size_t i = 0; i < skeletal.size(); ++i) {
+        bone_offsets[i] = static_cast<uint32_t>(count);
+        count += static_cast<SkeletalInstance&>(skeletal[i].get()).getBoneTransform().size();
+    }
+
+    // palettes do not overlap, so workers write mapped memory without GL calls
+    auto* palette = bone_storage.map(count);
+    const auto& buffer = bone_storage.getBuffer();
+    update_pool.forEach(skeletal.size(), SKELETAL_UPDATE_CHUNK, [&] (size_t i) {
+        static_cast<SkeletalInstance&>(skeletal[i].get()).writeBones(palette, buffer, bone_offsets[i]);
+    });
 }
 
 void Scene::removeDeadInstances() noexcept {
     for (auto it = instances.cbegin(); it != instances.cend(); ) {
         if (it->second->isKilled()) {
             it = instances.erase(it);
+            hierarchy.invalidate();
         } else {
             ++it;
         }
     }
 }
 
-Instances Scene::getWrappers() noexcept {
-    Instances wrappers;
-    wrappers.reserve(instances.size());
+const Instances& Scene::getWrappers() {
+    updateStructure();
+    return wrappers;
+}
 
-    const std::function<void(AbstractInstance&)> visitor = [&] (AbstractInstance& instance) {
-	    wrappers.emplace_back(std::ref(instance));
+const Instances& Scene::getWrappers(ModelShader type) {
+    updateStructure();
+    return shader_wrappers[static_cast<size_t>(type)];
+}
 
-	    for (auto& [_, attachment] : instance.getAttachments()) {
-	    	visitor(*attachment);
-	    }
-    };
+uint64_t Scene::getStructureVersion() {
+    updateStructure();
+    return structure_version;
+}
 
-	for (const auto& [_, instance] : instances) {
-		visitor(*instance);
+void Scene::clear() {
+	instances.clear();
+	hierarchy.invalidate();
+	wrappers.clear();
+	for (auto& list : shader_wrappers) {
+		list.clear();
 	}
 
-    return wrappers;
+	spatial_index.clear();
+	indexed.clear();
+	unbounded.clear();
 }
 
-void Scene::clear() {
-	instances.clear();
+void Scene::updateIndex() {
+    // instances could be attached or detached during simulation
+    updateStructure();
+
+    // boxes change only with transforms, so instances that did not move are skipped
+    if (indexed_structure_version == structure_version) {
+        for (auto& wrapper : wrappers) {
+            auto& instance = wrapper.get();
+
+            if (instance.hasBoundingBox() && instance.takeBoundsChange()) {
+                spatial_index.move(indexed.at(&instance).proxy, instance.getBoundingBox());
+            }
+        }
+        return;
+    }
+
+    ++index_generation;
+    unbounded.clear();
+
+    // only instances that left their fat boxes are reinserted
+    for (auto& wrapper : wrappers) {
+        auto& instance = wrapper.get();
+
+        if (instance.hasBoundingBox()) {
+            const auto moved = instance.takeBoundsChange();
+
+            if (auto it = indexed.find(&instance); it != indexed.end()) {
+                if (moved) {
+                    spatial_index.move(it->second.proxy, instance.getBoundingBox());
+                }
+                it->second.generation = index_generation;
+            } else {
+                indexed.emplace(&instance, IndexEntry{spatial_index.insert(instance.getBoundingBox(), &instance), index_generation});
+            }
+        } else {
+            unbounded.emplace_back(instance);
+        }
+    }
+
+    // entries not visited belong to removed instances or detached attachments
+    for (auto it = indexed.begin(); it != indexed.end(); ) {
+        if (it->second.generation != index_generation) {
+            spatial_index.remove(it->second.proxy);
+            it = indexed.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    indexed_structure_version = structure_version;
+}
+
+void Scene::removeFromIndex(AbstractInstance& instance) noexcept {
+    if (auto it = indexed.find(&instance); it != indexed.end()) {
+        spatial_index.remove(it->second.proxy);
+        indexed.erase(it);
+    }
+
+    unbounded.erase(std::remove_if(unbounded.begin(), unbounded.end(), [&] (const auto& wrapper) {
+        return &wrapper.get() == &instance;
+    }), unbounded.end());
+
+    for (auto& [_, attachment] : instance.getAttachments()) {
+        removeFromIndex(*attachment);
+    }
+}
+
+void Scene::query(const Frustum& frustum, Instances& result) const {
+    result.insert(result.end(), unbounded.begin(), unbounded.end());
+    spatial_index.query(frustum, [&] (AbstractInstance* instance) {
+        result.emplace_back(*instance);
+    });
+}
+
+void Scene::query(const BoundingBox& box, Instances& result) const {
+    result.insert(result.end(), unbounded.begin(), unbounded.end());
+    spatial_index.query(box, [&] (AbstractInstance* instance) {
+        result.emplace_back(*instance);
+    });
+}
+
+void Scene::query(const glm::vec3& center, float radius, Instances& result) const {
+    result.insert(result.end(), unbounded.begin(), unbounded.end());
+    spatial_index.query(center, radius, [&] (AbstractInstance* instance) {
+        result.emplace_back(*instance);
+    });
+}
+
+std::optional<RayHit> Scene::pick(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const {
+    const auto normalized = glm::normalize(direction);
+
+    std::optional<RayHit> hit;
+    raycast(origin, normalized, max_distance, [&] (AbstractInstance& instance, [[maybe_unused]] float box_distance) {
+        if (auto result = instance.raycast(origin, normalized, max_distance); result) {
+            max_distance = result->distance;
+            hit = std::move(result);
+        }
+        return max_distance;
+    });
+
+    return hit;
 }
@@ -0,0 +1,93 @@
+#include <limitless/serialization/animation_serializer.hpp>
+
+#include <limitless/models/skeletal_model.hpp>
+#include <limitless/util/bytebuffer.hpp>
+#include <stdexcept>
+
+using namespace Limitless;
+
+namespace {
+    template<typename T>
+    void writeTrack(ByteBuffer& buffer, const KeyTrack<T>& track) {
+        buffer << static_cast<uint32_t>(track.size()) << track.min << track.extent;
+        buffer.write(track.times.data(), track.times.size());
+        buffer.write(track.keys.data(), track.keys.size());
+    }
+
+    template<typename T>
+    KeyTrack<T> readTrack(ByteBuffer& buffer) {
+        KeyTrack<T> track;
+        uint32_t size {};
+        buffer >> size >> track.min >> track.extent;
+
+        if (static_cast<size_t>(size) * (sizeof(float) + sizeof(PackedKey)) > buffer.size()) {
+            throw std::runtime_error("Animation track is out of buffer bounds!");
+        }
+
+        track.times.resize(size);
+        track.keys.resize(size);
+        buffer.read(track.times.data(), size);
+        buffer.read(track.keys.data(), size);
+        return track;
+    }
+}
+
+ByteBuffer AnimationSerializer::serialize(const Animation& animation) {
+    ByteBuffer buffer;
+
+    buffer << VERSION;
+
+    buffer << animation.name
+           << animation.duration
+           << animation.tps
+           << static_cast<uint32_t>(animation.nodes.size());
+
+    for (const auto& node : animation.nodes) {
+        buffer << node.bone;
+        writeTrack(buffer, node.positions);
+        writeTrack(buffer, node.rotations);
+        writeTrack(buffer, node.scales);
+    }
+
+    return buffer;
+}
+
+Animation AnimationSerializer::deserialize(ByteBuffer& buffer) {
+    uint8_t version {};
+
+    buffer >> version;
+
+    if (version != VERSION) {
+        throw std::runtime_error("Wrong animation serializer version! " + std::to_string(VERSION) + " vs " + std::to_string(version));
+    }
+
+    std::string name;
+    double duration {};
+    double tps {};
+    uint32_t count {};
+
+    buffer >> name
+           >> duration
+           >> tps
+           >> count;
+
+    std::vector<AnimationNode> nodes;
+    nodes.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t bone {};
+        buffer >> bone;
+
+        auto positions = readTrack<glm::vec3>(buffer);
+        auto rotations = readTrack<glm::fquat>(buffer);
+        auto scales = readTrack<glm::vec3>(buffer);
+        nodes.emplace_back(std::move(positions), std::move(rotations), std::move(scales), bone);
+    }
+
+    return {std::move(name), duration, tps, std::move(nodes)};
+}
+
+ByteBuffer& Limitless::operator<<(ByteBuffer& buffer, const Animation& animation) {
+    AnimationSerializer serializer;
+    buffer << serializer.serialize(animation);
+    return buffer;
+}
@@ -15,19 +15,23 @@ ByteBuffer DistributionSerializer::serialize(const Distribution<T>& distr)
 
     buffer << distr.getType();
 
-    //switch (distr.getType())
-    //{
-    //    case DistributionType::Const:
-    //        buffer << distr.get();
-    //        break;
-    //    case DistributionType::Range:
-    //        buffer << static_cast<const RangeDistribution<T>&>(distr).getMin()
-    //               << static_cast<const RangeDistribution<T>&>(distr).getMax();
-    //        break;
-    //    case DistributionType::Curve:
-    //        assert("TODO");
-    //        break;
-    //}
+    switch (distr.getType()) {
+        case DistributionType::Const:
+            buffer << distr.get();
+            break;
+        case DistributionType::Range:
+            buffer << static_cast<const RangeDistribution<T>&>(distr).getMin()
+                   << static_cast<const RangeDistribution<T>&>(distr).getMax();
+            break;
+        case DistributionType::Curve:
+            if constexpr (std::is_integral_v<T>) {
+                throw std::runtime_error("Curve distribution of integral type is not supported!");
+            } else {
+                const auto& curve = static_cast<const CurveDistribution<T>&>(distr);
+                buffer << curve.getInterpolation() << curve.getKeys();
+            }
+            break;
+    }
 
     return buffer;
 }
@@ -46,24 +50,31 @@ std::unique_ptr<Distribution<T>> DistributionSerializer::deserialize(ByteBuffer&
     buffer >> type;
 
     std::unique_ptr<Distribution<T>> distribution;
-    //switch (type) {
-    //    case DistributionType::Const: {
-    //        T value{};
-    //        buffer >> value;
-    //        distribution = std::unique_ptr<Distribution<T>>(new ConstDistribution<T>(value));
-    //        break;
-    //    }
-    //    case DistributionType::Range: {
-    //        T min{};
-    //        T max{};
-    //        buffer >> min >> max;
-    //        distribution = std::unique_ptr<Distribution<T>>(new RangeDistribution<T>(min, max));
-    //        break;
-    //    }
-    //    case DistributionType::Curve:
-    //        assert("TODO");
-    //        break;
-    //}
+    switch (type) {
+        case DistributionType::Const: {
+            T value{};
+            buffer >> value;
+            distribution = std::unique_ptr<Distribution<T>>(new ConstDistribution<T>(value));
+            break;
+        }
+        case DistributionType::Range: {
+            T min{};
+            T max{};
+            buffer >> min >> max;
+            distribution = std::unique_ptr<Distribution<T>>(new RangeDistribution<T>(min, max));
+            break;
+        }
+        case DistributionType::Curve:
+            if constexpr (std::is_integral_v<T>) {
+                throw std::runtime_error("Curve distribution of integral type is not supported!");
+            } else {
+                typename CurveDistribution<T>::Interpolation interpolation {};
+                std::vector<typename CurveDistribution<T>::Key> keys;
+                buffer >> interpolation >> keys;
+                distribution = std::unique_ptr<Distribution<T>>(new CurveDistribution<T>(std::move(keys), interpolation));
+            }
+            break;
+    }
 
     return distribution;
 }
@@ -0,0 +1,248 @@
+#include <limitless/util/triangle_bvh.hpp>
+#include <limitless/util/bounding_box.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+using namespace Limitless;
+
+namespace {
+    constexpr uint32_t SAH_BINS = 12;
+
+    struct Bounds {
+        glm::vec3 min {std::numeric_limits<float>::max()};
+        glm::vec3 max {std::numeric_limits<float>::lowest()};
+
+        void grow(const glm::vec3& point) noexcept {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        void grow(const Bounds& bounds) noexcept {
+            min = glm::min(min, bounds.min);
+            max = glm::max(max, bounds.max);
+        }
+
+        [[nodiscard]] float area() const noexcept {
+            const auto d = max - min;
+            return d.x < 0.0f ? 0.0f : d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+    };
+}
+
+std::optional<TriangleHit> Limitless::intersectTriangle(const glm::vec3& origin, const glm::vec3& direction,
+                                                        const glm::vec3& a, const glm::vec3& b, const glm::vec3& c,
+                                                        float max_distance) noexcept {
+    constexpr auto EPSILON = 1e-8f;
+
+    const auto e1 = b - a;
+    const auto e2 = c - a;
+    const auto p = glm::cross(direction, e2);
+    const auto determinant = glm::dot(e1, p);
+
+    if (std::abs(determinant) < EPSILON) {
+        return std::nullopt;
+    }
+
+    const auto inverse = 1.0f / determinant;
+    const auto s = origin - a;
+    const auto u = glm::dot(s, p) * inverse;
+    if (u < 0.0f || u > 1.0f) {
+        return std::nullopt;
+    }
+
+    const auto q = glm::cross(s, e1);
+    const auto v = glm::dot(direction, q) * inverse;
+    if (v < 0.0f || u + v > 1.0f) {
+        return std::nullopt;
+    }
+
+    const auto distance = glm::dot(e2, q) * inverse;
+    if (distance < 0.0f || distance > max_distance) {
+        return std::nullopt;
+    }
+
+    return TriangleHit{0, distance, {u, v}};
+}
+
+TriangleBVH::TriangleBVH(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices) {
+    const auto count = static_cast<uint32_t>(indices.size() / 3);
+
+    triangles.reserve(count);
+    std::vector<glm::vec3> centroids;
+    centroids.reserve(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto& a = positions[indices[i * 3 + 0]];
+        const auto& b = positions[indices[i * 3 + 1]];
+        const auto& c = positions[indices[i * 3 + 2]];
+
+        triangles.push_back({a, b, c, i});
+        centroids.push_back((a + b + c) / 3.0f);
+    }
+
+    if (count != 0) {
+        // binary tree with leaves of at least one triangle
+        nodes.reserve(2 * count);
+        build(centroids, 0, count);
+    }
+}
+
+uint32_t TriangleBVH::build(std::vector<glm::vec3>& centroids, uint32_t begin, uint32_t end) {
+    const auto index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    Bounds bounds;
+    Bounds centroid_bounds;
+    for (auto i = begin; i < end; ++i) {
+        bounds.grow(triangles[i].a);
+        bounds.grow(triangles[i].b);
+        bounds.grow(triangles[i].c);
+        centroid_bounds.grow(centroids[i]);
+    }
+
+    nodes[index].min = bounds.min;
+    nodes[index].max = bounds.max;
+
+    const auto count = end - begin;
+    const auto extent = centroid_bounds.max - centroid_bounds.min;
+    const auto axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+    const auto makeLeaf = [&] () {
+        nodes[index].offset = begin;
+        nodes[index].count = count;
+        return index;
+    };
+
+    if (count <= MAX_LEAF_SIZE || extent[axis] <= 0.0f) {
+        return makeLeaf();
+    }
+
+    // centroids are binned along the widest axis and split is placed at the cheapest bin boundary
+    const auto bin = [&] (uint32_t i) {
+        const auto b = static_cast<uint32_t>((centroids[i][axis] - centroid_bounds.min[axis]) / extent[axis] * SAH_BINS);
+        return std::min(b, SAH_BINS - 1);
+    };
+
+    std::array<Bounds, SAH_BINS> bins {};
+    std::array<uint32_t, SAH_BINS> bin_counts {};
+    for (auto i = begin; i < end; ++i) {
+        const auto b = bin(i);
+        bins[b].grow(triangles[i].a);
+        bins[b].grow(triangles[i].b);
+        bins[b].grow(triangles[i].c);
+        ++bin_counts[b];
+    }
+
+    std::array<float, SAH_BINS - 1> costs {};
+    {
+        Bounds left;
+        uint32_t left_count = 0;
+        for (uint32_t i = 0; i < SAH_BINS - 1; ++i) {
+            left.grow(bins[i]);
+            left_count += bin_counts[i];
+            costs[i] = left.area() * static_cast<float>(left_count);
+        }
+
+        Bounds right;
+        uint32_t right_count = 0;
+        for (auto i = SAH_BINS - 1; i > 0; --i) {
+            right.grow(bins[i]);
+            right_count += bin_counts[i];
+            costs[i - 1] += right.area() * static_cast<float>(right_count);
+        }
+    }
+
+    const auto split = static_cast<uint32_t>(std::min_element(costs.begin(), costs.end()) - costs.begin());
+
+    // splitting pays off only if it is cheaper than testing every triangle of node
+    if (count <= 16 && costs[split] >= bounds.area() * static_cast<float>(count)) {
+        return makeLeaf();
+    }
+
+    auto middle = begin;
+    for (auto i = begin; i < end; ++i) {
+        if (bin(i) <= split) {
+            std::swap(triangles[i], triangles[middle]);
+            std::swap(centroids[i], centroids[middle]);
+            ++middle;
+        }
+    }
+
+    if (middle == begin || middle == end) {
+        middle = begin + count / 2;
+    }
+
+    build(centroids, begin, middle);
+    const auto right = build(centroids, middle, end);
+    nodes[index].offset = right;
+
+    return index;
+}
+
+std::optional<TriangleHit> TriangleBVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const {
+    if (nodes.empty()) {
+        return std::nullopt;
+    }
+
+    const auto inverse_direction = 1.0f / direction;
+
+    std::optional<TriangleHit> hit;
+
+    struct Entry {
+        uint32_t node;
+        float distance;
+    };
+
+    std::vector<Entry> stack;
+    stack.reserve(64);
+
+    if (const auto distance = intersectRayBox(nodes[0].min, nodes[0].max, origin, inverse_direction, max_distance); distance <= max_distance) {
+        stack.push_back({0, distance});
+    }
+
+    while (!stack.empty()) {
+        const auto entry = stack.back();
+        stack.pop_back();
+
+        // ray could be shortened by hits found after node was pushed
+        if (entry.distance > max_distance) {
+            continue;
+        }
+
+        const auto& node = nodes[entry.node];
+
+        if (node.count != 0) {
+            for (auto i = node.offset; i < node.offset + node.count; ++i) {
+                const auto& triangle = triangles[i];
+                if (auto result = intersectTriangle(origin, direction, triangle.a, triangle.b, triangle.c, max_distance); result) {
+                    result->triangle = triangle.id;
+                    max_distance = result->distance;
+                    hit = result;
+                }
+            }
+            continue;
+        }
+
+        auto near = Entry {entry.node + 1, 0.0f};
+        auto far = Entry {node.offset, 0.0f};
+        near.distance = intersectRayBox(nodes[near.node].min, nodes[near.node].max, origin, inverse_direction, max_distance);
+        far.distance = intersectRayBox(nodes[far.node].min, nodes[far.node].max, origin, inverse_direction, max_distance);
+
+        if (far.distance < near.distance) {
+            std::swap(near, far);
+        }
+
+        // nearer child is popped first
+        if (far.distance <= max_distance) {
+            stack.push_back(far);
+        }
+        if (near.distance <= max_distance) {
+            stack.push_back(near);
+        }
+    }
+
+    return hit;
+}
@@ -0,0 +1,73 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/util/alias_table.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace Limitless;
+
+TEST_CASE("AliasTable samples proportionally to weights") {
+    const std::vector<float> weights = {1.0f, 0.0f, 3.0f, 4.0f};
+    AliasTable table {weights.data(), weights.size()};
+
+    REQUIRE(table.size() == 4);
+    REQUIRE(table.getTotal() == Catch::Approx(8.0));
+
+    Xoshiro128 generator {42};
+    std::vector<size_t> hits(weights.size());
+    constexpr size_t COUNT = 80'000;
+    for (size_t i = 0; i < COUNT; ++i) {
+        ++hits[table.sample(generator)];
+    }
+
+    REQUIRE(hits[1] == 0);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        REQUIRE(static_cast<double>(hits[i]) / COUNT == Catch::Approx(weights[i] / 8.0).margin(0.01));
+    }
+}
+
+TEST_CASE("AliasTable with zero weights is uniform") {
+    const std::vector<float> weights(4, 0.0f);
+    AliasTable table {weights.data(), weights.size()};
+
+    Xoshiro128 generator {42};
+    std::vector<size_t> hits(weights.size());
+    for (size_t i = 0; i < 4'000; ++i) {
+        ++hits[table.sample(generator)];
+    }
+
+    REQUIRE(std::all_of(hits.begin(), hits.end(), [] (size_t hit) { return hit > 900; }));
+}
+
+TEST_CASE("AliasTable sampling benchmark", "[!benchmark]") {
+    // triangle count of typical character mesh
+    constexpr size_t TRIANGLES = 20'000;
+    constexpr size_t SAMPLES = 10'000;
+
+    std::vector<float> weights(TRIANGLES);
+    Xoshiro128 generator {42};
+    generator.fill(weights.data(), weights.size());
+
+    std::vector<float> cumulative(TRIANGLES);
+    std::partial_sum(weights.begin(), weights.end(), cumulative.begin());
+
+    AliasTable table {weights.data(), weights.size()};
+    std::vector<uint32_t> picked(SAMPLES);
+
+    BENCHMARK("cumulative binary search 10k") {
+        for (auto& pick : picked) {
+            const auto value = generator.nextFloat() * cumulative.back();
+            pick = static_cast<uint32_t>(std::upper_bound(cumulative.begin(), cumulative.end(), value) - cumulative.begin());
+        }
+        return picked.back();
+    };
+
+    BENCHMARK("alias table 10k") {
+        for (auto& pick : picked) {
+            pick = table.sample(generator);
+        }
+        return picked.back();
+    };
+}
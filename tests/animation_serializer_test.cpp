@@ -0,0 +1,97 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/models/skeletal_model.hpp>
+#include <limitless/serialization/animation_serializer.hpp>
+#include <limitless/util/bytebuffer.hpp>
+#include <limitless/util/random.hpp>
+
+using namespace Limitless;
+
+TEST_CASE("KeyTrack drops keys that interpolation reproduces") {
+    std::vector<KeyFrame<glm::vec3>> line;
+    std::vector<KeyFrame<glm::vec3>> constant;
+    for (uint32_t i = 0; i <= 100; ++i) {
+        line.emplace_back(glm::vec3{static_cast<float>(i), 2.0f * static_cast<float>(i), 0.0f}, i);
+        constant.emplace_back(glm::vec3{1.0f}, i);
+    }
+    // corner in the middle of line
+    line[50].data.z = 1.0f;
+
+    const KeyTrack<glm::vec3> line_track {line, 1e-4f};
+    REQUIRE(line_track.size() == 5);
+    REQUIRE(line_track.times[2] == 50.0f);
+
+    const KeyTrack<glm::vec3> constant_track {constant, 1e-4f};
+    REQUIRE(constant_track.size() == 1);
+    REQUIRE(constant_track.value(0) == glm::vec3{1.0f});
+}
+
+TEST_CASE("KeyTrack packs keys within quantization error") {
+    Xoshiro128 generator {3};
+    const auto random = [&] { return static_cast<float>(generator()) / static_cast<float>(std::numeric_limits<uint32_t>::max()) * 2.0f - 1.0f; };
+
+    std::vector<KeyFrame<glm::fquat>> rotations;
+    std::vector<KeyFrame<glm::vec3>> positions;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        rotations.emplace_back(glm::normalize(glm::fquat{random(), random(), random(), random()}), i);
+        positions.emplace_back(glm::vec3{random(), random(), random()} * 50.0f, i);
+    }
+
+    // random keys are not reduced
+    const KeyTrack<glm::fquat> rotation_track {rotations};
+    const KeyTrack<glm::vec3> position_track {positions};
+    REQUIRE(rotation_track.size() == rotations.size());
+    REQUIRE(position_track.size() == positions.size());
+
+    for (size_t i = 0; i < rotations.size(); ++i) {
+        const auto expected = rotations[i].data;
+        const auto actual = rotation_track.value(i);
+        REQUIRE(glm::abs(glm::dot(expected, actual)) == Catch::Approx(1.0f).margin(1e-6));
+
+        for (glm::length_t c = 0; c < 3; ++c) {
+            REQUIRE(position_track.value(i)[c] == Catch::Approx(positions[i].data[c]).margin(100.0f / 65535.0f));
+        }
+    }
+}
+
+TEST_CASE("AnimationSerializer restores compressed animation") {
+    std::vector<KeyFrame<glm::vec3>> positions;
+    std::vector<KeyFrame<glm::fquat>> rotations;
+    for (uint32_t i = 0; i <= 10; ++i) {
+        positions.emplace_back(glm::vec3{0.0f, static_cast<float>(i * i), 0.0f}, i);
+        rotations.emplace_back(glm::angleAxis(static_cast<float>(i * i) * 0.01f, glm::vec3{0.0f, 1.0f, 0.0f}), i);
+    }
+
+    std::vector<AnimationNode> nodes;
+    nodes.emplace_back(positions, rotations, std::vector<KeyFrame<glm::vec3>>{}, 3);
+    const Animation animation {"jump", 10.0, 24.0, std::move(nodes)};
+
+    AnimationSerializer serializer;
+    auto buffer = serializer.serialize(animation);
+    const auto restored = serializer.deserialize(buffer);
+
+    REQUIRE(buffer.size() == 0);
+    REQUIRE(restored.name == "jump");
+    REQUIRE(restored.duration == 10.0);
+    REQUIRE(restored.tps == 24.0);
+    REQUIRE(restored.findChannel(3) == &restored.nodes[0]);
+
+    const auto& original = animation.nodes[0];
+    const auto& node = restored.nodes[0];
+    REQUIRE(node.positions.keys == original.positions.keys);
+    REQUIRE(node.rotations.keys == original.rotations.keys);
+    REQUIRE(node.scales.empty());
+
+    for (const double time : {0.0, 2.5, 7.75, 10.0}) {
+        REQUIRE(node.positionLerp(time) == original.positionLerp(time));
+        REQUIRE(node.rotationLerp(time) == original.rotationLerp(time));
+    }
+}
+
+TEST_CASE("AnimationSerializer rejects wrong version") {
+    ByteBuffer buffer;
+    buffer << uint8_t{0xFF};
+
+    AnimationSerializer serializer;
+    REQUIRE_THROWS(serializer.deserialize(buffer));
+}
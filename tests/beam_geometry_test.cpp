@@ -0,0 +1,196 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/fx/beam_geometry.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+
+using namespace Limitless;
+using namespace Limitless::fx;
+
+namespace {
+    const auto PROJECTION = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    const auto VIEW = glm::lookAt(glm::vec3{0.0f, 2.0f, 10.0f}, glm::vec3{0.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    const auto RESOLUTION = glm::vec2{1920.0f, 1080.0f};
+
+    // previous implementation: recursive generation, sort by distance and per vertex projection
+    void legacyGenerate(std::vector<glm::vec3>& line, float offset, glm::vec3 source, glm::vec3 dest, float distance, Xoshiro128& generator) {
+        if (distance < offset) {
+            line.emplace_back(source);
+            line.emplace_back(dest);
+        } else {
+            glm::vec3 center = (source + dest) * 0.5f;
+            const auto uni = [&] () { return (generator.nextFloat() * 2.0f - 1.0f) * distance; };
+            center += glm::vec3{uni(), uni(), uni()};
+
+            legacyGenerate(line, offset, source, center, distance * 0.5f, generator);
+            legacyGenerate(line, offset, dest, center, distance * 0.5f, generator);
+        }
+    }
+
+    void legacyLine(std::vector<glm::vec3>& line, const glm::vec3& source, const glm::vec3& target, float displacement, float offset, Xoshiro128& generator) {
+        line.clear();
+        legacyGenerate(line, offset, source, target, displacement, generator);
+
+        std::sort(line.begin(), line.end(), [&](const auto& a, const auto& b) {
+            return glm::distance(source, a) < glm::distance(source, b);
+        });
+        line.erase(std::unique(line.begin(), line.end()), line.end());
+
+        line.emplace_back(line[0]);
+        line.insert(line.begin(), line[line.size() - 2]);
+    }
+
+    void legacyVertices(const std::vector<glm::vec3>& line, float size, std::vector<BeamVertex>& vertices) {
+        constexpr auto DOT_PRODUCT_RANGE = glm::vec2(0.2f, 0.8f);
+        const auto resolution = RESOLUTION;
+
+        for (uint32_t i = 0; i < 6 * (line.size() - 2 - 1); ++i) {
+            int line_i = i / 6;
+            int tri_i = i % 6;
+
+            glm::vec4 va[4];
+            const auto VP = PROJECTION * VIEW;
+            for (uint32_t k = 0; k < 4; ++k) {
+                va[k] = VP * glm::vec4(line.at(line_i + k), 1.0f);
+                va[k].x /= va[k].w;
+                va[k].y /= va[k].w;
+                va[k].z /= va[k].w;
+
+                va[k].x = ((glm::vec2(va[k]) + 1.0f) * 0.5f * resolution).x;
+                va[k].y = ((glm::vec2(va[k]) + 1.0f) * 0.5f * resolution).y;
+            }
+
+            glm::vec2 v_line = glm::normalize(glm::vec2(va[2]) - glm::vec2(va[1]));
+            glm::vec2 nv_line = glm::vec2(-v_line.y, v_line.x);
+
+            glm::vec4 pos;
+            if (tri_i == 0 || tri_i == 1 || tri_i == 3) {
+                glm::vec2 v_pred = glm::normalize(glm::vec2(va[1]) - glm::vec2(va[0]));
+                glm::vec2 v_miter = glm::normalize(nv_line + glm::vec2(-v_pred.y, v_pred.x));
+
+                pos = va[1];
+                auto dot = glm::clamp(glm::dot(v_miter, nv_line), DOT_PRODUCT_RANGE.x, DOT_PRODUCT_RANGE.y);
+                pos.x += (v_miter * size / pos.w * (tri_i == 1 ? -0.5f : 0.5f) / dot).x;
+                pos.y += (v_miter * size / pos.w * (tri_i == 1 ? -0.5f : 0.5f) / dot).y;
+            } else {
+                glm::vec2 v_succ = glm::normalize(glm::vec2(va[3]) - glm::vec2(va[2]));
+                glm::vec2 v_miter = glm::normalize(nv_line + glm::vec2(-v_succ.y, v_succ.x));
+
+                pos = va[2];
+                auto dot = glm::clamp(glm::dot(v_miter, nv_line), DOT_PRODUCT_RANGE.x, DOT_PRODUCT_RANGE.y);
+                pos.x += (v_miter * size / pos.w * (tri_i == 5 ? 0.5f : -0.5f) / dot).x;
+                pos.y += (v_miter * size / pos.w * (tri_i == 5 ? 0.5f : -0.5f) / dot).y;
+            }
+
+            pos.x = (glm::vec2(pos) / resolution * 2.0f - 1.0f).x;
+            pos.y = (glm::vec2(pos) / resolution * 2.0f - 1.0f).y;
+
+            pos.x *= pos.w;
+            pos.y *= pos.w;
+            pos.z *= pos.w;
+
+            pos = glm::inverse(PROJECTION * VIEW) * pos;
+
+            vertices.push_back({pos, glm::vec2{0.0f}});
+        }
+    }
+}
+
+TEST_CASE("Beam line is ordered and padded") {
+    Xoshiro128 generator {42};
+    std::vector<glm::vec3> line;
+
+    const auto source = glm::vec3{0.0f};
+    const auto target = glm::vec3{4.0f, 0.0f, 0.0f};
+
+    // 0.5, 0.25, 0.125 are subdivided
+    generateBeamLine(line, source, target, 0.5f, 0.1f, generator);
+
+    REQUIRE(line.size() == 8 + 3);
+    REQUIRE(line[1] == source);
+    REQUIRE(line[9] == target);
+    REQUIRE(line.front() == target);
+    REQUIRE(line.back() == source);
+
+    // displacement sums to less than 1, so points keep their order along the beam
+    for (size_t i = 2; i < 10; ++i) {
+        REQUIRE(line[i].x > line[i - 1].x);
+    }
+
+    generateBeamLine(line, source, target, 0.05f, 0.1f, generator);
+    REQUIRE(line.size() == 4);
+    REQUIRE(getBeamVertexCount(line.size()) == 6);
+
+    // subdivision is bounded for non positive offset
+    generateBeamLine(line, source, target, 0.5f, 0.0f, generator);
+    REQUIRE(line.size() == (size_t{1} << MAX_BEAM_LEVELS) + 3);
+}
+
+TEST_CASE("Beam vertices match per vertex projection") {
+    Xoshiro128 generator {42};
+    std::vector<glm::vec3> line;
+    generateBeamLine(line, glm::vec3{-2.0f, 0.0f, 0.0f}, glm::vec3{2.0f, 1.0f, 0.0f}, 0.5f, 0.1f, generator);
+
+    const BeamFrame frame {PROJECTION, VIEW, RESOLUTION};
+    std::vector<glm::vec4> screen;
+    std::vector<BeamVertex> vertices(getBeamVertexCount(line.size()));
+    generateBeamVertices(frame, line, 10.0f, screen, vertices.data());
+
+    std::vector<BeamVertex> expected;
+    legacyVertices(line, 10.0f, expected);
+
+    REQUIRE(vertices.size() == expected.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        REQUIRE(vertices[i].position.x == Catch::Approx(expected[i].position.x).margin(1e-3));
+        REQUIRE(vertices[i].position.y == Catch::Approx(expected[i].position.y).margin(1e-3));
+        REQUIRE(vertices[i].position.z == Catch::Approx(expected[i].position.z).margin(1e-3));
+    }
+}
+
+TEST_CASE("Beam geometry benchmark", "[!benchmark]") {
+    constexpr size_t BEAMS = 1'000;
+    constexpr float SIZE = 10.0f;
+
+    std::vector<glm::vec3> sources(BEAMS);
+    Xoshiro128 generator {42};
+    for (auto& source : sources) {
+        source = glm::vec3{generator.nextFloat(), generator.nextFloat(), generator.nextFloat()} * 4.0f - 2.0f;
+    }
+    const auto target = glm::vec3{0.0f, 3.0f, 0.0f};
+
+    BENCHMARK_ADVANCED("legacy 1k beams")(Catch::Benchmark::Chronometer meter) {
+        std::vector<std::vector<glm::vec3>> lines(BEAMS);
+        std::vector<BeamVertex> vertices;
+        meter.measure([&] {
+            vertices.clear();
+            for (size_t i = 0; i < BEAMS; ++i) {
+                legacyLine(lines[i], sources[i], target, 0.5f, 0.1f, generator);
+                legacyVertices(lines[i], SIZE, vertices);
+            }
+            return vertices.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED("cached frame 1k beams")(Catch::Benchmark::Chronometer meter) {
+        std::vector<std::vector<glm::vec3>> lines(BEAMS);
+        std::vector<glm::vec4> screen;
+        std::vector<BeamVertex> vertices;
+        meter.measure([&] {
+            const BeamFrame frame {PROJECTION, VIEW, RESOLUTION};
+            size_t total = 0;
+            for (size_t i = 0; i < BEAMS; ++i) {
+                generateBeamLine(lines[i], sources[i], target, 0.5f, 0.1f, generator);
+                total += getBeamVertexCount(lines[i].size());
+            }
+
+            vertices.resize(total);
+            size_t offset = 0;
+            for (const auto& line : lines) {
+                generateBeamVertices(frame, line, SIZE, screen, vertices.data() + offset);
+                offset += getBeamVertexCount(line.size());
+            }
+            return vertices.size();
+        });
+    };
+}
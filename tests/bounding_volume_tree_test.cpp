@@ -0,0 +1,183 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/util/bounding_volume_tree.hpp>
+#include <limitless/util/random.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace Limitless;
+
+namespace {
+    using Tree = BoundingVolumeTree<uint32_t>;
+
+    BoundingBox randomBox(Xoshiro128& generator, float extent) {
+        const auto center = glm::vec3{generator.nextFloat(), generator.nextFloat(), generator.nextFloat()} * extent * 2.0f - extent;
+        const auto size = glm::vec3{generator.nextFloat(), generator.nextFloat(), generator.nextFloat()} * 2.0f + 0.1f;
+        return { center, size };
+    }
+
+    bool overlaps(const BoundingBox& a, const BoundingBox& b) {
+        return glm::all(glm::lessThanEqual(glm::abs(a.center - b.center), (a.size + b.size) / 2.0f));
+    }
+
+    template<typename Query>
+    std::vector<uint32_t> collect(Query&& query) {
+        std::vector<uint32_t> result;
+        query([&] (uint32_t data) { result.push_back(data); });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    struct Fixture {
+        Tree tree;
+        std::vector<Tree::Proxy> proxies;
+        std::vector<bool> alive;
+        Xoshiro128 generator {42};
+
+        explicit Fixture(uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i) {
+                proxies.push_back(tree.insert(randomBox(generator, 100.0f), i));
+                alive.push_back(true);
+            }
+        }
+
+        // brute force over fat boxes, which is what tree stores
+        template<typename Test>
+        std::vector<uint32_t> expected(Test&& test) const {
+            std::vector<uint32_t> result;
+            for (uint32_t i = 0; i < proxies.size(); ++i) {
+                if (alive[i] && test(tree.getFatBox(proxies[i]))) {
+                    result.push_back(i);
+                }
+            }
+            return result;
+        }
+    };
+}
+
+TEST_CASE("BoundingVolumeTree queries match brute force") {
+    Fixture fixture {2'000};
+    auto& tree = fixture.tree;
+    auto& generator = fixture.generator;
+
+    // moves, including ones leaving fat boxes, and removals
+    for (uint32_t i = 0; i < 2'000; i += 3) {
+        auto box = tree.getFatBox(fixture.proxies[i]);
+        box.center += glm::vec3{generator.nextFloat() * 10.0f};
+        box.size = glm::vec3{1.0f};
+        tree.move(fixture.proxies[i], box);
+    }
+    for (uint32_t i = 0; i < 2'000; i += 7) {
+        tree.remove(fixture.proxies[i]);
+        fixture.alive[i] = false;
+    }
+
+    REQUIRE(tree.size() == static_cast<size_t>(std::count(fixture.alive.begin(), fixture.alive.end(), true)));
+    // balanced tree height is logarithmic
+    REQUIRE(tree.getHeight() < 4 * std::log2(tree.size()));
+
+    SECTION("box") {
+        const BoundingBox query {glm::vec3{10.0f, -5.0f, 3.0f}, glm::vec3{40.0f}};
+        REQUIRE(collect([&] (auto&& f) { tree.query(query, f); }) == fixture.expected([&] (const BoundingBox& box) { return overlaps(box, query); }));
+    }
+
+    SECTION("sphere") {
+        const auto center = glm::vec3{-20.0f, 10.0f, 0.0f};
+        const auto radius = 25.0f;
+        const auto expected = fixture.expected([&] (const BoundingBox& box) {
+            const auto closest = glm::clamp(center, box.center - box.size / 2.0f, box.center + box.size / 2.0f);
+            return glm::length(closest - center) <= radius;
+        });
+        REQUIRE(collect([&] (auto&& f) { tree.query(center, radius, f); }) == expected);
+    }
+
+    SECTION("frustum") {
+        const auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 80.0f);
+        const auto view = glm::lookAt(glm::vec3{0.0f, 0.0f, 120.0f}, glm::vec3{0.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+        const Frustum frustum {projection * view};
+
+        const auto expected = fixture.expected([&] (const BoundingBox& box) { return frustum.intersects(box); });
+        REQUIRE(!expected.empty());
+        REQUIRE(collect([&] (auto&& f) { tree.query(frustum, f); }) == expected);
+    }
+
+    SECTION("raycast reports nearest box first") {
+        // aimed through one of the boxes
+        const auto target = tree.getFatBox(fixture.proxies[1]).center;
+        const auto origin = glm::vec3{-150.0f, target.y, target.z};
+        const auto direction = glm::vec3{1.0f, 0.0f, 0.0f};
+
+        std::vector<float> distances;
+        tree.raycast(origin, direction, 1000.0f, [&] (uint32_t, float distance) {
+            distances.push_back(distance);
+            return 1000.0f;
+        });
+        const auto hits = fixture.expected([&] (const BoundingBox& box) {
+            return std::abs(box.center.y - origin.y) <= box.size.y / 2.0f && std::abs(box.center.z - origin.z) <= box.size.z / 2.0f;
+        });
+        REQUIRE(!hits.empty());
+        REQUIRE(distances.size() == hits.size());
+    }
+}
+
+TEST_CASE("BoundingVolumeTree raycast visits nearer boxes first") {
+    Tree tree {0.0f};
+    for (uint32_t i = 0; i < 16; ++i) {
+        tree.insert({glm::vec3{static_cast<float>(15 - i) * 4.0f, 0.0f, 0.0f}, glm::vec3{1.0f}}, 15 - i);
+    }
+
+    // clipping ray at first hit prunes every farther box
+    std::vector<uint32_t> hits;
+    tree.raycast(glm::vec3{-10.0f, 0.0f, 0.0f}, glm::vec3{1.0f, 0.0f, 0.0f}, 1000.0f, [&] (uint32_t data, float distance) {
+        hits.push_back(data);
+        return distance;
+    });
+
+    REQUIRE(hits == std::vector<uint32_t>{0});
+}
+
+TEST_CASE("BoundingVolumeTree moving inside of fat box keeps leaf") {
+    Tree tree {0.5f};
+    const auto proxy = tree.insert({glm::vec3{0.0f}, glm::vec3{1.0f}}, 0);
+
+    REQUIRE_FALSE(tree.move(proxy, {glm::vec3{0.25f, 0.0f, 0.0f}, glm::vec3{1.0f}}));
+    REQUIRE(tree.move(proxy, {glm::vec3{2.0f, 0.0f, 0.0f}, glm::vec3{1.0f}}));
+    REQUIRE(tree.getFatBox(proxy).center.x == Catch::Approx(2.0f));
+}
+
+TEST_CASE("BoundingVolumeTree frustum query benchmark", "[!benchmark]") {
+    constexpr uint32_t COUNT = 50'000;
+
+    Xoshiro128 generator {42};
+    std::vector<BoundingBox> boxes;
+    Tree tree;
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        boxes.push_back(randomBox(generator, 1000.0f));
+        tree.insert(boxes.back(), i);
+    }
+
+    const auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+    const auto view = glm::lookAt(glm::vec3{0.0f}, glm::vec3{1.0f, 0.0f, 0.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    const Frustum frustum {projection * view};
+
+    std::vector<uint32_t> visible;
+    visible.reserve(COUNT);
+
+    BENCHMARK("linear scan 50k") {
+        visible.clear();
+        for (uint32_t i = 0; i < COUNT; ++i) {
+            if (frustum.intersects(boxes[i])) {
+                visible.push_back(i);
+            }
+        }
+        return visible.size();
+    };
+
+    BENCHMARK("tree query 50k") {
+        visible.clear();
+        tree.query(frustum, [&] (uint32_t i) { visible.push_back(i); });
+        return visible.size();
+    };
+}
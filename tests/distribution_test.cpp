@@ -0,0 +1,148 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/fx/modules/distribution.h>
+#include <limitless/serialization/distribution_serializer.hpp>
+#include <limitless/util/bytebuffer.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace Limitless;
+
+TEST_CASE("RangeDistribution fill stays in range") {
+    RangeDistribution<glm::vec3> distribution {glm::vec3{-1.0f, 0.0f, 2.0f}, glm::vec3{1.0f, 0.5f, 4.0f}};
+
+    std::vector<glm::vec3> values(1000);
+    distribution.fill(values.data(), values.size());
+
+    for (const auto& value : values) {
+        REQUIRE((value.x >= -1.0f && value.x < 1.0f));
+        REQUIRE((value.y >= 0.0f && value.y < 0.5f));
+        REQUIRE((value.z >= 2.0f && value.z < 4.0f));
+    }
+}
+
+TEST_CASE("RangeDistribution integral range is inclusive") {
+    RangeDistribution<uint32_t> distribution {1, 3};
+
+    std::vector<uint32_t> values(1000);
+    distribution.fill(values.data(), values.size());
+
+    for (const auto value : values) {
+        REQUIRE((value >= 1 && value <= 3));
+    }
+
+    REQUIRE(std::find(values.begin(), values.end(), 1) != values.end());
+    REQUIRE(std::find(values.begin(), values.end(), 3) != values.end());
+}
+
+TEST_CASE("RangeDistribution seed reproduces sequence") {
+    RangeDistribution<float> first {0.0f, 1.0f};
+    RangeDistribution<float> second {0.0f, 1.0f};
+
+    first.seed(42);
+    second.seed(42);
+
+    std::vector<float> a(64);
+    std::vector<float> b(64);
+    first.fill(a.data(), a.size());
+    second.fill(b.data(), b.size());
+    REQUIRE(a == b);
+
+    REQUIRE(first.get() == second.get());
+}
+
+TEST_CASE("ConstDistribution fill") {
+    ConstDistribution<float> distribution {3.0f};
+
+    std::vector<float> values(16);
+    distribution.fill(values.data(), values.size());
+
+    REQUIRE(std::all_of(values.begin(), values.end(), [] (float value) { return value == 3.0f; }));
+}
+
+TEST_CASE("CurveDistribution linear evaluation") {
+    using Curve = CurveDistribution<float>;
+    Curve curve {{{1.0f, 0.0f}, {0.0f, 2.0f}, {0.5f, 4.0f}}};
+
+    REQUIRE(curve.getKeys().front().time == 0.0f);
+    REQUIRE(curve.get() == 2.0f);
+    REQUIRE(curve.evaluate(0.0f) == Catch::Approx(2.0f));
+    REQUIRE(curve.evaluate(0.25f) == Catch::Approx(3.0f).margin(0.05f));
+    REQUIRE(curve.evaluate(1.0f) == Catch::Approx(0.0f));
+
+    // out of range time is clamped
+    REQUIRE(curve.evaluate(-1.0f) == Catch::Approx(2.0f));
+    REQUIRE(curve.evaluate(2.0f) == Catch::Approx(0.0f));
+}
+
+TEST_CASE("CurveDistribution hermite passes through keys") {
+    using Curve = CurveDistribution<glm::vec3>;
+    Curve curve {{{0.0f, glm::vec3{0.0f}}, {0.5f, glm::vec3{1.0f}}, {1.0f, glm::vec3{0.0f}}}, Curve::Interpolation::Hermite};
+
+    REQUIRE(curve.evaluate(0.0f).x == Catch::Approx(0.0f));
+    REQUIRE(curve.evaluate(0.5f).x == Catch::Approx(1.0f).margin(0.01f));
+    REQUIRE(curve.evaluate(1.0f).x == Catch::Approx(0.0f));
+    REQUIRE(curve.evaluate(0.25f).x > 0.5f);
+}
+
+TEST_CASE("CurveDistribution requires keys") {
+    REQUIRE_THROWS(CurveDistribution<float>{{}});
+}
+
+TEST_CASE("Distribution serialization") {
+    using Curve = CurveDistribution<glm::vec4>;
+
+    ByteBuffer buffer;
+    buffer << static_cast<const Distribution<float>&>(ConstDistribution<float>{2.0f})
+           << static_cast<const Distribution<float>&>(RangeDistribution<float>{1.0f, 3.0f})
+           << static_cast<const Distribution<glm::vec4>&>(Curve{{{0.0f, glm::vec4{1.0f}}, {1.0f, glm::vec4{0.0f}}}, Curve::Interpolation::Hermite});
+
+    std::unique_ptr<Distribution<float>> constant;
+    std::unique_ptr<Distribution<float>> range;
+    std::unique_ptr<Distribution<glm::vec4>> curve;
+    buffer >> constant >> range >> curve;
+
+    REQUIRE(constant->getType() == DistributionType::Const);
+    REQUIRE(constant->get() == 2.0f);
+
+    REQUIRE(range->getType() == DistributionType::Range);
+    REQUIRE(static_cast<RangeDistribution<float>&>(*range).getMin() == 1.0f);
+    REQUIRE(static_cast<RangeDistribution<float>&>(*range).getMax() == 3.0f);
+
+    REQUIRE(curve->getType() == DistributionType::Curve);
+    const auto& deserialized = static_cast<Curve&>(*curve);
+    REQUIRE(deserialized.getInterpolation() == Curve::Interpolation::Hermite);
+    REQUIRE(deserialized.getKeys().size() == 2);
+    REQUIRE(deserialized.evaluate(1.0f).x == Catch::Approx(0.0f));
+}
+
+TEST_CASE("Distribution sampling benchmark", "[!benchmark]") {
+    constexpr size_t COUNT = 100'000;
+    std::vector<glm::vec4> values(COUNT);
+
+    // previous implementation: std engine and distribution behind virtual call per sample
+    BENCHMARK("std engine per sample 100k") {
+        std::default_random_engine generator {42};
+        std::uniform_real_distribution<float> distribution {0.0f, 1.0f};
+        for (auto& value : values) {
+            value = {distribution(generator), distribution(generator), distribution(generator), distribution(generator)};
+        }
+        return values.back().x;
+    };
+
+    RangeDistribution<glm::vec4> range {glm::vec4{0.0f}, glm::vec4{1.0f}};
+    Distribution<glm::vec4>& distribution = range;
+
+    BENCHMARK("virtual get 100k") {
+        for (auto& value : values) {
+            value = distribution.get();
+        }
+        return values.back().x;
+    };
+
+    BENCHMARK("fill 100k") {
+        distribution.fill(values.data(), values.size());
+        return values.back().x;
+    };
+}
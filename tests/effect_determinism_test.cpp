@@ -0,0 +1,150 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/core/context.hpp>
+#include <limitless/fx/effect_builder.h>
+#include <limitless/fx/emitters/sprite_emitter.hpp>
+#include <limitless/fx/modules/distribution.h>
+#include <limitless/instances/effect_instance.hpp>
+#include <limitless/ms/material_builder.hpp>
+#include <limitless/models/sphere.hpp>
+#include <limitless/assets.hpp>
+#include <limitless/camera.hpp>
+#include <limitless/scene.hpp>
+
+#include <cstring>
+
+using namespace Limitless;
+using namespace Limitless::fx;
+
+class FakeBackend {
+public:
+    Context ctx;
+
+    FakeBackend() : ctx{"test", {1, 1}, {{WindowHint::Visible, false}}} {
+
+    }
+};
+
+namespace {
+    template<typename T, typename Allocator>
+    void appendBytes(std::vector<unsigned char>& bytes, const std::vector<T, Allocator>& stream) {
+        const auto* data = reinterpret_cast<const unsigned char*>(stream.data());
+        bytes.insert(bytes.end(), data, data + stream.size() * sizeof(T));
+    }
+
+    // raw bytes of every particle stream of every sprite emitter
+    std::vector<unsigned char> collectParticleState(const EffectInstance& effect) {
+        std::vector<unsigned char> bytes;
+        for (const auto& [name, emitter] : effect.getEmitters()) {
+            const auto& particles = static_cast<const SpriteEmitter&>(*emitter).getParticles();
+            appendBytes(bytes, particles.color);
+            appendBytes(bytes, particles.subUV);
+            appendBytes(bytes, particles.properties);
+            appendBytes(bytes, particles.acceleration);
+            appendBytes(bytes, particles.lifetime);
+            appendBytes(bytes, particles.position);
+            appendBytes(bytes, particles.size);
+            appendBytes(bytes, particles.rotation);
+            appendBytes(bytes, particles.time);
+            appendBytes(bytes, particles.velocity);
+            appendBytes(bytes, particles.lifespan);
+        }
+        return bytes;
+    }
+
+    std::shared_ptr<ms::Material> buildMaterial(Assets& assets) {
+        return ms::MaterialBuilder{assets}
+                .setName("material")
+                .add(ms::Property::Color, glm::vec4(1.0f))
+                .setShading(ms::Shading::Unlit)
+                .setBlending(ms::Blending::Additive)
+                .addModelShader(ModelShader::Effect)
+                .build();
+    }
+
+    std::shared_ptr<EffectInstance> buildEffect(Assets& assets) {
+        return EffectBuilder{assets}
+                .create("effect")
+                .createEmitter<SpriteEmitter>("sprites")
+                    .addLifetime(std::make_unique<RangeDistribution<float>>(0.5f, 1.0f))
+                    .addInitialLocation(std::make_unique<RangeDistribution<glm::vec3>>(glm::vec3{-1.0f}, glm::vec3{1.0f}))
+                    .addInitialVelocity(std::make_unique<RangeDistribution<glm::vec3>>(glm::vec3{-2.0f}, glm::vec3{2.0f}))
+                    .addInitialSize(std::make_unique<RangeDistribution<float>>(1.0f, 4.0f))
+                    .addInitialMeshLocation(std::make_shared<Sphere>(glm::uvec2{16, 16}))
+                    .setMaterial(buildMaterial(assets))
+                    .setSpawnMode(EmitterSpawn::Mode::Spray)
+                    .setMaxCount(100)
+                    .setSpawnRate(200.0f)
+                .build();
+    }
+
+    // spawn position comes only from mesh location
+    std::shared_ptr<EffectInstance> buildMeshLocationEffect(Assets& assets) {
+        return EffectBuilder{assets}
+                .create("mesh_location")
+                .createEmitter<SpriteEmitter>("sprites")
+                    .addLifetime(std::make_unique<ConstDistribution<float>>(1.0f))
+                    .addInitialMeshLocation(std::make_shared<Sphere>(glm::uvec2{16, 16}))
+                    .setMaterial(buildMaterial(assets))
+                    .setSpawnMode(EmitterSpawn::Mode::Spray)
+                    .setMaxCount(100)
+                    .setSpawnRate(200.0f)
+                .build();
+    }
+
+    // runs the whole setup from scratch, so nothing is shared between runs except the seed
+    std::vector<unsigned char> simulate(Context& ctx, uint32_t seed, int steps) {
+        setRandomSeed(seed);
+
+        Assets assets {ENGINE_ASSETS_DIR};
+        auto effect = buildEffect(assets);
+
+        Scene scene {ctx};
+        scene.setFixedTimestep(1.0f / 60.0f);
+        auto& instance = scene.add<EffectInstance>(effect, glm::vec3{0.0f});
+
+        Camera camera {glm::uvec2{1, 1}};
+        for (int i = 0; i < steps; ++i) {
+            scene.advance(ctx, camera, 1.0f / 60.0f);
+        }
+
+        return collectParticleState(instance);
+    }
+}
+
+TEST_CASE("Scene advance with the same seed and fixed timestep reproduces particle state bitwise") {
+    FakeBackend fake;
+
+    const auto first = simulate(fake.ctx, 42, 30);
+    const auto second = simulate(fake.ctx, 42, 30);
+
+    REQUIRE_FALSE(first.empty());
+    REQUIRE(first.size() == second.size());
+    REQUIRE(std::memcmp(first.data(), second.data(), first.size()) == 0);
+}
+
+TEST_CASE("copies of effect with mesh location do not repeat spawn positions") {
+    FakeBackend fake;
+
+    setRandomSeed(7);
+
+    Assets assets {ENGINE_ASSETS_DIR};
+    auto effect = buildMeshLocationEffect(assets);
+
+    Scene scene {fake.ctx};
+    scene.setFixedTimestep(1.0f / 60.0f);
+    auto& a = scene.add<EffectInstance>(effect, glm::vec3{0.0f});
+    auto& b = scene.add<EffectInstance>(effect, glm::vec3{0.0f});
+
+    Camera camera {glm::uvec2{1, 1}};
+    for (int i = 0; i < 10; ++i) {
+        scene.advance(fake.ctx, camera, 1.0f / 60.0f);
+    }
+
+    const auto& first = a.get<SpriteEmitter>("sprites").getParticles().position;
+    const auto& second = b.get<SpriteEmitter>("sprites").getParticles().position;
+
+    REQUIRE_FALSE(first.empty());
+    REQUIRE(first.size() == second.size());
+    REQUIRE(std::memcmp(first.data(), second.data(), first.size() * sizeof(glm::vec3)) != 0);
+}
@@ -0,0 +1,42 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/util/frustum.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Limitless;
+
+TEST_CASE("Transformed bounding box encloses rotated box") {
+    const BoundingBox box {glm::vec3{1.0f, 0.0f, 0.0f}, glm::vec3{2.0f, 2.0f, 2.0f}};
+
+    auto matrix = glm::translate(glm::mat4{1.0f}, glm::vec3{10.0f, 0.0f, 0.0f});
+    matrix = glm::rotate(matrix, glm::radians(45.0f), glm::vec3{0.0f, 0.0f, 1.0f});
+    matrix = glm::scale(matrix, glm::vec3{2.0f});
+
+    const auto result = transformBoundingBox(box, matrix);
+
+    const auto diagonal = 4.0f * glm::sqrt(2.0f);
+    REQUIRE(result.center.x == Catch::Approx(10.0f + glm::sqrt(2.0f)));
+    REQUIRE(result.center.y == Catch::Approx(glm::sqrt(2.0f)));
+    REQUIRE(result.size.x == Catch::Approx(diagonal));
+    REQUIRE(result.size.y == Catch::Approx(diagonal));
+    REQUIRE(result.size.z == Catch::Approx(4.0f));
+}
+
+TEST_CASE("Frustum rejects boxes outside of view") {
+    const auto projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+    const auto view = glm::lookAt(glm::vec3{0.0f}, glm::vec3{0.0f, 0.0f, -1.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    const Frustum frustum {projection * view};
+
+    const auto box = [] (const glm::vec3& center) { return BoundingBox{center, glm::vec3{1.0f}}; };
+
+    REQUIRE(frustum.intersects(box({0.0f, 0.0f, -10.0f})));
+    // behind camera
+    REQUIRE_FALSE(frustum.intersects(box({0.0f, 0.0f, 10.0f})));
+    // beyond far plane
+    REQUIRE_FALSE(frustum.intersects(box({0.0f, 0.0f, -120.0f})));
+    // left of 45 degree side plane
+    REQUIRE_FALSE(frustum.intersects(box({-12.0f, 0.0f, -10.0f})));
+    // straddles side plane
+    REQUIRE(frustum.intersects(box({-10.4f, 0.0f, -10.0f})));
+}
@@ -0,0 +1,69 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/pipeline/indirect_command_builder.hpp>
+
+using namespace Limitless;
+
+TEST_CASE("IndirectCommandBuilder merges consecutive draws of one range into instances") {
+    IndirectCommandBuilder builder;
+
+    const GeometryRange tree {0, 300, 0};
+    const GeometryRange rock {300, 90, 120};
+
+    builder.add(tree, 0);
+    builder.add(tree, 1);
+    builder.add(tree, 2);
+    builder.add(rock, 3);
+    builder.add(tree, 4);
+
+    const auto& commands = builder.getCommands();
+    REQUIRE(commands.size() == 3);
+
+    REQUIRE(commands[0].count == 300);
+    REQUIRE(commands[0].instance_count == 3);
+    REQUIRE(commands[0].first_index == 0);
+    REQUIRE(commands[0].base_vertex == 0);
+    REQUIRE(commands[0].base_instance == 0);
+
+    REQUIRE(commands[1].count == 90);
+    REQUIRE(commands[1].instance_count == 1);
+    REQUIRE(commands[1].first_index == 300);
+    REQUIRE(commands[1].base_vertex == 120);
+    REQUIRE(commands[1].base_instance == 3);
+
+    REQUIRE(commands[2].instance_count == 1);
+    REQUIRE(commands[2].base_instance == 4);
+}
+
+TEST_CASE("IndirectCommandBuilder does not merge transforms that are not consecutive") {
+    IndirectCommandBuilder builder;
+
+    const GeometryRange range {0, 36, 0};
+
+    builder.add(range, 0);
+    builder.add(range, 2);
+
+    REQUIRE(builder.size() == 2);
+    REQUIRE(builder.getCommands()[1].base_instance == 2);
+}
+
+TEST_CASE("IndirectCommandBuilder keeps multi draws apart after split") {
+    IndirectCommandBuilder builder;
+
+    const GeometryRange range {0, 36, 0};
+
+    builder.add(range, 0);
+    builder.split();
+    builder.add(range, 1);
+
+    REQUIRE(builder.size() == 2);
+    REQUIRE(builder.getCommands()[0].instance_count == 1);
+    REQUIRE(builder.getCommands()[1].instance_count == 1);
+
+    builder.clear();
+    builder.add(range, 0);
+    builder.add(range, 1);
+
+    REQUIRE(builder.size() == 1);
+    REQUIRE(builder.getCommands()[0].instance_count == 2);
+}
@@ -0,0 +1,59 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/core/mapped_ring_buffer.hpp>
+#include <limitless/core/context.hpp>
+
+using namespace Limitless;
+
+namespace {
+    class FakeBackend {
+    private:
+        Context ctx;
+    public:
+        FakeBackend() : ctx{"test", {1, 1}, {{WindowHint::Visible, false}}} {
+
+        }
+    };
+}
+
+TEST_CASE("MappedRingBuffer cycles regions and grows") {
+    FakeBackend fake;
+
+    MappedRingBuffer<uint32_t> storage {Buffer::Type::ShaderStorage, 4};
+
+    std::vector<const Buffer*> buffers;
+    for (size_t frame = 0; frame < MAPPED_RING_BUFFER_REGIONS * 2; ++frame) {
+        auto* data = storage.map(4);
+        REQUIRE(data != nullptr);
+        REQUIRE(storage.getRegion() == frame % MAPPED_RING_BUFFER_REGIONS);
+
+        // mapped memory is written by CPU directly
+        data[3] = static_cast<uint32_t>(frame);
+        buffers.push_back(storage.getBuffer().get());
+    }
+
+    REQUIRE(buffers[0] != buffers[1]);
+    REQUIRE(buffers[1] != buffers[2]);
+    REQUIRE(buffers[0] == buffers[MAPPED_RING_BUFFER_REGIONS]);
+    REQUIRE(storage.getCapacity() == 4);
+
+    SECTION("storage grows at least twice") {
+        auto* data = storage.map(5);
+        REQUIRE(storage.getCapacity() == 8);
+        REQUIRE(storage.getBuffer()->getSize() == 8 * sizeof(uint32_t));
+
+        data[7] = 1;
+        REQUIRE(storage.getBuffer().get() != buffers[storage.getRegion()]);
+
+        storage.map(100);
+        REQUIRE(storage.getCapacity() == 100);
+    }
+
+    SECTION("empty frames keep cycling") {
+        const auto region = storage.getRegion();
+        REQUIRE(storage.map(0) != nullptr);
+        REQUIRE(storage.getRegion() == (region + 1) % MAPPED_RING_BUFFER_REGIONS);
+    }
+
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
@@ -0,0 +1,214 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/fx/particle_storage.hpp>
+#include <limitless/fx/modules/distribution.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace Limitless::fx;
+
+namespace {
+    // lifetime range is four frames, so about quarter of particles dies every frame
+    constexpr auto FRAME_DT = 1.0f / 60.0f;
+    constexpr auto MAX_LIFETIME = FRAME_DT * 4.0f;
+
+    struct Simulation {
+        ParticleStorage<SpriteParticle> storage;
+        ParticleRemap remap;
+        std::minstd_rand generator {42};
+        std::uniform_real_distribution<float> lifetime {0.0f, MAX_LIFETIME};
+        size_t max_count;
+
+        explicit Simulation(size_t count) : max_count {count} {
+            storage.reserve(count);
+        }
+
+        size_t frame() {
+            while (storage.count() < max_count) {
+                SpriteParticle particle;
+                particle.lifetime = lifetime(generator);
+                storage.push(particle);
+            }
+
+            for (auto& value : storage.lifetime) {
+                value -= FRAME_DT;
+            }
+
+            storage.kill(remap);
+            return storage.count();
+        }
+    };
+
+    // previous implementation: collect indices and erase them one by one from AoS vector
+    struct LegacySimulation {
+        std::vector<SpriteParticle> particles;
+        std::vector<size_t> indices;
+        std::minstd_rand generator {42};
+        std::uniform_real_distribution<float> lifetime {0.0f, MAX_LIFETIME};
+        size_t max_count;
+
+        explicit LegacySimulation(size_t count) : max_count {count} {
+            particles.reserve(count);
+        }
+
+        size_t frame() {
+            while (particles.size() < max_count) {
+                SpriteParticle particle;
+                particle.lifetime = lifetime(generator);
+                particles.emplace_back(particle);
+            }
+
+            for (auto& particle : particles) {
+                particle.lifetime -= FRAME_DT;
+            }
+
+            indices.clear();
+            for (size_t i = 0; i < particles.size(); ++i) {
+                if (particles[i].lifetime <= 0.0f) {
+                    indices.emplace_back(i);
+                }
+            }
+
+            for (auto it = particles.begin(); it != particles.end();) {
+                if (it->lifetime <= 0.0f) {
+                    it = particles.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            return particles.size();
+        }
+    };
+}
+
+TEST_CASE("ParticleStorage kill removes dead particles") {
+    ParticleStorage<SpriteParticle> storage;
+    // side state that follows particles as module does
+    std::vector<float> side;
+
+    const std::vector<float> lifetimes = {1.0f, -1.0f, 2.0f, 0.0f, 3.0f, -2.0f, 4.0f, -3.0f};
+    for (const auto lifetime : lifetimes) {
+        SpriteParticle particle;
+        particle.lifetime = lifetime;
+        particle.size = lifetime;
+        storage.push(particle);
+        side.emplace_back(lifetime);
+    }
+
+    ParticleRemap remap;
+    REQUIRE(storage.kill(remap));
+    remap.apply(side);
+
+    REQUIRE(storage.count() == 4);
+    REQUIRE(remap.count == 4);
+    REQUIRE(side.size() == 4);
+
+    for (size_t i = 0; i < storage.count(); ++i) {
+        REQUIRE(storage.lifetime[i] > 0.0f);
+        REQUIRE(storage.size[i] == storage.lifetime[i]);
+        REQUIRE(side[i] == storage.lifetime[i]);
+    }
+
+    auto alive = std::vector<float>(storage.lifetime.begin(), storage.lifetime.end());
+    std::sort(alive.begin(), alive.end());
+    REQUIRE(alive == std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f});
+
+    REQUIRE_FALSE(storage.kill(remap));
+}
+
+TEST_CASE("ParticleStorage kill all particles") {
+    ParticleStorage<BeamParticle> storage;
+    for (int i = 0; i < 5; ++i) {
+        BeamParticle particle;
+        particle.lifetime = -1.0f;
+        storage.push(particle);
+    }
+
+    ParticleRemap remap;
+    REQUIRE(storage.kill(remap));
+    REQUIRE(storage.empty());
+    REQUIRE(storage.extra.empty());
+    REQUIRE(remap.moves.empty());
+}
+
+TEST_CASE("ParticleStorage append batch") {
+    ParticleStorage<BeamParticle> storage;
+
+    BeamParticle particle;
+    particle.lifetime = 1.0f;
+    storage.push(particle);
+
+    BeamParticle prototype;
+    prototype.position = glm::vec3{1.0f, 2.0f, 3.0f};
+    prototype.offset = 0.5f;
+    storage.append(prototype, 3);
+
+    REQUIRE(storage.count() == 4);
+    REQUIRE(storage.extra.size() == 4);
+    REQUIRE(storage.position[3] == prototype.position);
+    REQUIRE(storage.extra[3].offset == 0.5f);
+
+    // modules initialize lifetime after append
+    std::fill(storage.lifetime.begin() + 1, storage.lifetime.end(), 2.0f);
+    storage.captureLifespan(1);
+
+    REQUIRE(storage.lifespan[0] == 1.0f);
+    REQUIRE(storage.lifespan[3] == 2.0f);
+    REQUIRE(storage.age(3) == 0.0f);
+}
+
+TEST_CASE("ParticleStorage burst emission benchmark", "[!benchmark]") {
+    constexpr size_t BURST = 5'000;
+
+    Limitless::RangeDistribution<float> lifetime {1.0f, 2.0f};
+    Limitless::RangeDistribution<glm::vec4> color {glm::vec4{0.0f}, glm::vec4{1.0f}};
+    Limitless::RangeDistribution<glm::vec3> velocity {glm::vec3{-1.0f}, glm::vec3{1.0f}};
+
+    // previous emit: virtual get per module per particle, then push
+    BENCHMARK_ADVANCED("per particle 5k")(Catch::Benchmark::Chronometer meter) {
+        ParticleStorage<SpriteParticle> storage;
+        meter.measure([&] {
+            storage.clear();
+            for (size_t i = 0; i < BURST; ++i) {
+                SpriteParticle particle;
+                particle.lifetime = static_cast<Limitless::Distribution<float>&>(lifetime).get();
+                particle.color = static_cast<Limitless::Distribution<glm::vec4>&>(color).get();
+                particle.velocity = static_cast<Limitless::Distribution<glm::vec3>&>(velocity).get();
+                storage.push(particle);
+            }
+            return storage.count();
+        });
+    };
+
+    BENCHMARK_ADVANCED("batch 5k")(Catch::Benchmark::Chronometer meter) {
+        ParticleStorage<SpriteParticle> storage;
+        meter.measure([&] {
+            storage.clear();
+            storage.append(SpriteParticle {}, BURST);
+            lifetime.fill(storage.lifetime.data(), BURST);
+            color.fill(storage.color.data(), BURST);
+            velocity.fill(storage.velocity.data(), BURST);
+            storage.captureLifespan(0);
+            return storage.count();
+        });
+    };
+}
+
+TEST_CASE("ParticleStorage kill benchmark", "[!benchmark]") {
+    BENCHMARK_ADVANCED("legacy erase 10k")(Catch::Benchmark::Chronometer meter) {
+        LegacySimulation simulation {10'000};
+        meter.measure([&] { return simulation.frame(); });
+    };
+
+    BENCHMARK_ADVANCED("swap and pop 10k")(Catch::Benchmark::Chronometer meter) {
+        Simulation simulation {10'000};
+        meter.measure([&] { return simulation.frame(); });
+    };
+
+    BENCHMARK_ADVANCED("swap and pop 100k")(Catch::Benchmark::Chronometer meter) {
+        Simulation simulation {100'000};
+        meter.measure([&] { return simulation.frame(); });
+    };
+}
@@ -0,0 +1,100 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/util/radix_sort.hpp>
+#include <limitless/util/random.hpp>
+
+#include <glm/glm.hpp>
+#include <algorithm>
+
+using namespace Limitless;
+
+namespace {
+    struct Item {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    uint64_t random64(Xoshiro128& generator) {
+        return (static_cast<uint64_t>(generator()) << 32u) | generator();
+    }
+
+    void requireSortedLikeStableSort(std::vector<Item> items) {
+        auto expected = items;
+        std::stable_sort(expected.begin(), expected.end(), [] (const Item& lhs, const Item& rhs) { return lhs.key < rhs.key; });
+
+        std::vector<Item> buffer;
+        radixSort(items, buffer, [] (const Item& item) { return item.key; });
+
+        REQUIRE(items.size() == expected.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            REQUIRE(items[i].key == expected[i].key);
+            REQUIRE(items[i].index == expected[i].index);
+        }
+    }
+}
+
+TEST_CASE("radixSort orders full 64-bit keys") {
+    Xoshiro128 generator {7};
+
+    std::vector<Item> items;
+    for (uint32_t i = 0; i < 10'000; ++i) {
+        items.push_back({random64(generator), i});
+    }
+
+    requireSortedLikeStableSort(items);
+}
+
+TEST_CASE("radixSort is stable for equal keys") {
+    Xoshiro128 generator {7};
+
+    // few distinct keys that differ only in some bytes, so passes are skipped
+    std::vector<Item> items;
+    for (uint32_t i = 0; i < 10'000; ++i) {
+        items.push_back({(static_cast<uint64_t>(generator() % 4) << 40u) | (generator() % 3), i});
+    }
+
+    requireSortedLikeStableSort(items);
+}
+
+TEST_CASE("radixSort handles trivial input") {
+    requireSortedLikeStableSort({});
+    requireSortedLikeStableSort({{42, 0}});
+    requireSortedLikeStableSort({{5, 0}, {5, 1}, {5, 2}});
+}
+
+TEST_CASE("radixSort draw order benchmark", "[!benchmark]") {
+    constexpr uint32_t COUNT = 20'000;
+
+    struct Draw {
+        glm::vec3 position;
+        uint64_t key;
+    };
+
+    Xoshiro128 generator {42};
+    const glm::vec3 camera {0.0f};
+
+    std::vector<Draw> draws;
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        const glm::vec3 position {generator.nextFloat(), generator.nextFloat(), generator.nextFloat()};
+        // shader and material groups above distance bits
+        const auto key = (static_cast<uint64_t>(generator() % 64) << 46u) | (static_cast<uint64_t>(generator() % 512) << 32u) | generator();
+        draws.push_back({position * 1000.0f, key});
+    }
+
+    std::vector<Draw> sorted;
+    std::vector<Draw> buffer;
+
+    BENCHMARK("std::sort by camera distance 20k") {
+        sorted = draws;
+        std::sort(sorted.begin(), sorted.end(), [&] (const Draw& lhs, const Draw& rhs) {
+            return glm::distance(camera, lhs.position) < glm::distance(camera, rhs.position);
+        });
+        return sorted.size();
+    };
+
+    BENCHMARK("radixSort by key 20k") {
+        sorted = draws;
+        radixSort(sorted, buffer, [] (const Draw& draw) { return draw.key; });
+        return sorted.size();
+    };
+}
@@ -0,0 +1,94 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/core/context.hpp>
+#include <limitless/instances/model_instance.hpp>
+#include <limitless/ms/material_builder.hpp>
+#include <limitless/models/cube.hpp>
+#include <limitless/assets.hpp>
+#include <limitless/camera.hpp>
+#include <limitless/scene.hpp>
+
+#include <algorithm>
+
+using namespace Limitless;
+
+namespace {
+    class FakeBackend {
+    public:
+        Context ctx;
+
+        FakeBackend() : ctx{"test", {1, 1}, {{WindowHint::Visible, false}}} {
+
+        }
+    };
+
+    bool isFound(const Scene& scene, const glm::vec3& center, const AbstractInstance& instance) {
+        Instances result;
+        scene.query(BoundingBox{center, glm::vec3{1.0f}}, result);
+        return std::any_of(result.begin(), result.end(), [&] (const auto& found) { return &found.get() == &instance; });
+    }
+}
+
+TEST_CASE("Scene index follows moved instances") {
+    FakeBackend fake;
+
+    Assets assets {ENGINE_ASSETS_DIR};
+    auto material = ms::MaterialBuilder{assets}
+            .setName("material")
+            .add(ms::Property::Color, glm::vec4(1.0f))
+            .setShading(ms::Shading::Unlit)
+            .addModelShader(ModelShader::Model)
+            .build();
+    auto cube = std::make_shared<Cube>();
+
+    Scene scene {fake.ctx};
+    auto& moving = scene.add<ModelInstance>(cube, material, glm::vec3{0.0f});
+    auto& still = scene.add<ModelInstance>(cube, material, glm::vec3{10.0f, 0.0f, 0.0f});
+
+    Camera camera {glm::uvec2{1, 1}};
+    scene.advance(fake.ctx, camera, 0.016f);
+
+    REQUIRE(isFound(scene, glm::vec3{0.0f}, moving));
+    REQUIRE(isFound(scene, glm::vec3{10.0f, 0.0f, 0.0f}, still));
+
+    // changes were taken by index
+    REQUIRE_FALSE(moving.takeBoundsChange());
+    REQUIRE_FALSE(still.takeBoundsChange());
+
+    SECTION("moved instance is refitted") {
+        moving.setPosition(glm::vec3{-20.0f, 0.0f, 0.0f});
+        scene.advance(fake.ctx, camera, 0.016f);
+
+        REQUIRE_FALSE(isFound(scene, glm::vec3{0.0f}, moving));
+        REQUIRE(isFound(scene, glm::vec3{-20.0f, 0.0f, 0.0f}, moving));
+        REQUIRE(isFound(scene, glm::vec3{10.0f, 0.0f, 0.0f}, still));
+
+        // nothing moves
+        scene.advance(fake.ctx, camera, 0.016f);
+        REQUIRE(isFound(scene, glm::vec3{-20.0f, 0.0f, 0.0f}, moving));
+        REQUIRE(isFound(scene, glm::vec3{10.0f, 0.0f, 0.0f}, still));
+    }
+
+    SECTION("attachments follow their parents") {
+        const auto& attachment = moving.attach<ModelInstance>(cube, material, glm::vec3{0.0f, 5.0f, 0.0f});
+        scene.advance(fake.ctx, camera, 0.016f);
+
+        REQUIRE(isFound(scene, glm::vec3{0.0f, 5.0f, 0.0f}, *attachment));
+
+        moving.setPosition(glm::vec3{-20.0f, 0.0f, 0.0f});
+        scene.advance(fake.ctx, camera, 0.016f);
+
+        REQUIRE_FALSE(isFound(scene, glm::vec3{0.0f, 5.0f, 0.0f}, *attachment));
+        REQUIRE(isFound(scene, glm::vec3{-20.0f, 5.0f, 0.0f}, *attachment));
+    }
+
+    SECTION("removed instance leaves index") {
+        scene.remove(moving.getId());
+        scene.advance(fake.ctx, camera, 0.016f);
+
+        Instances result;
+        scene.query(BoundingBox{glm::vec3{0.0f}, glm::vec3{1.0f}}, result);
+        REQUIRE(result.empty());
+        REQUIRE(isFound(scene, glm::vec3{10.0f, 0.0f, 0.0f}, still));
+    }
+}
@@ -0,0 +1,275 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/models/skeletal_model.hpp>
+#include <limitless/util/random.hpp>
+
+#include <functional>
+
+using namespace Limitless;
+
+namespace {
+    // rig where every bone has up to three children, all bones animated
+    std::shared_ptr<SkeletalModel> makeRig(uint32_t bone_count) {
+        Xoshiro128 generator {11};
+        const auto random = [&] { return static_cast<float>(generator()) / static_cast<float>(std::numeric_limits<uint32_t>::max()); };
+
+        std::vector<Bone> bones;
+        std::unordered_map<std::string, uint32_t> bone_map;
+        for (uint32_t i = 0; i < bone_count; ++i) {
+            bones.emplace_back("bone" + std::to_string(i), glm::translate(glm::mat4{1.0f}, glm::vec3{random(), random(), random()}));
+            bones.back().node_transform = glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+            bone_map.emplace(bones.back().name, i);
+        }
+
+        // bone i is child of bone (i - 1) / 3
+        std::function<Tree<uint32_t>(uint32_t)> build = [&] (uint32_t bone) {
+            Tree<uint32_t> tree {bone};
+            for (uint32_t child = bone * 3 + 1; child <= bone * 3 + 3 && child < bone_count; ++child) {
+                tree.add(build(child));
+            }
+            return tree;
+        };
+
+        std::vector<AnimationNode> nodes;
+        for (uint32_t i = 0; i < bone_count; ++i) {
+            std::vector<KeyFrame<glm::vec3>> positions;
+            std::vector<KeyFrame<glm::fquat>> rotations;
+            std::vector<KeyFrame<glm::vec3>> scales;
+            for (uint32_t key = 0; key <= 30; ++key) {
+                positions.emplace_back(glm::vec3{random(), random(), random()}, key);
+                rotations.emplace_back(glm::normalize(glm::fquat{random(), random(), random(), random()}), key);
+                scales.emplace_back(glm::vec3{1.0f + random() * 0.1f}, key);
+            }
+            nodes.emplace_back(positions, rotations, scales, i);
+        }
+
+        std::vector<Animation> animations;
+        animations.emplace_back("walk", 30.0, 30.0, std::move(nodes));
+
+        return std::make_shared<SkeletalModel>(std::vector<std::shared_ptr<AbstractMesh>>{}, std::vector<std::shared_ptr<ms::Material>>{},
+                                               std::move(bones), std::move(bone_map), build(0), std::move(animations), glm::mat4{1.0f}, "rig");
+    }
+
+    // per bone channel scan over recursive tree, as skeletal instances evaluated poses before flattening
+    void sampleRecursive(const SkeletalModel& model, const Animation& animation, double time, std::vector<glm::mat4>& bone_transform) {
+        const auto& bones = model.getBones();
+
+        std::function<void(const Tree<uint32_t>&, const glm::mat4&)> traversal = [&] (const Tree<uint32_t>& node, const glm::mat4& parent) {
+            const AnimationNode* channel = nullptr;
+            for (const auto& animation_node : animation.nodes) {
+                if (animation_node.bone == *node) {
+                    channel = &animation_node;
+                }
+            }
+
+            auto local = bones[*node].node_transform;
+            if (channel) {
+                local = glm::translate(glm::mat4{1.0f}, channel->positionLerp(time))
+                      * glm::mat4_cast(channel->rotationLerp(time))
+                      * glm::scale(glm::mat4{1.0f}, channel->scalingLerp(time));
+            }
+
+            const auto transform = parent * local;
+            bone_transform[*node] = model.getGlobalInverseMatrix() * transform * bones[*node].offset_matrix;
+
+            for (const auto& child : node) {
+                traversal(child, transform);
+            }
+        };
+
+        traversal(model.getSkeletonTree(), glm::mat4{1.0f});
+    }
+}
+
+TEST_CASE("SkeletalModel flattens skeleton with parents before children") {
+    const auto rig = makeRig(100);
+    const auto& skeleton = rig->getFlatSkeleton();
+
+    REQUIRE(skeleton.size() == 100);
+    REQUIRE(skeleton[0].parent == SkeletonNode::NO_PARENT);
+    for (uint32_t i = 1; i < skeleton.size(); ++i) {
+        REQUIRE(skeleton[i].parent < i);
+        REQUIRE(skeleton[skeleton[i].parent].bone == (skeleton[i].bone - 1) / 3);
+    }
+}
+
+TEST_CASE("SkeletalModel samples the same pose as recursive evaluation") {
+    const auto rig = makeRig(150);
+    const auto& animation = rig->getAnimations()[0];
+
+    REQUIRE(animation.findChannel(42) == &animation.nodes[42]);
+    REQUIRE(animation.findChannel(150) == nullptr);
+
+    std::vector<glm::mat4> expected(150);
+    std::vector<glm::mat4> actual(150);
+
+    for (const double time : {0.0, 7.25, 29.9}) {
+        sampleRecursive(*rig, animation, time, expected);
+        rig->samplePose(animation, time, actual);
+
+        for (size_t bone = 0; bone < expected.size(); ++bone) {
+            for (int column = 0; column < 4; ++column) {
+                for (int row = 0; row < 4; ++row) {
+                    REQUIRE(actual[bone][column][row] == Catch::Approx(expected[bone][column][row]).margin(1e-3));
+                }
+            }
+        }
+    }
+}
+
+namespace {
+    void requireSamePose(const std::vector<glm::mat4>& actual, const std::vector<glm::mat4>& expected) {
+        for (size_t bone = 0; bone < expected.size(); ++bone) {
+            for (int column = 0; column < 4; ++column) {
+                for (int row = 0; row < 4; ++row) {
+                    REQUIRE(actual[bone][column][row] == Catch::Approx(expected[bone][column][row]).margin(1e-3));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("SkeletalModel blends local poses") {
+    const auto rig = makeRig(40);
+    const auto& animation = rig->getAnimations()[0];
+    const auto size = rig->getFlatSkeleton().size();
+
+    PoseArena arena;
+    arena.reset(size, 3);
+    const auto pose = arena.allocate();
+    const auto source = arena.allocate();
+    const auto reference = arena.allocate();
+    REQUIRE_THROWS_AS(arena.allocate(), std::out_of_range);
+
+    std::vector<glm::mat4> expected(40);
+    std::vector<glm::mat4> actual(40);
+
+    SECTION("local pose gives the same matrices as direct sampling") {
+        rig->samplePose(animation, 7.25, expected);
+        rig->sampleLocalPose(animation, 7.25, pose);
+        rig->applyPose(pose, actual);
+        requireSamePose(actual, expected);
+    }
+
+    SECTION("full weight replaces pose, zero weight keeps it") {
+        rig->samplePose(animation, 20.0, expected);
+
+        rig->sampleLocalPose(animation, 3.0, pose);
+        rig->sampleLocalPose(animation, 20.0, source);
+        blendPoses(pose, source, 1.0f, nullptr, size);
+        rig->applyPose(pose, actual);
+        requireSamePose(actual, expected);
+
+        rig->sampleLocalPose(animation, 3.0, source);
+        blendPoses(pose, source, 0.0f, nullptr, size);
+        rig->applyPose(pose, actual);
+        requireSamePose(actual, expected);
+    }
+
+    SECTION("mask limits blending to subtree of bone") {
+        // bone 1 has children 4, 5, 6, they have 13..21
+        const auto mask = rig->makeBoneMask("bone1");
+        REQUIRE_THROWS(rig->makeBoneMask("tail"));
+
+        rig->sampleLocalPose(animation, 3.0, pose);
+        rig->sampleLocalPose(animation, 20.0, source);
+        blendPoses(pose, source, 1.0f, mask.data(), size);
+
+        for (size_t i = 0; i < size; ++i) {
+            const auto bone = rig->getFlatSkeleton()[i].bone;
+            const bool in_subtree = bone == 1 || (bone >= 4 && bone <= 6) || (bone >= 13 && bone <= 21);
+            REQUIRE(mask[i] == (in_subtree ? 1.0f : 0.0f));
+
+            const auto expected_position = animation.findChannel(bone)->positionLerp(in_subtree ? 20.0 : 3.0);
+            REQUIRE(pose.positions[i].x == Catch::Approx(expected_position.x));
+        }
+    }
+
+    SECTION("additive layer at its reference frame keeps pose") {
+        rig->samplePose(animation, 11.0, expected);
+
+        rig->sampleLocalPose(animation, 11.0, pose);
+        rig->sampleLocalPose(animation, 0.0, source);
+        rig->sampleLocalPose(animation, 0.0, reference);
+        addPoses(pose, source, reference, 1.0f, nullptr, size);
+        rig->applyPose(pose, actual);
+        requireSamePose(actual, expected);
+    }
+}
+
+TEST_CASE("KeyTrack cursor finds the same keys as search from the start") {
+    std::vector<KeyFrame<glm::vec3>> frames;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        // curved, so no key is dropped on compression
+        frames.emplace_back(glm::vec3{std::sin(static_cast<float>(i) * 0.01f)}, i * 0.5);
+    }
+    const KeyTrack<glm::vec3> track {frames};
+    REQUIRE(track.times.size() == frames.size());
+
+    uint32_t cursor {};
+    const auto check = [&] (float time) {
+        uint32_t fresh {};
+        const auto index = track.find(time, cursor);
+        REQUIRE(index == track.find(time, fresh));
+        REQUIRE(cursor == index);
+        if (time >= track.times.front() && time < track.times.back()) {
+            REQUIRE(track.times[index] <= time);
+            REQUIRE(time < track.times[index + 1]);
+        }
+    };
+
+    // forward playback, then loop to the start, then seeks both ways
+    for (float time = 0.0f; time < 499.5f; time += 0.3f) {
+        check(time);
+    }
+    check(0.1f);
+    check(321.7f);
+    check(12.0f);
+    check(499.5f);
+    check(1000.0f);
+    check(-1.0f);
+}
+
+TEST_CASE("skeleton sampling benchmark", "[!benchmark]") {
+    for (const uint32_t bone_count : {100u, 300u}) {
+        const auto rig = makeRig(bone_count);
+        const auto& animation = rig->getAnimations()[0];
+        std::vector<glm::mat4> bone_transform(bone_count);
+
+        BENCHMARK("recursive " + std::to_string(bone_count) + " bones") {
+            sampleRecursive(*rig, animation, 12.5, bone_transform);
+            return bone_transform[bone_count - 1][3][0];
+        };
+
+        BENCHMARK("flattened " + std::to_string(bone_count) + " bones") {
+            rig->samplePose(animation, 12.5, bone_transform);
+            return bone_transform[bone_count - 1][3][0];
+        };
+    }
+}
+
+TEST_CASE("keyframe cursor benchmark", "[!benchmark]") {
+    std::vector<KeyFrame<glm::vec3>> frames;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        // curved, so no key is dropped on compression
+        frames.emplace_back(glm::vec3{std::sin(static_cast<float>(i) * 0.01f)}, i);
+    }
+    const AnimationNode node {frames, {}, {}, 0};
+
+    BENCHMARK("mocap track, 1000 samples without cursor") {
+        glm::vec3 sum {};
+        for (uint32_t frame = 0; frame < 1000; ++frame) {
+            sum += node.positionLerp(frame * 0.5);
+        }
+        return sum;
+    };
+
+    BENCHMARK("mocap track, 1000 samples with cursor") {
+        glm::vec3 sum {};
+        uint32_t cursor {};
+        for (uint32_t frame = 0; frame < 1000; ++frame) {
+            sum += node.positionLerp(frame * 0.5f, cursor);
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,386 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/pipeline/static_geometry.hpp>
+#include <limitless/core/indexed_stream.hpp>
+#include <limitless/core/buffer_builder.hpp>
+#include <limitless/core/context.hpp>
+#include <limitless/models/mesh.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace Limitless;
+
+namespace {
+    constexpr GLsizei TARGET_SIZE = 32;
+
+    class FakeBackend {
+    private:
+        Context ctx;
+    public:
+        FakeBackend() : ctx{"test", {1, 1}, {{WindowHint::Visible, false}}} {
+
+        }
+    };
+
+    std::shared_ptr<AbstractMesh> makeMesh(std::vector<glm::vec3> positions, std::vector<uint32_t> indices, const glm::vec3& color, std::string name) {
+        std::vector<VertexNormalTangent> vertices;
+        for (const auto& position : positions) {
+            // normal is used as color by test shader
+            vertices.push_back({position, color, glm::vec3{0.0f}, glm::vec2{0.0f}});
+        }
+
+        auto stream = std::make_unique<IndexedVertexStream<VertexNormalTangent>>(std::move(vertices), std::move(indices), VertexStreamUsage::Static, VertexStreamDraw::Triangles);
+        return std::make_shared<Mesh>(std::move(stream), std::move(name));
+    }
+
+    std::shared_ptr<AbstractMesh> makeTriangle(const glm::vec3& color) {
+        return makeMesh({{-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}, {0, 1, 2}, color, "triangle");
+    }
+
+    std::shared_ptr<AbstractMesh> makeQuad(const glm::vec3& color) {
+        return makeMesh({{-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}}, {0, 1, 2, 2, 3, 0}, color, "quad");
+    }
+
+    bool isShared(const std::shared_ptr<AbstractMesh>& mesh) {
+        return dynamic_cast<const VertexStream<VertexNormalTangent>&>(dynamic_cast<const Mesh&>(*mesh).getVertexStream()).isShared();
+    }
+
+    glm::mat4 makeTransform(const glm::vec2& position, float scale) {
+        glm::mat4 transform {1.0f};
+        transform[0][0] = scale;
+        transform[1][1] = scale;
+        transform[3] = glm::vec4{position, 0.0f, 1.0f};
+        return transform;
+    }
+
+    GLuint compile(GLenum type, const std::string& source) {
+        const auto id = glCreateShader(type);
+        const auto* data = source.c_str();
+        glShaderSource(id, 1, &data, nullptr);
+        glCompileShader(id);
+
+        GLint success;
+        glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+        REQUIRE(success == GL_TRUE);
+
+        return id;
+    }
+
+    // program that reads transforms as instanced model shaders do
+    GLuint makeProgram(bool draw_parameters) {
+        std::ifstream file {std::string{ENGINE_SHADERS_DIR} + "pipeline/instance/instanced.glsl"};
+        REQUIRE(file.is_open());
+
+        std::stringstream instanced;
+        instanced << file.rdbuf();
+
+        std::string vertex = "#version 330 core\n#extension GL_ARB_shader_storage_buffer_object : require\n";
+        if (draw_parameters) {
+            vertex += "#extension GL_ARB_shader_draw_parameters : require\n#define SHADER_DRAW_PARAMETERS\n";
+        }
+        vertex += instanced.str();
+        vertex += R"(
+            layout (location = 0) in vec3 vertex_position;
+            layout (location = 1) in vec3 vertex_normal;
+            out vec3 color;
+            void main() {
+                color = vertex_normal;
+                gl_Position = getModelMatrix() * vec4(vertex_position, 1.0);
+            }
+        )";
+
+        const std::string fragment = R"(#version 330 core
+            in vec3 color;
+            out vec4 result;
+            void main() {
+                result = vec4(color, 1.0);
+            }
+        )";
+
+        const auto vertex_id = compile(GL_VERTEX_SHADER, vertex);
+        const auto fragment_id = compile(GL_FRAGMENT_SHADER, fragment);
+
+        const auto program = glCreateProgram();
+        glAttachShader(program, vertex_id);
+        glAttachShader(program, fragment_id);
+        glLinkProgram(program);
+        glDeleteShader(vertex_id);
+        glDeleteShader(fragment_id);
+
+        GLint success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        REQUIRE(success == GL_TRUE);
+
+        glShaderStorageBlockBinding(program, glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, "model_buffer"), 0);
+
+        return program;
+    }
+
+    class Target {
+    private:
+        GLuint framebuffer {};
+        GLuint renderbuffer {};
+    public:
+        Target() {
+            glGenRenderbuffers(1, &renderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, TARGET_SIZE, TARGET_SIZE);
+
+            glGenFramebuffers(1, &framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+            REQUIRE(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+            glViewport(0, 0, TARGET_SIZE, TARGET_SIZE);
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_CULL_FACE);
+        }
+
+        ~Target() {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &framebuffer);
+            glDeleteRenderbuffers(1, &renderbuffer);
+        }
+
+        void clear() {
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+
+        std::vector<uint8_t> read() {
+            std::vector<uint8_t> pixels(TARGET_SIZE * TARGET_SIZE * 4);
+            glReadPixels(0, 0, TARGET_SIZE, TARGET_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            return pixels;
+        }
+    };
+
+    size_t countColor(const std::vector<uint8_t>& pixels, uint8_t r, uint8_t g, uint8_t b) {
+        size_t count = 0;
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            count += pixels[i] == r && pixels[i + 1] == g && pixels[i + 2] == b;
+        }
+        return count;
+    }
+}
+
+TEST_CASE("StaticGeometry uploads registered meshes on update") {
+    FakeBackend fake;
+
+    StaticGeometry geometry;
+    auto triangle = makeTriangle(glm::vec3{1.0f, 0.0f, 0.0f});
+    auto quad = makeQuad(glm::vec3{0.0f, 1.0f, 0.0f});
+
+    geometry.add(triangle);
+    geometry.add(quad);
+    geometry.add(triangle);
+
+    // nothing is drawn from shared buffers before upload
+    REQUIRE(geometry.find(triangle.get()) == nullptr);
+
+    geometry.update();
+
+    REQUIRE(geometry.getVertexCount() == 7);
+    REQUIRE(geometry.getIndexCount() == 9);
+    REQUIRE(geometry.find(triangle.get()) != nullptr);
+    REQUIRE(geometry.find(triangle.get())->index_count == 3);
+    REQUIRE(geometry.find(quad.get())->index_count == 6);
+
+    // meshes release their own buffers
+    REQUIRE(isShared(triangle));
+    REQUIRE(isShared(quad));
+
+    SECTION("destroyed meshes are dropped without moving alive ones") {
+        const auto range = *geometry.find(quad.get());
+        const auto* destroyed = triangle.get();
+        triangle.reset();
+
+        REQUIRE(geometry.find(destroyed) == nullptr);
+
+        geometry.update();
+
+        REQUIRE(geometry.getVertexCount() == 4);
+        REQUIRE(geometry.getIndexCount() == 6);
+
+        const auto* moved = geometry.find(quad.get());
+        REQUIRE(moved != nullptr);
+        REQUIRE(moved->first_index == range.first_index);
+        REQUIRE(moved->base_vertex == range.base_vertex);
+    }
+
+    SECTION("space of destroyed meshes is reclaimed once it outweighs alive ones") {
+        quad.reset();
+        geometry.update();
+
+        REQUIRE(geometry.getVertexCount() == 3);
+        REQUIRE(geometry.getVertexCapacity() == 3);
+        REQUIRE(geometry.getIndexCapacity() == 3);
+
+        const auto* range = geometry.find(triangle.get());
+        REQUIRE(range != nullptr);
+        REQUIRE(range->first_index == 0);
+        REQUIRE(range->base_vertex == 0);
+        REQUIRE(isShared(triangle));
+    }
+
+    SECTION("new meshes are appended without moving uploaded ones") {
+        const auto triangle_range = *geometry.find(triangle.get());
+        const auto quad_range = *geometry.find(quad.get());
+
+        auto second = makeQuad(glm::vec3{0.0f, 0.0f, 1.0f});
+        geometry.add(second);
+        geometry.update();
+
+        REQUIRE(geometry.getVertexCount() == 11);
+        REQUIRE(geometry.getIndexCount() == 15);
+        REQUIRE(geometry.getVertexCapacity() >= 11);
+
+        REQUIRE(geometry.find(triangle.get())->first_index == triangle_range.first_index);
+        REQUIRE(geometry.find(quad.get())->first_index == quad_range.first_index);
+
+        const auto* range = geometry.find(second.get());
+        REQUIRE(range != nullptr);
+        REQUIRE(range->first_index == 9);
+        REQUIRE(range->base_vertex == 7);
+    }
+
+    SECTION("clear gives meshes their own buffers back") {
+        geometry.clear();
+
+        REQUIRE_FALSE(isShared(triangle));
+        REQUIRE_FALSE(isShared(quad));
+        REQUIRE(geometry.find(triangle.get()) == nullptr);
+    }
+
+    SECTION("not static meshes are ignored") {
+        std::vector<VertexNormalTangent> vertices(3);
+        auto stream = std::make_unique<IndexedVertexStream<VertexNormalTangent>>(std::move(vertices), std::vector<uint32_t>{0, 1, 2}, VertexStreamUsage::Dynamic, VertexStreamDraw::Triangles);
+        std::shared_ptr<AbstractMesh> dynamic = std::make_shared<Mesh>(std::move(stream), "dynamic");
+
+        geometry.add(dynamic);
+        geometry.update();
+
+        REQUIRE(geometry.find(dynamic.get()) == nullptr);
+        REQUIRE(geometry.getVertexCount() == 7);
+    }
+}
+
+TEST_CASE("StaticGeometry draws commands as separate meshes do") {
+    FakeBackend fake;
+
+    auto triangle = makeTriangle(glm::vec3{1.0f, 0.0f, 0.0f});
+    auto quad = makeQuad(glm::vec3{0.0f, 1.0f, 0.0f});
+
+    // two copies of triangle in top corners and quad in bottom
+    const std::vector<std::pair<std::shared_ptr<AbstractMesh>, glm::mat4>> draws = {
+        {triangle, makeTransform({-0.5f, 0.5f}, 0.4f)},
+        {triangle, makeTransform({0.5f, 0.5f}, 0.4f)},
+        {quad, makeTransform({0.0f, -0.5f}, 0.4f)},
+    };
+
+    std::vector<glm::mat4> transforms;
+    for (const auto& [_, transform] : draws) {
+        transforms.push_back(transform);
+    }
+
+    BufferBuilder builder;
+    auto transform_buffer = builder.setTarget(Buffer::Type::ShaderStorage)
+            .setUsage(Buffer::Usage::DynamicDraw)
+            .setAccess(Buffer::MutableAccess::WriteOrphaning)
+            .setData(transforms.data())
+            .setDataSize(transforms.size() * sizeof(glm::mat4))
+            .build();
+
+    Target target;
+    const auto program = makeProgram(false);
+    const auto offset_location = glGetUniformLocation(program, "_instance_offset");
+
+    const auto drawMeshes = [&] () {
+        target.clear();
+        glUseProgram(program);
+        transform_buffer->bindBase(0);
+        for (uint32_t i = 0; i < draws.size(); ++i) {
+            glUniform1ui(offset_location, i);
+            draws[i].first->draw();
+        }
+        return target.read();
+    };
+
+    // every mesh is drawn with its own vertex array
+    const auto expected = drawMeshes();
+
+    REQUIRE(countColor(expected, 255, 0, 0) > 0);
+    REQUIRE(countColor(expected, 0, 255, 0) > 0);
+
+    StaticGeometry geometry;
+    geometry.add(triangle);
+    geometry.add(quad);
+    geometry.update();
+
+    IndirectCommandBuilder commands;
+    for (uint32_t i = 0; i < draws.size(); ++i) {
+        commands.add(*geometry.find(draws[i].first.get()), i);
+    }
+
+    // copies of triangle become one command
+    REQUIRE(commands.size() == 2);
+
+    SECTION("meshes draw their ranges of shared buffers") {
+        REQUIRE(drawMeshes() == expected);
+
+        // buffers are reallocated on growth
+        auto other = makeQuad(glm::vec3{0.0f, 0.0f, 1.0f});
+        geometry.add(other);
+        geometry.update();
+        REQUIRE(drawMeshes() == expected);
+
+        geometry.clear();
+        REQUIRE(drawMeshes() == expected);
+    }
+
+    SECTION("one draw per command") {
+        target.clear();
+        glUseProgram(program);
+        transform_buffer->bindBase(0);
+        for (const auto& command : commands.getCommands()) {
+            glUniform1ui(offset_location, command.base_instance);
+            geometry.draw(command);
+        }
+
+        REQUIRE(glGetError() == GL_NO_ERROR);
+        REQUIRE(target.read() == expected);
+    }
+
+    SECTION("multi draw indirect") {
+        if (!StaticGeometry::isMultiDrawSupported()) {
+            WARN("multi draw indirect or shader draw parameters are not supported");
+            glDeleteProgram(program);
+            return;
+        }
+
+        const auto draw_parameters_program = makeProgram(true);
+
+        BufferBuilder command_builder;
+        auto command_buffer = command_builder.setTarget(Buffer::Type::IndirectDraw)
+                .setUsage(Buffer::Usage::DynamicDraw)
+                .setAccess(Buffer::MutableAccess::WriteOrphaning)
+                .setData(commands.getCommands().data())
+                .setDataSize(commands.size() * sizeof(DrawElementsIndirectCommand))
+                .build();
+
+        target.clear();
+        glUseProgram(draw_parameters_program);
+        glUniform1ui(glGetUniformLocation(draw_parameters_program, "_instance_offset"), 0);
+        transform_buffer->bindBase(0);
+        command_buffer->bind();
+        geometry.drawIndirect(0, static_cast<uint32_t>(commands.size()));
+
+        REQUIRE(glGetError() == GL_NO_ERROR);
+        REQUIRE(target.read() == expected);
+
+        glDeleteProgram(draw_parameters_program);
+    }
+
+    glUseProgram(0);
+    glDeleteProgram(program);
+}
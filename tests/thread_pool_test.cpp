@@ -0,0 +1,73 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/util/thread_pool.hpp>
+
+#include <chrono>
+#include <stdexcept>
+
+using namespace Limitless;
+
+namespace {
+    void visitAll(ThreadPool& pool, size_t count, size_t chunk_size) {
+        std::vector<std::atomic<uint32_t>> visits(count);
+
+        pool.forEach(count, chunk_size, [&] (size_t i) {
+            ++visits[i];
+        });
+
+        for (size_t i = 0; i < count; ++i) {
+            REQUIRE(visits[i] == 1);
+        }
+    }
+}
+
+TEST_CASE("ThreadPool::forEach visits every index exactly once") {
+    ThreadPool pool {4};
+
+    const auto count = GENERATE(size_t{0}, size_t{1}, size_t{7}, size_t{1000}, size_t{1023});
+    const auto chunk_size = GENERATE(size_t{1}, size_t{3}, size_t{64}, size_t{2048});
+
+    visitAll(pool, count, chunk_size);
+}
+
+TEST_CASE("ThreadPool::forEach works without worker threads") {
+    ThreadPool pool {0};
+    REQUIRE(pool.getSize() == 0);
+
+    const auto caller = std::this_thread::get_id();
+    bool on_caller = true;
+    pool.forEach(100, 8, [&] (size_t) {
+        on_caller = on_caller && std::this_thread::get_id() == caller;
+    });
+
+    REQUIRE(on_caller);
+    visitAll(pool, 100, 8);
+}
+
+TEST_CASE("ThreadPool::forEach rethrows exception of worker") {
+    ThreadPool pool {2};
+
+    const auto caller = std::this_thread::get_id();
+    std::atomic<bool> thrown {false};
+
+    const auto run = [&] {
+        pool.forEach(64, 1, [&] (size_t) {
+            if (std::this_thread::get_id() != caller) {
+                thrown = true;
+                throw std::runtime_error("worker failed");
+            }
+
+            // calling thread holds on until some worker takes a chunk
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!thrown && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        });
+    };
+
+    REQUIRE_THROWS_AS(run(), std::runtime_error);
+    REQUIRE(thrown);
+
+    // pool is still usable after failure
+    visitAll(pool, 100, 8);
+}
@@ -0,0 +1,66 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/instances/transform_hierarchy.hpp>
+#include <limitless/instances/abstract_instance.hpp>
+#include <limitless/pipeline/shader_pass_types.hpp>
+
+using namespace Limitless;
+
+namespace {
+    class TestInstance : public AbstractInstance {
+    protected:
+        void updateBoundingBox() noexcept override {}
+    public:
+        TestInstance() noexcept : AbstractInstance(ModelShader::Model, glm::vec3{0.0f}) {}
+
+        TestInstance* clone() noexcept override { return new TestInstance(*this); }
+
+        void draw(Context&, const Assets&, ShaderPass, ms::Blending, const UniformSetter&) override {}
+    };
+}
+
+TEST_CASE("TransformHierarchy is outdated only by attachments of its own nodes") {
+    TestInstance first;
+    TestInstance second;
+
+    TransformHierarchy first_hierarchy;
+    TransformHierarchy second_hierarchy;
+    first_hierarchy.build({&first});
+    second_hierarchy.build({&second});
+
+    REQUIRE_FALSE(first_hierarchy.isOutdated());
+    REQUIRE_FALSE(second_hierarchy.isOutdated());
+
+    SECTION("attach to root") {
+        first.attach<TestInstance>();
+
+        REQUIRE(first_hierarchy.isOutdated());
+        REQUIRE_FALSE(second_hierarchy.isOutdated());
+
+        first_hierarchy.build({&first});
+        REQUIRE_FALSE(first_hierarchy.isOutdated());
+        REQUIRE(first_hierarchy.size() == 2);
+        REQUIRE(first_hierarchy.getDepth() == 2);
+    }
+
+    SECTION("attach and detach below root") {
+        const auto& child = first.attach<TestInstance>();
+        first_hierarchy.build({&first});
+
+        child->attach<TestInstance>();
+        REQUIRE(first_hierarchy.isOutdated());
+        first_hierarchy.build({&first});
+        REQUIRE(first_hierarchy.size() == 3);
+
+        first.detach(child->getId());
+        REQUIRE(first_hierarchy.isOutdated());
+        REQUIRE_FALSE(second_hierarchy.isOutdated());
+    }
+
+    SECTION("copy of built instance does not change hierarchy") {
+        TestInstance copy {first};
+        copy.attach<TestInstance>();
+
+        REQUIRE_FALSE(first_hierarchy.isOutdated());
+    }
+}
@@ -0,0 +1,126 @@
+#include "catch_amalgamated.hpp"
+
+#include <limitless/util/triangle_bvh.hpp>
+#include <limitless/util/bounding_box.hpp>
+#include <limitless/util/random.hpp>
+
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+
+using namespace Limitless;
+
+namespace {
+    // uv sphere of radius 1 with about 2 * segments^2 triangles
+    void makeSphere(uint32_t segments, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) {
+        for (uint32_t y = 0; y <= segments; ++y) {
+            for (uint32_t x = 0; x <= segments; ++x) {
+                const auto theta = static_cast<float>(y) / static_cast<float>(segments) * glm::pi<float>();
+                const auto phi = static_cast<float>(x) / static_cast<float>(segments) * 2.0f * glm::pi<float>();
+                positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            }
+        }
+
+        for (uint32_t y = 0; y < segments; ++y) {
+            for (uint32_t x = 0; x < segments; ++x) {
+                const auto i = y * (segments + 1) + x;
+                indices.insert(indices.end(), {i, i + segments + 1, i + 1, i + 1, i + segments + 1, i + segments + 2});
+            }
+        }
+    }
+
+    std::optional<TriangleHit> bruteForce(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+                                          const glm::vec3& origin, const glm::vec3& direction, float max_distance) {
+        std::optional<TriangleHit> hit;
+        for (uint32_t i = 0; i < indices.size() / 3; ++i) {
+            if (auto result = intersectTriangle(origin, direction, positions[indices[i * 3]], positions[indices[i * 3 + 1]], positions[indices[i * 3 + 2]], max_distance); result) {
+                result->triangle = i;
+                max_distance = result->distance;
+                hit = result;
+            }
+        }
+        return hit;
+    }
+
+    glm::vec3 randomDirection(Xoshiro128& generator) {
+        return glm::normalize(glm::vec3{generator.nextFloat(), generator.nextFloat(), generator.nextFloat()} * 2.0f - 1.0f);
+    }
+}
+
+TEST_CASE("Triangle intersection reports distance and barycentrics") {
+    const auto hit = intersectTriangle({0.25f, 0.25f, 5.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 100.0f);
+
+    REQUIRE(hit);
+    REQUIRE(hit->distance == Catch::Approx(5.0f));
+    REQUIRE(hit->barycentric.x == Catch::Approx(0.25f));
+    REQUIRE(hit->barycentric.y == Catch::Approx(0.25f));
+
+    REQUIRE_FALSE(intersectTriangle({0.25f, 0.25f, 5.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 4.0f));
+    REQUIRE_FALSE(intersectTriangle({0.75f, 0.75f, 5.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 100.0f));
+}
+
+TEST_CASE("Ray box slab test reports entry distance") {
+    const glm::vec3 min {-1.0f};
+    const glm::vec3 max {1.0f};
+    const auto infinity = std::numeric_limits<float>::infinity();
+
+    const auto inverse = [] (const glm::vec3& direction) { return 1.0f / direction; };
+
+    REQUIRE(intersectRayBox(min, max, {-3.0f, 0.0f, 0.0f}, inverse({1.0f, 0.0f, 0.0f}), 10.0f) == Catch::Approx(2.0f));
+    // origin inside box
+    REQUIRE(intersectRayBox(min, max, {0.0f, 0.0f, 0.0f}, inverse({0.0f, 1.0f, 0.0f}), 10.0f) == 0.0f);
+    // pointing away
+    REQUIRE(intersectRayBox(min, max, {-3.0f, 0.0f, 0.0f}, inverse({-1.0f, 0.0f, 0.0f}), 10.0f) == infinity);
+    // beyond max distance
+    REQUIRE(intersectRayBox(min, max, {-3.0f, 0.0f, 0.0f}, inverse({1.0f, 0.0f, 0.0f}), 1.5f) == infinity);
+    // passes by
+    REQUIRE(intersectRayBox(min, max, {-3.0f, 2.0f, 0.0f}, inverse({1.0f, 0.0f, 0.0f}), 10.0f) == infinity);
+}
+
+TEST_CASE("TriangleBVH finds the same closest hit as brute force") {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    makeSphere(32, positions, indices);
+
+    const TriangleBVH bvh {positions, indices};
+    REQUIRE(bvh.getTriangleCount() == indices.size() / 3);
+
+    Xoshiro128 generator {42};
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < 500; ++i) {
+        // rays from outside towards points around the sphere, some of them miss
+        const auto origin = randomDirection(generator) * 3.0f;
+        const auto direction = glm::normalize(randomDirection(generator) * 0.8f - origin);
+
+        const auto expected = bruteForce(positions, indices, origin, direction, 100.0f);
+        const auto result = bvh.raycast(origin, direction, 100.0f);
+
+        REQUIRE(result.has_value() == expected.has_value());
+        if (result) {
+            ++hits;
+            REQUIRE(result->distance == Catch::Approx(expected->distance));
+            REQUIRE(glm::length(origin + direction * result->distance) == Catch::Approx(1.0f).margin(0.01));
+        }
+    }
+
+    REQUIRE(hits > 100);
+}
+
+TEST_CASE("TriangleBVH ray cast benchmark", "[!benchmark]") {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    // about 100k triangles
+    makeSphere(224, positions, indices);
+
+    const TriangleBVH bvh {positions, indices};
+
+    Xoshiro128 generator {42};
+    const auto origin = glm::vec3{0.0f, 0.0f, 3.0f};
+
+    BENCHMARK("brute force 100k triangles") {
+        return bruteForce(positions, indices, origin, glm::normalize(randomDirection(generator) * 0.5f - origin), 100.0f).has_value();
+    };
+
+    BENCHMARK("bvh 100k triangles") {
+        return bvh.raycast(origin, glm::normalize(randomDirection(generator) * 0.5f - origin), 100.0f).has_value();
+    };
+}